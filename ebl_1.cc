@@ -26,6 +26,10 @@
 
 #include "B1ParallelWorldConstruction.hh"
 #include "G4ParallelWorldPhysics.hh"
+#include "B1PlaneCrossingScorer.hh"
+#include "B1EventSeeds.hh"
+#include <sstream>
+#include <vector>
 
 bool fexists(const std::string& filename) {
    std::ifstream ifile(filename.c_str());
@@ -34,6 +38,28 @@ bool fexists(const std::string& filename) {
 }
 //______________________________________________________________________________
 
+void execute_without_beamOn(G4UImanager * UImanager, const std::string& filename) {
+   // The commands of a macro one by one, leaving out the runs and the
+   // thread count (nested macros are executed as they are)
+   std::ifstream input(filename.c_str());
+   if( !input ) {
+      std::cout << "Error : cannot open " << filename << std::endl;
+      return;
+   }
+   std::string line;
+   while( std::getline(input, line) ) {
+      std::size_t first = line.find_first_not_of(" \t\r");
+      if( first == std::string::npos || line[first] == '#' ) continue;
+      line = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+      if( line.compare(0, 11, "/run/beamOn") == 0 || line.compare(0, 20, "/run/numberOfThreads") == 0 ) {
+         std::cout << " replay : skipping " << line << std::endl;
+         continue;
+      }
+      UImanager->ApplyCommand(line);
+   }
+}
+//______________________________________________________________________________
+
 void print_help() {
 
    std::cout << "usage: ebl_1 [options] [macro file]    \n";
@@ -45,6 +71,18 @@ void print_help() {
    std::cout << "                        0 to turn off visualization\n";
    std::cout << "    --interactive, -i   run in interactive mode (default)\n";
    std::cout << "    --batch, -b         run in batch mode\n"; 
+   std::cout << "    --sweep=file, -s    run the parameter sweep in the scan file\n";
+   std::cout << "                        (see /B1/run/sweep) after the macro\n";
+   std::cout << "    --scoring=mode, -S  how the scoring planes are scored:\n";
+   std::cout << "                        parallel  parallel world and FakeSD (default)\n";
+   std::cout << "                        analytic  stepping action only, no parallel world\n";
+   std::cout << "                        both      both, crossings compared at end of run\n";
+   std::cout << "    --seed=#, -x        job seed of the per-event seeds (default: the time)\n";
+   std::cout << "    --replay=run:event[,event...], -p\n";
+   std::cout << "                        after the macro (without its beamOn), re-simulate\n";
+   std::cout << "                        these events of G4 run id run (same --seed and --run\n";
+   std::cout << "                        as the original job) on one thread with\n";
+   std::cout << "                        /tracking/verbose 1\n";
 }
 
 //______________________________________________________________________________
@@ -56,6 +94,10 @@ int main(int argc,char** argv)
    std::string  output_file_name  = "";
    std::string  output_tree_name  = "";
    std::string  theRest           = "";
+   std::string  sweep_file_name   = "";
+   std::string  scoring_mode      = "parallel";
+   std::string  replay_spec       = "";
+   long long    seed              = time(NULL);
    bool         run_manager_init  = false;
    bool         use_gui           = true;
    bool         use_vis           = true;
@@ -78,10 +120,14 @@ int main(int argc,char** argv)
       {"tree",        required_argument,  0, 't'},
       {"help",        no_argument,        0, 'h'},
       {"init",        no_argument,        0, 'I'},
+      {"sweep",       required_argument,  0, 's'},
+      {"scoring",     required_argument,  0, 'S'},
+      {"seed",        required_argument,  0, 'x'},
+      {"replay",      required_argument,  0, 'p'},
       {0,0,0,0}
    };
    while(iarg != -1) {
-      iarg = getopt_long(argc, argv, "o:h:g:r:V:ibhI", longopts, &index);
+      iarg = getopt_long(argc, argv, "o:h:g:r:V:s:S:x:p:ibhI", longopts, &index);
 
       switch (iarg)
       {
@@ -123,6 +169,27 @@ int main(int argc,char** argv)
             run_manager_init = true;
             break;
 
+         case 's':
+            sweep_file_name = optarg;
+            break;
+
+         case 'S':
+            scoring_mode = optarg;
+            if( scoring_mode != "parallel" && scoring_mode != "analytic" && scoring_mode != "both" ) {
+               std::cout << "Error : unknown scoring mode " << scoring_mode << std::endl;
+               print_help();
+               exit(EXIT_FAILURE);
+            }
+            break;
+
+         case 'x':
+            seed = atoll( optarg );
+            break;
+
+         case 'p':
+            replay_spec = optarg;
+            break;
+
          case 'o':
             output_file_name = optarg;
             if( fexists(output_file_name) ) {
@@ -155,6 +222,24 @@ int main(int argc,char** argv)
    std::cout << "output : " << output_file_name << std::endl;
    std::cout << "  tree : " << output_tree_name << std::endl;
 
+   // --replay run:event[,event...]
+   int              replay_run = -1;
+   std::vector<int> replay_events;
+   if( !replay_spec.empty() ) {
+      std::istringstream is(replay_spec);
+      char        colon = 0;
+      std::string event;
+      if( !(is >> replay_run >> colon) || colon != ':' ) replay_run = -1;
+      while( replay_run >= 0 && std::getline(is, event, ',') ) {
+         if( !event.empty() ) replay_events.push_back(atoi(event.c_str()));
+      }
+      if( replay_run < 0 || replay_events.empty() ) {
+         std::cout << "Error : bad replay " << replay_spec << " (expected run:event[,event...])" << std::endl;
+         print_help();
+         exit(EXIT_FAILURE);
+      }
+   }
+
    //---------------------------------------------------------------------------
 
    // Detect interactive mode (if no arguments) and define UI session
@@ -170,8 +255,9 @@ int main(int argc,char** argv)
 
    // Choose the Random engine
    G4Random::setTheEngine(new CLHEP::RanecuEngine);
-   G4long seed = time(NULL);
    CLHEP::HepRandom::setTheSeed(seed);
+   B1EventSeeds::SetSeed(seed);
+   std::cout << "  seed : " << seed << std::endl;
 
    // Construct the default run manager
 #ifdef G4MULTITHREADED
@@ -187,7 +273,14 @@ int main(int argc,char** argv)
    B1DetectorConstruction        * realWorld     = new B1DetectorConstruction();
    B1ParallelWorldConstruction * parallelWorld = new B1ParallelWorldConstruction(paraWorldName);
 
-   realWorld->RegisterParallelWorld(parallelWorld);
+   // The parallel world only holds the plane layout when the planes are
+   // scored analytically
+   bool use_parallel_world = (scoring_mode != "analytic");
+   B1PlaneCrossingScorer::SetEnabled(scoring_mode != "parallel");
+   B1PlaneCrossingScorer::SetValidation(scoring_mode == "both");
+
+   realWorld->SetScoringPlanes(parallelWorld);
+   if( use_parallel_world ) realWorld->RegisterParallelWorld(parallelWorld);
    runManager->SetUserInitialization(realWorld);
 
    // Physics list
@@ -211,7 +304,9 @@ int main(int argc,char** argv)
    physicsList->RegisterPhysics(new G4StepLimiterPhysics());
 
    // This connects the phyics to the parallel world (and sensitive detectors)
-   physicsList->RegisterPhysics(new G4ParallelWorldPhysics(paraWorldName,/*layered_mass=*/true));
+   if( use_parallel_world ) {
+      physicsList->RegisterPhysics(new G4ParallelWorldPhysics(paraWorldName,/*layered_mass=*/true));
+   }
    //physicsList->ReplacePhysics(new G4IonQMDPhysics());
    //physicsList->SetDefaultCutValue(0.005*um);
 
@@ -245,7 +340,8 @@ int main(int argc,char** argv)
    if( has_macro_file ) {
       G4String command = "/control/execute ";
       G4String fileName = argv[optind];
-      UImanager->ApplyCommand(command+fileName);
+      if( replay_events.empty() ) UImanager->ApplyCommand(command+fileName);
+      else                        execute_without_beamOn(UImanager, fileName);
    } else {
 
       // interactive mode
@@ -264,6 +360,24 @@ int main(int argc,char** argv)
       }
    }
 
+   // the macro has set up the geometry: one run per replayed event, on one
+   // thread (the worker threads are started by the first beamOn)
+   if( !replay_events.empty() ) {
+#ifdef G4MULTITHREADED
+      runManager->SetNumberOfThreads(1);
+#endif
+      UImanager->ApplyCommand("/tracking/verbose 1");
+      for(int event : replay_events) {
+         B1EventSeeds::SetReplay(replay_run, event);
+         UImanager->ApplyCommand("/run/beamOn 1");
+      }
+   }
+
+   if( !sweep_file_name.empty() ) {
+      G4String command = "/B1/run/sweep ";
+      UImanager->ApplyCommand(command+sweep_file_name);
+   }
+
    if( is_interactive )  {
       ui->SessionStart();
       delete ui;
@@ -0,0 +1,212 @@
+#include "B1DetectorConstruction.hh"
+#include "B1ParallelWorldConstruction.hh"
+#include "B1NavigationBenchmark.hh"
+#include "G4SystemOfUnits.hh"
+#include "getopt.h"
+
+#include "G4RunManager.hh"
+#include "G4UImanager.hh"
+#include "G4StateManager.hh"
+#include "G4GeometryManager.hh"
+#include "G4TransportationManager.hh"
+#include "G4Timer.hh"
+
+//______________________________________________________________________________
+
+void print_help() {
+
+   std::cout << "usage: ebl1_geobench [options] [macro file]   \n";
+   std::cout << "  Steps geantinos through B1DetectorConstruction and\n";
+   std::cout << "  B1ParallelWorldConstruction without any physics.\n";
+   std::cout << "  The optional macro is executed before the benchmark\n";
+   std::cout << "  (e.g. /B1/det/... geometry settings).\n";
+   std::cout << "Options:                               \n";
+   std::cout << "    --tracks=#, -n      number of tracks (default 10000)\n";
+   std::cout << "    --pattern=, -p      pencil, cone (default), iso or grid\n";
+   std::cout << "    --angle=#, -a       cone half angle in degrees (default 30)\n";
+   std::cout << "    --spread=#, -s      half width of the source spot in mm (default 1)\n";
+   std::cout << "    --x=#, --y=#, --z=# source position in mm (default 0,0,-200)\n";
+   std::cout << "    --seed=#            random seed for the track directions\n";
+   std::cout << "    --max-steps=#       step limit per track\n";
+   std::cout << "    --no-parallel, -N   do not navigate the parallel world\n";
+   std::cout << "    --overlaps=#, -o    check for overlaps with # points per volume\n";
+   std::cout << "                        instead of the benchmark (exit status 1 if any)\n";
+   std::cout << "    --threads=#, -t     overlap check threads (default: all cores)\n";
+   std::cout << "    --time-budget=#     overlap check time limit in s (default 30)\n";
+}
+
+//______________________________________________________________________________
+
+int main(int argc,char** argv)
+{
+   int          ntracks           = 10000;
+   std::string  pattern           = "cone";
+   double       angle             = 30.0;
+   double       spread            = 1.0;
+   double       x0                = 0.0;
+   double       y0                = 0.0;
+   double       z0                = -200.0;
+   long         seed              = 12345;
+   int          max_steps         = 100000;
+   bool         use_parallel      = true;
+   int          overlap_points    = 0;
+   int          overlap_threads   = 0;
+   double       overlap_time      = 30.0;
+
+   //---------------------------------------------------------------------------
+
+   int index = 0;
+   int iarg  = 0;
+   opterr    = 1;
+   const struct option longopts[] =
+   {
+      {"tracks",      required_argument,  0, 'n'},
+      {"pattern",     required_argument,  0, 'p'},
+      {"angle",       required_argument,  0, 'a'},
+      {"spread",      required_argument,  0, 's'},
+      {"x",           required_argument,  0, 'x'},
+      {"y",           required_argument,  0, 'y'},
+      {"z",           required_argument,  0, 'z'},
+      {"seed",        required_argument,  0, 'S'},
+      {"max-steps",   required_argument,  0, 'm'},
+      {"no-parallel", no_argument,        0, 'N'},
+      {"overlaps",    required_argument,  0, 'o'},
+      {"threads",     required_argument,  0, 't'},
+      {"time-budget", required_argument,  0, 'T'},
+      {"help",        no_argument,        0, 'h'},
+      {0,0,0,0}
+   };
+   while(iarg != -1) {
+      iarg = getopt_long(argc, argv, "n:p:a:s:x:y:z:S:m:No:t:T:h", longopts, &index);
+
+      switch (iarg)
+      {
+         case 'n':
+            ntracks = atoi( optarg );
+            break;
+
+         case 'p':
+            pattern = optarg;
+            break;
+
+         case 'a':
+            angle = atof( optarg );
+            break;
+
+         case 's':
+            spread = atof( optarg );
+            break;
+
+         case 'x':
+            x0 = atof( optarg );
+            break;
+
+         case 'y':
+            y0 = atof( optarg );
+            break;
+
+         case 'z':
+            z0 = atof( optarg );
+            break;
+
+         case 'S':
+            seed = atol( optarg );
+            break;
+
+         case 'm':
+            max_steps = atoi( optarg );
+            break;
+
+         case 'N':
+            use_parallel = false;
+            break;
+
+         case 'o':
+            overlap_points = atoi( optarg );
+            break;
+
+         case 't':
+            overlap_threads = atoi( optarg );
+            break;
+
+         case 'T':
+            overlap_time = atof( optarg );
+            break;
+
+         case 'h':
+            print_help();
+            exit(0);
+            break;
+
+         case '?':
+            print_help();
+            exit(EXIT_FAILURE);
+            break;
+      }
+   }
+
+   if( B1NavigationBenchmark::PatternFromName(pattern) < 0 ) {
+      std::cout << "Error : unknown pattern " << pattern << std::endl;
+      print_help();
+      exit(EXIT_FAILURE);
+   }
+
+   //---------------------------------------------------------------------------
+
+   // A sequential run manager is only used to build the mass and parallel
+   // worlds; no physics list is needed since no event is processed.
+   G4RunManager * runManager = new G4RunManager;
+
+   G4String                      paraWorldName = "ParallelWorld";
+   B1DetectorConstruction      * realWorld     = new B1DetectorConstruction();
+   B1ParallelWorldConstruction * parallelWorld = new B1ParallelWorldConstruction(paraWorldName);
+
+   realWorld->RegisterParallelWorld(parallelWorld);
+   runManager->SetUserInitialization(realWorld);
+
+   G4Timer timer;
+   timer.Start();
+   runManager->InitializeGeometry();
+   timer.Stop();
+   std::cout << "geometry construction : " << timer.GetRealElapsed() << " s" << std::endl;
+
+   // Geometry commands are only available in the Idle state
+   G4StateManager::GetStateManager()->SetNewState(G4State_Idle);
+   if( optind < argc ) {
+      G4String command = "/control/execute ";
+      G4UImanager::GetUIpointer()->ApplyCommand(command + argv[optind]);
+   }
+
+   if( overlap_points > 0 ) {
+      G4int noverlaps = realWorld->CheckOverlaps(overlap_points, overlap_threads, overlap_time);
+      delete runManager;
+      return (noverlaps > 0) ? 1 : 0;
+   }
+
+   G4TransportationManager * transportation = G4TransportationManager::GetTransportationManager();
+   G4VPhysicalVolume       * massWorld      = transportation->GetNavigatorForTracking()->GetWorldVolume();
+   G4VPhysicalVolume       * paraWorld      = use_parallel ? transportation->GetParallelWorld(paraWorldName) : 0;
+
+   G4GeometryManager * geoman = G4GeometryManager::GetInstance();
+   timer.Start();
+   if( !geoman->IsGeometryClosed() ) geoman->CloseGeometry(true);
+   timer.Stop();
+   std::cout << "geometry optimisation : " << timer.GetRealElapsed() << " s" << std::endl;
+
+   B1NavigationBenchmark bench(massWorld, paraWorld);
+   bench.SetPattern( B1NavigationBenchmark::PatternFromName(pattern) );
+   bench.SetNumberOfTracks( ntracks );
+   bench.SetConeHalfAngle( angle*degree );
+   bench.SetSpotHalfWidth( spread*mm );
+   bench.SetOrigin( G4ThreeVector(x0*mm, y0*mm, z0*mm) );
+   bench.SetSeed( seed );
+   bench.SetMaxSteps( max_steps );
+
+   B1NavigationBenchmark::Result result = bench.Run();
+   B1NavigationBenchmark::Print(result);
+
+   geoman->OpenGeometry();
+   delete runManager;
+   return 0;
+}
+//______________________________________________________________________________
@@ -0,0 +1,127 @@
+#include "B1HitReader.hh"
+#include "getopt.h"
+
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <chrono>
+#include <cstdlib>
+
+//______________________________________________________________________________
+
+void print_help() {
+
+   std::cout << "usage: ebl1_hitscan [options] file.bin [file.bin ...]   \n";
+   std::cout << "  Reads hit files written with /B1/run/writeHits.\n";
+   std::cout << "  Without options every file is scanned and the hits per plane\n";
+   std::cout << "  are summarised, with the scan rate.\n";
+   std::cout << "Options:                               \n";
+   std::cout << "    --event=#, -e       print the hits of one event\n";
+   std::cout << "    --plane=#, -p       only this plane\n";
+}
+
+//______________________________________________________________________________
+
+int main(int argc,char** argv)
+{
+   long long    event             = -1;
+   int          plane             = -1;
+
+   //---------------------------------------------------------------------------
+
+   int index = 0;
+   int iarg  = 0;
+   opterr    = 1;
+   const struct option longopts[] =
+   {
+      {"event",       required_argument,  0, 'e'},
+      {"plane",       required_argument,  0, 'p'},
+      {"help",        no_argument,        0, 'h'},
+      {0,0,0,0}
+   };
+   while(iarg != -1) {
+      iarg = getopt_long(argc, argv, "e:p:h", longopts, &index);
+
+      switch (iarg)
+      {
+         case 'e':
+            event = atoll( optarg );
+            break;
+
+         case 'p':
+            plane = atoi( optarg );
+            break;
+
+         case 'h':
+            print_help();
+            exit(0);
+            break;
+
+         case '?':
+            print_help();
+            exit(EXIT_FAILURE);
+            break;
+      }
+   }
+   if( optind >= argc ) {
+      print_help();
+      exit(EXIT_FAILURE);
+   }
+
+   //---------------------------------------------------------------------------
+
+   struct PlaneSum { long long n = 0; double ekin = 0.0; double edep = 0.0; };
+   std::map<int, PlaneSum> planes;
+   double      bytes  = 0.0;
+   long long   nhits  = 0;
+   auto        t0     = std::chrono::steady_clock::now();
+
+   for(int ifile = optind; ifile < argc; ifile++) {
+      B1HitReader reader;
+      if( !reader.Open(argv[ifile]) ) {
+         std::cout << "Error : " << reader.GetError() << std::endl;
+         exit(EXIT_FAILURE);
+      }
+
+      if( event >= 0 ) {
+         // one event: O(1) lookup, only its pages are read
+         reader.AdviseSequential(false);
+         B1HitReader::Hits h = (plane >= 0) ? reader.GetEvent(event, plane) : reader.GetEvent(event);
+         for(std::size_t i = 0; i < h.n; i++) {
+            std::cout << std::setw(10) << h.event[i] << std::setw(6) << h.plane[i]
+               << std::setw(12) << h.pdg[i]
+               << std::setw(12) << h.x[i]  << std::setw(12) << h.y[i]
+               << std::setw(12) << h.px[i] << std::setw(12) << h.py[i] << std::setw(12) << h.pz[i]
+               << std::setw(12) << h.ekin[i] << std::setw(12) << h.edep[i] << "\n";
+         }
+         continue;
+      }
+
+      reader.AdviseSequential(true);
+      bytes += reader.GetFileSize();
+      reader.ForEachBlock([&](const B1HitReader::Hits& h) {
+         for(std::size_t i = 0; i < h.n; i++) {
+            if( plane >= 0 && h.plane[i] != plane ) continue;
+            PlaneSum& s = planes[h.plane[i]];
+            s.n++;
+            s.ekin += h.ekin[i];
+            s.edep += h.edep[i];
+         }
+         nhits += h.n;
+      }, plane);
+   }
+   if( event >= 0 ) return 0;
+
+   std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+   std::cout << std::setw(8) << "plane" << std::setw(14) << "hits"
+      << std::setw(16) << "<Ekin> (MeV)" << std::setw(16) << "<edep> (MeV)" << "\n";
+   for(const auto& p : planes) {
+      std::cout << std::setw(8) << p.first << std::setw(14) << p.second.n
+         << std::setw(16) << p.second.ekin/p.second.n
+         << std::setw(16) << p.second.edep/p.second.n << "\n";
+   }
+   std::cout << " scanned " << nhits << " hits, " << bytes/1048576.0 << " MB in "
+      << dt.count() << " s (" << ((dt.count() > 0.0) ? bytes/1048576.0/dt.count() : 0.0)
+      << " MB/s)" << std::endl;
+   return 0;
+}
@@ -0,0 +1,105 @@
+#ifndef B1Accumulators_h
+#define B1Accumulators_h 1
+
+#include "globals.hh"
+#include <vector>
+
+/// Typed set of run accumulators: counters, weighted sums (with the sums of
+/// squares, for a mean and its uncertainty) and small arrays.
+///
+/// The accumulators are registered by name, in the same order on every
+/// thread, and then used by id; a fill is an index into a flat vector.
+/// Two sets with the same registrations are added with Merge(), which is
+/// what B1Run does across threads.
+
+class B1Accumulators
+{
+   public:
+      enum Type {
+         kCounter = 0,
+         kSum     = 1,
+         kArray   = 2
+      };
+
+   public:
+      G4int AddCounter(const G4String& name);
+      G4int AddSum(const G4String& name);
+      G4int AddArray(const G4String& name, std::size_t size = 0);
+
+      /// Id of an accumulator, or -1
+      G4int Find(const G4String& name) const;
+
+      G4int           GetNumberOfAccumulators() const { return fDefinitions.size(); }
+      const G4String& GetName(G4int id) const         { return fDefinitions[id].name; }
+      G4int           GetType(G4int id) const         { return fDefinitions[id].type; }
+
+      inline void Count(G4int id, G4long n = 1);
+      inline void Fill(G4int id, G4double x, G4double w = 1.0);
+      /// Add x to element i of an array, which grows as needed
+      inline void Add(G4int id, std::size_t i, G4double x);
+
+      G4long   GetCount(G4int id) const { return fCounters[fDefinitions[id].offset]; }
+      G4double GetEntries(G4int id) const;
+      G4double GetSum(G4int id) const;
+      G4double GetSum2(G4int id) const;
+      G4double GetMean(G4int id) const;
+      G4double GetRMS(G4int id) const;
+      G4double GetMeanError(G4int id) const;
+      const std::vector<G4double>& GetArray(G4int id) const { return fArrays[fDefinitions[id].offset]; }
+
+      void Merge(const B1Accumulators& other);
+      void Reset();
+
+      /// One line per accumulator (arrays: their size and total)
+      void Print() const;
+
+   private:
+      struct Definition {
+         G4String    name;
+         G4int       type;
+         std::size_t offset;     // in the vector of its type
+      };
+
+      struct Sum {
+         G4double n;
+         G4double sw, sw2;
+         G4double swx, swx2;
+      };
+
+      G4int Define(const G4String& name, G4int type, std::size_t offset);
+
+   private:
+      std::vector<Definition>               fDefinitions;
+      std::vector<G4long>                   fCounters;
+      std::vector<Sum>                      fSums;
+      std::vector< std::vector<G4double> >  fArrays;
+};
+
+//______________________________________________________________________________
+
+inline void B1Accumulators::Count(G4int id, G4long n)
+{
+   fCounters[fDefinitions[id].offset] += n;
+}
+//______________________________________________________________________________
+
+inline void B1Accumulators::Fill(G4int id, G4double x, G4double w)
+{
+   Sum& s = fSums[fDefinitions[id].offset];
+   s.n    += 1.0;
+   s.sw   += w;
+   s.sw2  += w*w;
+   s.swx  += w*x;
+   s.swx2 += w*x*x;
+}
+//______________________________________________________________________________
+
+inline void B1Accumulators::Add(G4int id, std::size_t i, G4double x)
+{
+   std::vector<G4double>& a = fArrays[fDefinitions[id].offset];
+   if( i >= a.size() ) a.resize(i + 1, 0.0);
+   a[i] += x;
+}
+
+#endif
+
@@ -0,0 +1,107 @@
+#ifndef B1ConvergenceMonitor_h
+#define B1ConvergenceMonitor_h 1
+
+#include "globals.hh"
+#include "B1Welford.hh"
+#include "B1PlaneHistograms.hh"
+#include <vector>
+#include <map>
+#include <atomic>
+
+/// Online statistics of the scoring planes and optional auto-stop.
+///
+/// Per plane and species each thread keeps the running mean and variance
+/// of the crossing energy (B1Welford) and the sums of the per-event
+/// crossing counts, so the count has a relative uncertainty that accounts
+/// for the event-to-event spread. It also sums, per event, the forward
+/// crossings (forw0) of two planes for the transmission ratio
+/// num/den (default plane 2 / plane 1), whose relative uncertainty is
+/// computed from the event sums with their correlation.
+///
+/// Every check interval events a thread publishes its ratio sums under a
+/// short lock and combines those of all threads; once the combined
+/// relative uncertainty is below the target, a flag is raised and each
+/// thread softly aborts its event loop at the end of its current event.
+/// No thread ever waits for another. At the end of the run the threads add
+/// their statistics into a shared total which the master prints.
+///
+/// The statistics are fed by one B1PlaneHistograms per thread (the
+/// parallel world planes, or the analytic ones when they are alone).
+
+class B1ConvergenceMonitor
+{
+   public:
+      static B1ConvergenceMonitor * Instance();
+
+      /// Target relative uncertainty of the ratio, 0 to never stop
+      static void     SetTarget(G4double rel)          { fgTarget = rel; }
+      static G4double GetTarget()                      { return fgTarget; }
+      static void     SetCheckInterval(G4int n)        { fgCheckInterval = n; }
+      static void     SetRatioPlanes(G4int num, G4int den) { fgNumPlane = num; fgDenPlane = den; }
+
+      static G4int    GetNumeratorPlane()              { return fgNumPlane; }
+      static G4int    GetDenominatorPlane()            { return fgDenPlane; }
+
+      static G4bool   StopRequested()                  { return fgStop.load(std::memory_order_relaxed); }
+
+      /// Called by the B1PlaneHistograms that feeds the statistics
+      void Configure(G4int nplanes, const std::vector<G4int>& printPlanes);
+
+      void BeginOfRun();
+      /// Add this thread's statistics to the shared total
+      void EndOfRun();
+      /// Print the shared total (master, after the workers' EndOfRun)
+      static void Print();
+
+      inline void AddCrossing(G4int plane, G4int species, G4double energy);
+      void AddEventCounts(G4int plane, const G4int * n);
+      void EndOfEvent(G4int forwardNum, G4int forwardDen);
+
+   private:
+      /// Sums over events of the forward crossings of the ratio planes
+      struct RatioSums {
+         G4double n, sx, sy, sxx, syy, sxy;
+         void Merge(const RatioSums& o);
+         /// Ratio sx/sy and its relative uncertainty
+         G4double Ratio() const { return (sy > 0.0) ? sx/sy : 0.0; }
+         G4double RelativeError() const;
+      };
+
+      struct PlaneStats {
+         B1Welford  energy;
+         G4double   sumN, sumN2;     // per-event counts
+      };
+
+      B1ConvergenceMonitor();
+
+      void Publish();
+
+   private:
+      static G4double                             fgTarget;
+      static G4int                                fgCheckInterval;
+      static G4int                                fgNumPlane;
+      static G4int                                fgDenPlane;
+      static std::atomic<bool>                    fgStop;
+      static std::map<G4int, RatioSums>           fgPublished;     // per thread
+      static RatioSums                            fgTotalRatio;
+      static std::vector<PlaneStats>              fgTotalStats;
+      static std::vector<G4int>                   fgPrintPlanes;
+      static G4double                             fgTotalEvents;
+      static G4ThreadLocal B1ConvergenceMonitor * fgInstance;
+
+      G4int                    fNplanes;
+      std::vector<G4int>       fPrintPlanes;
+      std::vector<PlaneStats>  fStats;        // plane*kNSpecies + species
+      RatioSums                fRatio;
+      G4long                   fEvents;
+};
+
+//______________________________________________________________________________
+
+inline void B1ConvergenceMonitor::AddCrossing(G4int plane, G4int species, G4double energy)
+{
+   fStats[plane*B1PlaneHistograms::kNSpecies + species].energy.Add(energy);
+}
+
+#endif
+
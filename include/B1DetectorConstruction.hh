@@ -10,8 +10,17 @@ class B1DetectorMessenger;
 class G4Material;
 class G4VSolid;
 class FakeSD;
+class G4VisAttributes;
+class B1WireParameterisation;
+class G4GenericTrap;
+class G4UserLimits;
+class G4ProductionCuts;
+class B1ParallelWorldConstruction;
 #include "G4ThreeVector.hh"
 #include "G4String.hh"
+#include "G4RotationMatrix.hh"
+#include <vector>
+#include <cstdint>
 
 /// Detector construction class to define materials and geometry.
 
@@ -43,9 +52,17 @@ class B1DetectorConstruction : public G4VUserDetectorConstruction
       G4double window_thickness  ;
       G4double scoring2_diameter ;
       G4double scoring2_length   ;
+      G4double trap_width        ;
+      G4double wire_spacing      ;
+      G4double wire_angle        ;
+      G4double wire_length0      ;
+      G4double wire_y0           ;
+      G4int    fNWires           ;
+      G4bool   fUseWireParameterisation;
 
    protected:
       G4LogicalVolume     * fScoringVolume;
+      B1ParallelWorldConstruction * fScoringPlanes;
       B1DetectorMessenger * fMessenger;
       G4String    fCollimatorMatName;
 
@@ -82,6 +99,24 @@ class B1DetectorConstruction : public G4VUserDetectorConstruction
       G4VSolid          * collimator2_solid ;
       G4LogicalVolume   * collimator2_log ;  
       G4VPhysicalVolume * collimator2_phys;  
+      B1WireParameterisation * fWireParam;
+      G4RotationMatrix       * fWireRotation;
+      std::vector<G4VPhysicalVolume*> fWirePlacements;
+
+      G4int               fRegionSolidMode;
+      G4int               fCollimatorSolidMode;
+
+      G4bool              fMaterialsBuilt;
+      G4UserLimits      * fRegionLimits[3];
+      G4ProductionCuts  * fRegionCuts[3];
+
+      G4bool              fUseSnapshot;
+      G4String            fSnapshotDir;
+      G4VisAttributes   * world_vis;
+      G4VisAttributes   * beampipe_vis;
+      G4VisAttributes   * radiator_vis;
+      G4VisAttributes   * collimator_vis;
+      G4VisAttributes   * collimator2_vis;
       G4ThreeVector       outer_collimator_pos;
       G4Material        * outer_collimator_mat ;  
       G4VSolid          * outer_collimator_solid ;
@@ -104,6 +139,29 @@ class B1DetectorConstruction : public G4VUserDetectorConstruction
       G4VPhysicalVolume * scoring2_phys ;
 
    public:
+      /// Parts of the geometry that a parameter change invalidates
+      enum RebuildFlags {
+         kRebuildNone       = 0,
+         kRebuildPositions  = 1 << 0,
+         kRebuildCollimator = 1 << 1,
+         kRebuildWires      = 1 << 2
+      };
+
+      /// How the drift chamber region solid is built
+      enum RegionSolidMode {
+         kRegionBoolean     = 0,   // 5 m box intersected with the G4GenericTrap
+         kRegionGenericTrap = 1,   // the G4GenericTrap alone
+         kRegionTessellated = 2    // planar facets through the trap vertices
+      };
+
+      /// Regions with their own production cuts and user limits. The
+      /// chamber region holds the drift chamber gas and the wires.
+      enum RegionIndex {
+         kRadiatorRegion = 0,
+         kChamberRegion  = 1,
+         kWorldRegion    = 2
+      };
+
       B1DetectorConstruction();
       virtual ~B1DetectorConstruction();
 
@@ -121,16 +179,89 @@ class B1DetectorConstruction : public G4VUserDetectorConstruction
       void     SetCollimatorToothSlope(G4double l);
       void     SetInnerCollimatorUpstreamID(G4double l) ;
       void     SetInnerCollimatorDownstreamID(G4double l) ;
+      void     SetNumberOfWires(G4int n) ;
+      void     SetWireSpacing(G4double l) ;
+      void     SetWireParameterisation(G4bool val) ;
+      void     SetRegionSolid(G4String mode) ;
+
+      void     BenchmarkRegionSolids(G4int npoints) const;
+
+      /// Smart voxel controls of a logical volume (by name). When the
+      /// geometry is closed the voxels of the volume are rebuilt at once.
+      void     SetSmartless(G4String volume, G4double smartless) ;
+      void     SetVoxelOptimisation(G4String volume, G4bool val) ;
+      void     PrintVoxelInfo(G4String volume) const;
+
+      /// Try nvalues smartless values in [smin,smax] for a volume, timing
+      /// ntracks geantinos from the wire plane for each, and keep the fastest.
+      void     TuneSmartless(G4String volume, G4double smin, G4double smax, G4int nvalues, G4int ntracks);
+
+      /// Production cut (particle: gamma, e-, e+, proton or all) and user
+      /// limits of a region (Radiator, Chamber or World). The World cuts are
+      /// the default cuts, used by any region without cuts of its own, and
+      /// are set after /run/initialize only.
+      void     SetRegionCut(G4String region, G4String particle, G4double cut) ;
+      void     SetRegionStepMax(G4String region, G4double l) ;
+      void     SetRegionMinEkin(G4String region, G4double e) ;
+      void     SetRegionMaxTime(G4String region, G4double t) ;
+      void     PrintRegions() const;
+
+      /// Check the world and drift chamber daughters for overlaps with
+      /// npoints surface points each, on nthreads threads, stopping after
+      /// maxTime seconds. Returns the number of overlaps found.
+      G4int    CheckOverlaps(G4int npoints, G4int nthreads, G4double maxTime) const;
+
+      G4int    GetNumberOfWires() const { return fNWires; }
+
+      /// Load the geometry from a binary snapshot when one exists for the
+      /// current parameters, otherwise build it and write the snapshot.
+      void     SetUseSnapshot(G4bool val) { fUseSnapshot = val; }
+      void     SetSnapshotDir(G4String dir) { fSnapshotDir = dir; }
+
+      /// Hash of every parameter that changes the constructed geometry.
+      std::uint64_t GetParameterHash() const;
 
       void     PrintConfigInfo() const;
 
       void CalculatePositions();
 
-      void Rebuild();
+      /// Rebuild only the parts selected by flags (see RebuildFlags) and
+      /// re-voxelise the affected subtree, then tell the run manager the
+      /// geometry was modified. The time taken is printed.
+      void Rebuild(G4int flags);
 
       G4LogicalVolume* GetScoringVolume() const { return fScoringVolume; }
 
+      /// Layout of the scoring planes, whether or not their parallel world
+      /// is registered (the analytic scorer only needs the positions).
+      void SetScoringPlanes(B1ParallelWorldConstruction * planes) { fScoringPlanes = planes; }
+      B1ParallelWorldConstruction * GetScoringPlanes() const { return fScoringPlanes; }
+
    protected:
+      void ConstructMaterials();
+      void ConstructVisAttributes();
+      void ConstructRadiator();
+      void ConstructCollimator();
+      void ConstructWires();
+      void ClearWires();
+
+      G4VPhysicalVolume * GetRebuildHandle(G4int flags) const;
+
+      void              ConstructRegions();
+      G4int             FindRegionIndex(const G4String& name) const;
+      G4UserLimits    * GetRegionLimits(G4int index);
+
+      G4LogicalVolume * FindLogicalVolume(const G4String& name) const;
+      G4double          ReoptimiseVolume(G4LogicalVolume * lv) const;
+
+      G4bool LoadSnapshot();
+      void   SaveSnapshot(G4double buildTime);
+
+      G4GenericTrap * BuildRegionTrap() const;
+      G4VSolid      * BuildRegionSolid(G4int mode) const;
+      /// Delete a solid of BuildRegionSolid, with the parts of the boolean
+      void            DeleteRegionSolid(G4VSolid * solid) const;
+      G4ThreeVector   GetRegionOffset() const;
 };
 //______________________________________________________________________________
 
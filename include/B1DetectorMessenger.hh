@@ -10,6 +10,9 @@ class G4UIcmdWithAString;
 class G4UIcmdWithADoubleAndUnit;
 class G4UIcmdWithADouble;
 class G4UIcmdWithoutParameter;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithABool;
+class G4UIcommand;
 
 
 /// Messenger class that defines commands for B1DetectorConstruction.
@@ -18,6 +21,24 @@ class G4UIcmdWithoutParameter;
 /// - /B1/det/setTargetMaterial name
 /// - /B1/det/setChamberMaterial name
 /// - /B1/det/stepMax value unit
+/// - /B1/det/setNumberOfWires n
+/// - /B1/det/setWireSpacing value unit
+/// - /B1/det/setWireParameterisation bool
+/// - /B1/det/setRegionSolid boolean|generictrap|tessellated
+/// - /B1/det/benchmarkRegionSolid npoints
+/// - /B1/det/setSmartless volume value
+/// - /B1/det/setVoxelOptimisation volume bool
+/// - /B1/det/printVoxelInfo volume
+/// - /B1/det/tuneSmartless volume min max nvalues ntracks
+/// - /B1/det/checkOverlaps npoints nthreads seconds
+/// - /B1/det/setRegionCut region particle value unit
+/// - /B1/det/setRegionStepMax region value unit
+/// - /B1/det/setRegionMinEkin region value unit
+/// - /B1/det/setRegionMaxTime region value unit
+/// - /B1/det/printRegions
+/// - /B1/det/printMaterials
+/// - /B1/det/useSnapshot bool
+/// - /B1/det/setSnapshotDir path
 
 class B1DetectorMessenger: public G4UImessenger
 {
@@ -26,6 +47,11 @@ class B1DetectorMessenger: public G4UImessenger
     virtual ~B1DetectorMessenger();
     
     virtual void SetNewValue(G4UIcommand*, G4String);
+
+  private:
+    /// "/B1/det/<name> region value unit" command
+    G4UIcommand * MakeRegionCommand(const G4String& name, const G4String& guidance,
+                                    const G4String& defaultUnit);
     
   private:
     B1DetectorConstruction*  fDetectorConstruction;
@@ -44,6 +70,24 @@ class B1DetectorMessenger: public G4UImessenger
     G4UIcmdWithADoubleAndUnit * fRadiatorCollimatorGapCmd;
     G4UIcmdWithAString        * fTargMatCmd;
     G4UIcmdWithAString        * fChamMatCmd;
+    G4UIcmdWithAnInteger      * fNumberOfWiresCmd;
+    G4UIcmdWithADoubleAndUnit * fWireSpacingCmd;
+    G4UIcmdWithABool          * fWireParameterisationCmd;
+    G4UIcmdWithAString        * fRegionSolidCmd;
+    G4UIcmdWithAnInteger      * fBenchmarkRegionSolidCmd;
+    G4UIcommand               * fSmartlessCmd;
+    G4UIcommand               * fVoxelOptimisationCmd;
+    G4UIcmdWithAString        * fPrintVoxelInfoCmd;
+    G4UIcommand               * fTuneSmartlessCmd;
+    G4UIcommand               * fCheckOverlapsCmd;
+    G4UIcommand               * fRegionCutCmd;
+    G4UIcommand               * fRegionStepMaxCmd;
+    G4UIcommand               * fRegionMinEkinCmd;
+    G4UIcommand               * fRegionMaxTimeCmd;
+    G4UIcmdWithoutParameter   * fPrintRegionsCmd;
+    G4UIcmdWithoutParameter   * fPrintMaterialsCmd;
+    G4UIcmdWithABool          * fUseSnapshotCmd;
+    G4UIcmdWithAString        * fSnapshotDirCmd;
 
     G4UIcmdWithADoubleAndUnit* fStepMaxCmd;
 };
@@ -0,0 +1,99 @@
+#ifndef B1EventProfiler_h
+#define B1EventProfiler_h 1
+
+#include "globals.hh"
+#include "G4Step.hh"
+#include "B1SteppingPlugin.hh"
+#include <vector>
+#include <cstdint>
+
+class G4Event;
+
+/// Per-event wall and CPU time, with the events that cost the most.
+///
+/// Each thread times its events (steady clock and the thread CPU clock),
+/// counts their steps and tracks, and fills log10 histograms of the times
+/// and step counts in its B1HistogramStore (/timing/...). It keeps the N
+/// slowest events (by CPU time) in a small heap together with their seeds
+/// (B1EventSeeds). At the end of the run the threads add their summaries
+/// into a shared one, and the master prints the time quantiles and the
+/// slowest events with their seeds, and the ebl1 --replay command that
+/// re-simulates them.
+
+class B1EventProfiler : public B1SteppingPlugin
+{
+   public:
+      static B1EventProfiler * Instance();
+
+      static void   SetEnabled(G4bool v)           { fgEnabled = v; }
+      static G4bool IsEnabled()                    { return fgEnabled; }
+      static void   SetNumberOfSlowEvents(G4int n) { fgNslow = n; }
+
+      /// Book the histograms (once), from B1RunAction::BookHistograms
+      void Book();
+      /// Clear the summary
+      void BeginOfRun();
+      /// Add this thread's summary and slowest events to the shared ones
+      void EndOfRun();
+      /// Print the shared summary and the slow events (master)
+      static void Print(G4int runNumber);
+
+      void BeginOfEvent();
+      void EndOfEvent(const G4Event * event);
+
+      inline void AddStep(const G4Step * step);
+
+      /// Stepping plugin: every step while on
+      virtual G4bool Select(std::vector<const G4LogicalVolume*>&,
+                            std::vector<const G4ParticleDefinition*>&) { return fgEnabled; }
+      virtual void   Step(const G4Step * step) { AddStep(step); }
+
+   private:
+      struct SlowEvent {
+         G4double  cpu, wall;     // s
+         G4int     event;
+         G4int     thread;
+         G4long    steps, tracks;
+         std::uint64_t seed;      // B1EventSeeds seed of the event
+      };
+
+      /// Number of events per log10(cpu time) bin, for the quantiles
+      struct Summary {
+         G4long                 events;
+         G4double               cpu, wall;
+         std::vector<G4long>    bins;
+      };
+
+      B1EventProfiler();
+
+      static G4double CpuTime();
+      static G4double WallTime();
+      static void Insert(std::vector<SlowEvent>& heap, const SlowEvent& e);
+      static G4int    LogBin(G4double t);
+      static G4double Quantile(const Summary& s, G4double q);
+
+   private:
+      static G4bool                           fgEnabled;
+      static G4int                            fgNslow;
+      static std::vector<SlowEvent>           fgSlowest;
+      static Summary                          fgSummary;
+      static G4ThreadLocal B1EventProfiler  * fgInstance;
+
+      G4bool                  fBooked;
+      G4int                   fhCpu, fhWall, fhSteps, fhCpuVsSteps;
+      G4double                fCpu0, fWall0;
+      G4long                  fSteps, fTracks;
+      std::vector<SlowEvent>  fSlowest;     // min-heap on cpu
+      Summary                 fSummary;
+};
+
+//______________________________________________________________________________
+
+inline void B1EventProfiler::AddStep(const G4Step * step)
+{
+   fSteps++;
+   if( step->GetTrack()->GetCurrentStepNumber() == 1 ) fTracks++;
+}
+
+#endif
+
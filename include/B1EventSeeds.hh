@@ -0,0 +1,66 @@
+#ifndef B1EventSeeds_h
+#define B1EventSeeds_h 1
+
+#include "globals.hh"
+#include <cstdint>
+
+/// Reproducible per-event random seeds, and the replay of single events.
+///
+/// The job seed (ebl1 --seed, the time by default) and the run (the B1 run
+/// number and the G4 run id) give a 64-bit run seed; the seed of an event
+/// is a hash of the run seed and the event id. The primary generator
+/// reseeds the engine of its thread with it before generating the
+/// primaries, which costs a couple of multiplications per event and makes
+/// every event depend only on (seed, run number, run id, event id), not on
+/// the thread or on the events before it.
+///
+/// In replay mode (ebl1 --replay run:event,...) the given run id and event
+/// id are used in place of the current ones, so one beamOn 1 re-simulates
+/// exactly that event.
+
+class B1EventSeeds
+{
+   public:
+      static void          SetSeed(std::uint64_t seed)   { fgSeed = seed; }
+      static std::uint64_t GetSeed()                     { return fgSeed; }
+
+      /// Re-simulate event of run id run in the next runs
+      static void   SetReplay(G4int run, G4int event)    { fgReplay = true; fgReplayRun = run; fgReplayEvent = event; }
+      static G4bool IsReplay()                           { return fgReplay; }
+
+      /// Every thread, at the beginning of the run
+      static void BeginOfRun(G4int runNumber, G4int runID);
+
+      /// Reseed this thread's engine for event (primary generator)
+      static void Reseed(G4int event);
+
+      static std::uint64_t GetRunSeed()                  { return fgRunSeed; }
+      static std::uint64_t GetEventSeed(G4int event);
+      /// Seed of the last Reseed() of this thread
+      static std::uint64_t GetLastEventSeed()            { return fgEventSeed; }
+
+   private:
+      static inline std::uint64_t Mix(std::uint64_t x);
+
+   private:
+      static std::uint64_t                fgSeed;
+      static G4bool                       fgReplay;
+      static G4int                        fgReplayRun;
+      static G4int                        fgReplayEvent;
+      static G4ThreadLocal std::uint64_t  fgRunSeed;
+      static G4ThreadLocal std::uint64_t  fgEventSeed;
+};
+
+//______________________________________________________________________________
+
+inline std::uint64_t B1EventSeeds::Mix(std::uint64_t x)
+{
+   // splitmix64
+   x += 0x9e3779b97f4a7c15ULL;
+   x  = (x ^ (x >> 30))*0xbf58476d1ce4e5b9ULL;
+   x  = (x ^ (x >> 27))*0x94d049bb133111ebULL;
+   return x ^ (x >> 31);
+}
+
+#endif
+
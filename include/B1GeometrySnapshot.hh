@@ -0,0 +1,75 @@
+#ifndef B1GeometrySnapshot_h
+#define B1GeometrySnapshot_h 1
+
+#include "globals.hh"
+#include <vector>
+#include <map>
+#include <cstdint>
+
+class G4VPhysicalVolume;
+class G4LogicalVolume;
+class G4VSolid;
+class G4Material;
+class G4Element;
+
+/// Compact binary snapshot of a constructed geometry.
+///
+/// The snapshot holds the materials (with their optical property tables),
+/// solids, logical volumes and placements below a world volume. It is keyed
+/// by a hash of the detector parameters and of the material records
+/// (MaterialHash) so that a stale file is never loaded. Loading reads and
+/// checks the whole file before it recreates the objects directly from the
+/// records, without any of the construction logic of the detector; a
+/// corrupt file creates nothing.
+///
+/// Supported solids: G4Box, G4Tubs, G4GenericTrap, G4TessellatedSolid and
+/// boolean solids of those. Parameterised volumes are supported for
+/// B1WireParameterisation. Writing fails (and no file is produced) if the
+/// geometry contains anything else.
+
+class B1GeometrySnapshot
+{
+   public:
+      B1GeometrySnapshot();
+      ~B1GeometrySnapshot();
+
+      /// Snapshot file name for a given parameter hash.
+      static G4String FileName(const G4String& dir, std::uint64_t hash);
+
+      /// Hash of the records of these materials (composition and optical
+      /// properties) exactly as they are saved, and of the file format.
+      static std::uint64_t MaterialHash(const std::vector<G4Material*>& materials);
+
+      /// Write the geometry below world. buildTime is the construction time
+      /// (seconds) of the code path, stored to report the time saved.
+      G4bool Write(const G4String& fileName, std::uint64_t hash, G4double buildTime,
+                   G4VPhysicalVolume * world);
+
+      /// Load a snapshot. Returns the world volume, or null if the file does
+      /// not exist, is corrupt or was written for other parameters.
+      G4VPhysicalVolume * Read(const G4String& fileName, std::uint64_t hash);
+
+      G4double GetBuildTime() const { return fBuildTime; }
+
+      G4VPhysicalVolume * FindPhysical(const G4String& name) const;
+      G4LogicalVolume   * FindLogical(const G4String& name) const;
+
+      const std::vector<G4VPhysicalVolume*>& GetPhysicals() const { return fPhysicals; }
+
+   private:
+      void  Collect(G4LogicalVolume * lv);
+      G4int AddSolid(G4VSolid * solid);
+      G4int AddMaterial(G4Material * mat);
+
+   private:
+      G4double                          fBuildTime;
+      std::vector<G4Material*>          fMaterials;
+      std::vector<G4VSolid*>            fSolids;
+      std::vector<G4LogicalVolume*>     fLogicals;
+      std::vector<G4VPhysicalVolume*>   fPhysicals;
+      std::map<const void*, G4int>      fIndex;
+      G4bool                            fSupported;
+};
+
+#endif
+
@@ -0,0 +1,142 @@
+#ifndef B1HistogramStore_h
+#define B1HistogramStore_h 1
+
+#include "globals.hh"
+#include <vector>
+
+/// Flat per-thread histogram store used by the sensitive detectors.
+///
+/// Each thread books its histograms in its own store and in its own
+/// G4AnalysisManager (which still owns the output), from
+/// B1RunAction::BeginOfRunAction on the master and on the workers alike,
+/// since the analysis managers are merged by histogram id. The bins of all histograms
+/// live in one contiguous array per thread, with the under/overflow bins at
+/// both ends of each axis, and a fill is a subtraction, a multiplication by
+/// the precomputed inverse bin width and an increment: no lookup by id and
+/// no lock.
+///
+/// At the end of a run each thread adds its bins into the histograms of its
+/// own analysis manager (Merge()), which then merges the threads as usual
+/// when the file is written.
+
+class B1HistogramStore
+{
+   public:
+      /// Per-bin sums, as kept by the tools histograms
+      struct Bin {
+         G4double n;
+         G4double sw, sw2;
+         G4double sxw, sx2w;
+         G4double syw, sy2w;
+      };
+
+   public:
+      /// The store of the calling thread
+      static B1HistogramStore * Instance();
+
+      /// Book a histogram in this thread's store and analysis manager.
+      /// Returns the store id (not the analysis manager id).
+      G4int CreateH1(const G4String& name, const G4String& title,
+                     G4int nbins, G4double xmin, G4double xmax);
+      G4int CreateH2(const G4String& name, const G4String& title,
+                     G4int nxbins, G4double xmin, G4double xmax,
+                     G4int nybins, G4double ymin, G4double ymax);
+
+      G4int GetNumberOfHistograms() const { return fDefinitions.size(); }
+
+      inline void FillH1(G4int id, G4double x, G4double w = 1.0);
+      inline void FillH2(G4int id, G4double x, G4double y, G4double w = 1.0);
+
+      /// n unit-weight fills at x in one go (counts accumulated elsewhere)
+      inline void AddH1(G4int id, G4double x, G4double n);
+
+      /// Add the bins into this thread's analysis manager histograms and
+      /// clear them.
+      void Merge();
+      void Reset();
+
+      /// Time nfills random fills of a 1D and a 2D histogram through a
+      /// private store and through tools histograms (what G4AnalysisManager
+      /// fills). Prints fills/s. Nothing is booked in the analysis manager.
+      static void Benchmark(G4long nfills);
+
+   private:
+      struct Definition {
+         G4int       dimension;
+         G4int       amId;         // analysis manager id
+         G4int       nx, ny;       // in-range bins
+         G4double    xmin, xmax, ymin, ymax;
+         G4double    xinv, yinv;   // inverse bin widths
+         std::size_t offset;       // first bin in the flat array
+         std::size_t nbins;        // including under/overflow
+      };
+
+      B1HistogramStore();
+
+      /// amId -1: not booked in the analysis manager (benchmark)
+      G4int AddH1(G4int amId, G4int nbins, G4double xmin, G4double xmax);
+      G4int AddH2(G4int amId, G4int nxbins, G4double xmin, G4double xmax,
+                  G4int nybins, G4double ymin, G4double ymax);
+      void  AddDefinition(Definition& d);
+
+      static inline G4int BinIndex(G4double v, G4double vmin, G4double inv, G4int n);
+
+   private:
+      static G4ThreadLocal B1HistogramStore * fgInstance;
+
+      std::vector<Definition>  fDefinitions;
+      std::vector<Bin>         fBins;
+};
+
+//______________________________________________________________________________
+
+inline G4int B1HistogramStore::BinIndex(G4double v, G4double vmin, G4double inv, G4int n)
+{
+   // 0 is the underflow, n+1 the overflow
+   G4double u = (v - vmin)*inv;
+   if( !(u >= 0.0) ) return 0;
+   return (u < G4double(n)) ? G4int(u) + 1 : n + 1;
+}
+//______________________________________________________________________________
+
+inline void B1HistogramStore::FillH1(G4int id, G4double x, G4double w)
+{
+   const Definition& d = fDefinitions[id];
+   Bin& b = fBins[d.offset + BinIndex(x, d.xmin, d.xinv, d.nx)];
+   b.n    += 1.0;
+   b.sw   += w;
+   b.sw2  += w*w;
+   b.sxw  += x*w;
+   b.sx2w += x*x*w;
+}
+//______________________________________________________________________________
+
+inline void B1HistogramStore::AddH1(G4int id, G4double x, G4double n)
+{
+   const Definition& d = fDefinitions[id];
+   Bin& b = fBins[d.offset + BinIndex(x, d.xmin, d.xinv, d.nx)];
+   b.n    += n;
+   b.sw   += n;
+   b.sw2  += n;
+   b.sxw  += x*n;
+   b.sx2w += x*x*n;
+}
+//______________________________________________________________________________
+
+inline void B1HistogramStore::FillH2(G4int id, G4double x, G4double y, G4double w)
+{
+   const Definition& d = fDefinitions[id];
+   G4int ix = BinIndex(x, d.xmin, d.xinv, d.nx);
+   G4int iy = BinIndex(y, d.ymin, d.yinv, d.ny);
+   Bin& b = fBins[d.offset + iy*(d.nx + 2) + ix];
+   b.n    += 1.0;
+   b.sw   += w;
+   b.sw2  += w*w;
+   b.sxw  += x*w;
+   b.sx2w += x*x*w;
+   b.syw  += y*w;
+   b.sy2w += y*y*w;
+}
+
+#endif
+
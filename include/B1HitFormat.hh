@@ -0,0 +1,102 @@
+#ifndef B1HitFormat_h
+#define B1HitFormat_h 1
+
+#include <cstdint>
+#include <cstddef>
+
+/// On-disk layout of the hit stream files (EBL_hits_*.bin).
+///
+///    FileHeader
+///    block 0 : BlockHeader, column 0 [nhits], column 1 [nhits], ...
+///    block 1 : ...
+///    (padding to 8 bytes)
+///    BlockIndex [nblocks]
+///    EventEntry [nevents]      sorted by event id, events with hits only
+///    (padding to 8 bytes)
+///    Trailer                   last bytes of the file
+///
+/// Columns are stored in Column order, each of nhits elements of
+/// ColumnSize(column) bytes, so every column of every block is 4-byte
+/// aligned in the file. A block only holds whole events and, within an
+/// event, hits are ordered by plane. The index gives the byte offset of
+/// each column of each block and, for each event of the file that has hits,
+/// its block and hit range, so an event is found by a binary search of the
+/// index without reading the blocks. The table only lists the events of
+/// its own file (with threads, every file holds some of the events of the
+/// run), so its size does not depend on the event id range.
+///
+/// Values are little-endian, lengths in cm, energies and momenta in MeV.
+/// This header has no Geant4 dependency so that analysis code can use it.
+
+namespace B1HitFormat
+{
+   const char          kMagic[8]        = {'E','B','L','H','I','T','S','\0'};
+   const char          kTrailerMagic[8] = {'E','B','L','I','N','D','X','\0'};
+   const std::uint32_t kVersion         = 3;
+
+   enum Column {
+      kEvent = 0,   // int32
+      kPlane,       // int32
+      kPdg,         // int32
+      kX,           // float
+      kY,           // float
+      kPx,          // float
+      kPy,          // float
+      kPz,          // float
+      kEkin,        // float
+      kEdep,        // float
+      kNColumns
+   };
+
+   inline std::size_t ColumnSize(int) { return 4; }
+
+   inline const char * ColumnName(int c)
+   {
+      static const char * names[kNColumns] = {
+         "event", "plane", "pdg", "x", "y", "px", "py", "pz", "ekin", "edep" };
+      return (c >= 0 && c < kNColumns) ? names[c] : "";
+   }
+
+   struct FileHeader {
+      char          magic[8];
+      std::uint32_t version;
+      std::uint32_t ncolumns;
+   };
+
+   struct BlockHeader {
+      std::uint32_t nhits;
+      std::int32_t  firstEvent;
+      std::int32_t  lastEvent;
+      std::uint32_t nevents;
+   };
+
+   struct BlockIndex {
+      std::uint64_t offset;                  // of the BlockHeader
+      std::uint64_t columnOffset[kNColumns];
+      std::uint32_t nhits;
+      std::int32_t  firstEvent;
+      std::int32_t  lastEvent;
+      std::uint32_t nevents;
+      std::int32_t  planeMin;
+      std::int32_t  planeMax;
+   };
+
+   struct EventEntry {
+      std::int32_t  event;
+      std::uint32_t block;
+      std::uint32_t firstHit;                // within the block
+      std::uint32_t nhits;
+   };
+
+   struct Trailer {
+      std::uint64_t indexOffset;             // of BlockIndex[0]
+      std::uint64_t nblocks;
+      std::int64_t  firstEvent;              // of EventEntry[0]
+      std::uint64_t nevents;                 // EventEntry count
+      std::uint64_t nhits;
+      char          magic[8];
+   };
+}
+
+#endif
+
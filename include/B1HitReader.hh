@@ -0,0 +1,113 @@
+#ifndef B1HitReader_h
+#define B1HitReader_h 1
+
+#include "B1HitFormat.hh"
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/// Memory-mapped reader of the hit stream files (see B1HitFormat).
+///
+/// The file is mapped read-only and the columns are used in place, so a
+/// sequential scan runs at the speed of the page cache or of the disk and
+/// reading a single event only touches the pages it lies in. Events are
+/// found by a binary search of the sorted event table of the footer; within
+/// an event the hits are ordered by plane.
+///
+/// No Geant4 or ROOT dependency: it is built as the eblhits library, for
+/// use from compiled analyses or from ROOT macros (e.g. make_plots.cxx).
+///
+///    B1HitReader r;
+///    if( !r.Open("EBL_hits_5_t0.bin") ) std::cerr << r.GetError();
+///    B1HitReader::Hits ev = r.GetEvent(1234);
+///    for(std::size_t i = 0; i < ev.n; i++) h->Fill(ev.x[i], ev.ekin[i]);
+
+class B1HitReader
+{
+   public:
+      /// Columns of n consecutive hits, pointing into the mapped file
+      struct Hits {
+         std::size_t          n;
+         const std::int32_t * event;
+         const std::int32_t * plane;
+         const std::int32_t * pdg;
+         const float        * x;
+         const float        * y;
+         const float        * px;
+         const float        * py;
+         const float        * pz;
+         const float        * ekin;
+         const float        * edep;
+
+         Hits Sub(std::size_t first, std::size_t count) const;
+      };
+
+   public:
+      B1HitReader();
+      ~B1HitReader();
+
+      B1HitReader(const B1HitReader&) = delete;
+      B1HitReader& operator=(const B1HitReader&) = delete;
+
+      /// Map the file and check that the index only points inside it;
+      /// false (see GetError) for a truncated or corrupt file
+      bool Open(const std::string& path);
+      void Close();
+      bool IsOpen() const { return fData != 0; }
+
+      /// Hint the kernel for a full scan (read ahead) or for random access
+      void AdviseSequential(bool sequential);
+
+      const std::string& GetError() const { return fError; }
+
+      std::size_t    GetFileSize()         const { return fSize; }
+      std::uint64_t  GetNumberOfHits()     const { return fTrailer.nhits; }
+      std::size_t    GetNumberOfBlocks()   const { return fTrailer.nblocks; }
+      std::int64_t   GetFirstEvent()       const { return fTrailer.firstEvent; }
+      std::int64_t   GetLastEvent()        const { return fTrailer.nevents ? fEvents[fTrailer.nevents-1].event : -1; }
+      /// Number of events with hits in the file
+      std::size_t    GetNumberOfEvents()   const { return fTrailer.nevents; }
+
+      const B1HitFormat::BlockIndex& GetBlockIndex(std::size_t iblock) const { return fBlocks[iblock]; }
+
+      /// All hits of a block
+      Hits GetBlock(std::size_t iblock) const;
+
+      /// All hits of an event (n = 0 if it has none or is not in the file)
+      Hits GetEvent(std::int64_t event) const;
+
+      /// Hits of an event in one plane
+      Hits GetEvent(std::int64_t event, std::int32_t plane) const;
+
+      /// Call f(const Hits&) for every block that may contain hits of plane
+      /// (every block if plane < 0). The hits still have to be selected on
+      /// hits.plane[i].
+      template<class F> void ForEachBlock(F f, std::int32_t plane = -1) const;
+
+   private:
+      bool Fail(const std::string& msg);
+
+   private:
+      int                                 fFd;
+      const char                        * fData;
+      std::size_t                         fSize;
+      B1HitFormat::Trailer                fTrailer;
+      const B1HitFormat::BlockIndex     * fBlocks;
+      const B1HitFormat::EventEntry     * fEvents;
+      std::string                         fError;
+};
+
+//______________________________________________________________________________
+
+template<class F>
+void B1HitReader::ForEachBlock(F f, std::int32_t plane) const
+{
+   for(std::size_t i = 0; i < GetNumberOfBlocks(); i++) {
+      const B1HitFormat::BlockIndex& b = fBlocks[i];
+      if( plane >= 0 && (plane < b.planeMin || plane > b.planeMax) ) continue;
+      f(GetBlock(i));
+   }
+}
+
+#endif
+
@@ -0,0 +1,90 @@
+#ifndef B1HitStream_h
+#define B1HitStream_h 1
+
+#include "globals.hh"
+#include "B1HitWriter.hh"
+#include <vector>
+
+/// Optional hit-level output of the scoring planes.
+///
+/// Each thread keeps its hits in a structure-of-arrays buffer (one vector
+/// per column of B1HitFormat). At the end of an event its hits are ordered
+/// by plane and, once the buffer holds at least the block size, the buffer
+/// is written out as one block by a B1HitWriter, so blocks only contain
+/// whole events. Each thread writes its own file, EBL_hits_<run>.bin
+/// (sequential) or EBL_hits_<run>_t<thread>.bin, which is only created when
+/// the thread records a hit.
+
+class B1HitStream
+{
+   public:
+      static B1HitStream * Instance();
+
+      static void   SetEnabled(G4bool v)       { fgEnabled = v; }
+      static G4bool IsEnabled()                { return fgEnabled; }
+      static void   SetBlockSize(G4int n)      { fgBlockSize = n; }
+      static G4int  GetBlockSize()             { return fgBlockSize; }
+
+      /// Start a run: the file is opened with the first block
+      void BeginOfRun(G4int runNumber);
+      void EndOfRun();
+
+      void BeginOfEvent(G4int eventID);
+      void EndOfEvent();
+
+      inline void Add(G4int plane, G4int pdg, G4double x, G4double y,
+                      G4double px, G4double py, G4double pz,
+                      G4double ekin, G4double edep);
+
+   private:
+      B1HitStream();
+
+      void Flush();
+      void SortEventByPlane();
+
+      template<class T> static void Permute(std::vector<T>& v, std::size_t first,
+                                            const std::vector<std::size_t>& order);
+
+   private:
+      static G4bool                     fgEnabled;
+      static G4int                      fgBlockSize;
+      static G4ThreadLocal B1HitStream * fgInstance;
+
+      B1HitWriter            fWriter;
+      G4String               fPath;
+      G4int                  fEventID;
+      std::size_t            fEventStart;     // first hit of the current event
+      std::vector<std::size_t> fOrder;
+
+      std::vector<G4int>     fEvent;
+      std::vector<G4int>     fPlane;
+      std::vector<G4int>     fPdg;
+      std::vector<float>     fX;
+      std::vector<float>     fY;
+      std::vector<float>     fPx;
+      std::vector<float>     fPy;
+      std::vector<float>     fPz;
+      std::vector<float>     fEkin;
+      std::vector<float>     fEdep;
+};
+
+//______________________________________________________________________________
+
+inline void B1HitStream::Add(G4int plane, G4int pdg, G4double x, G4double y,
+                             G4double px, G4double py, G4double pz,
+                             G4double ekin, G4double edep)
+{
+   fEvent.push_back(fEventID);
+   fPlane.push_back(plane);
+   fPdg.push_back(pdg);
+   fX.push_back(x);
+   fY.push_back(y);
+   fPx.push_back(px);
+   fPy.push_back(py);
+   fPz.push_back(pz);
+   fEkin.push_back(ekin);
+   fEdep.push_back(edep);
+}
+
+#endif
+
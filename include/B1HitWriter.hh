@@ -0,0 +1,54 @@
+#ifndef B1HitWriter_h
+#define B1HitWriter_h 1
+
+#include "globals.hh"
+#include "B1HitFormat.hh"
+#include <cstdio>
+#include <vector>
+
+/// Buffered binary writer for the hit stream (see B1HitFormat).
+///
+/// A block is written with one fwrite per column through a large stdio
+/// buffer. The block and event index is kept in memory and written as the
+/// footer when the file is closed. The file is written under a temporary
+/// name and renamed when it is closed, so a file with the final name is
+/// always complete and indexed.
+
+class B1HitWriter
+{
+   public:
+      B1HitWriter();
+      ~B1HitWriter();
+
+      G4bool Open(const G4String& path, std::size_t bufferSize = 8 << 20);
+      G4bool IsOpen() const { return fFile != 0; }
+
+      /// Write a block of nhits hits. columns[c] points to nhits values of
+      /// column c. The hits of an event must be contiguous and in a single
+      /// block, and events must come in increasing order.
+      void WriteBlock(std::uint32_t nhits, const void * const * columns);
+
+      void Close();
+
+      std::uint64_t GetBytesWritten() const { return fBytes; }
+      std::uint64_t GetHitsWritten()  const { return fHits; }
+
+   private:
+      void Write(const void * data, std::size_t size);
+      void Pad(std::size_t alignment);
+      void WriteIndex();
+
+   private:
+      std::FILE          * fFile;
+      G4String             fPath;
+      std::vector<char>    fBuffer;
+      std::uint64_t        fBytes;
+      std::uint64_t        fHits;
+      G4bool               fError;
+
+      std::vector<B1HitFormat::BlockIndex>  fBlocks;
+      std::vector<B1HitFormat::EventEntry>  fEvents;
+};
+
+#endif
+
@@ -0,0 +1,59 @@
+#ifndef B1MaterialRegistry_h
+#define B1MaterialRegistry_h 1
+
+#include "globals.hh"
+#include <map>
+
+class G4Material;
+class G4Element;
+class G4MaterialPropertiesTable;
+
+/// Build-once registry of the materials used by the detector.
+///
+/// Each material, element and optical property table is created the first
+/// time it is requested and the same instance is returned afterwards, so
+/// rebuilding or re-instantiating the detector never grows the global
+/// material table. Materials already in the table (e.g. loaded from a
+/// geometry snapshot) are reused rather than built again.
+///
+/// Known materials: any NIST name (G4_...), "beampipe_mat" (beam vacuum),
+/// "Scintillator" (radiator, with its optical properties) and "DC_gas"
+/// (drift chamber Ar/CO2).
+///
+/// The registry is not locked: it is only used on the master thread
+/// (detector construction and UI commands), where the shared material and
+/// element tables are filled before the workers start.
+
+class B1MaterialRegistry
+{
+   public:
+      static B1MaterialRegistry * Instance();
+
+      /// Cached material, built on first use. Returns null for an unknown name.
+      G4Material * GetMaterial(const G4String& name);
+
+      /// Cached element by name: "Hydrogen", "Carbon", "Argon".
+      G4Element  * GetElement(const G4String& name);
+
+      /// Number of materials in the global G4Material table
+      static std::size_t GetTableSize();
+
+      void Print() const;
+
+   private:
+      B1MaterialRegistry();
+      ~B1MaterialRegistry();
+
+      G4Material                * BuildMaterial(const G4String& name);
+      G4MaterialPropertiesTable * BuildScintillatorMPT();
+
+   private:
+      std::map<G4String, G4Material*> fMaterials;
+      std::map<G4String, G4Element*>  fElements;
+      G4int                           fNBuilt;
+      G4int                           fNMPTs;
+      G4long                          fNRequests;
+};
+
+#endif
+
@@ -0,0 +1,43 @@
+#ifndef B1MeshFormat_h
+#define B1MeshFormat_h 1
+
+#include <cstdint>
+
+/// On-disk layout of the sparse mesh files (EBL_mesh_*.bin).
+///
+///    FileHeader
+///    Voxel [nvoxels]          only the voxels that were scored
+///
+/// Voxel (ix, iy, iz) spans [ix*binSize[0], (ix+1)*binSize[0]) in x, and
+/// likewise in y and z, in the world frame. The voxels are ordered by iz,
+/// then iy, then ix. edep is the deposited energy and length the summed
+/// track length of all particles, so the fluence is length divided by the
+/// voxel volume.
+///
+/// Values are little-endian, lengths in mm, energies in MeV. This header
+/// has no Geant4 dependency so that analysis code can use it.
+
+namespace B1MeshFormat
+{
+   const char          kMagic[8] = {'E','B','L','M','E','S','H','\0'};
+   const std::uint32_t kVersion  = 1;
+
+   struct FileHeader {
+      char          magic[8];
+      std::uint32_t version;
+      std::uint32_t reserved;
+      double        binSize[3];
+      std::uint64_t nvoxels;
+      std::uint64_t nevents;
+   };
+
+   struct Voxel {
+      std::int32_t  ix, iy, iz;
+      std::int32_t  reserved;
+      double        edep;
+      double        length;
+   };
+}
+
+#endif
+
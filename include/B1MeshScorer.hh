@@ -0,0 +1,97 @@
+#ifndef B1MeshScorer_h
+#define B1MeshScorer_h 1
+
+#include "globals.hh"
+#include "G4Step.hh"
+#include "B1VoxelHash.hh"
+#include "B1SteppingPlugin.hh"
+#include <vector>
+
+class G4Region;
+
+/// Sparse 3D mesh of the energy deposit and track length (fluence) in the
+/// scored regions (by default Radiator and Chamber).
+///
+/// Each thread sums into its own B1VoxelHash, so only the voxels that are
+/// reached cost memory, which matters in a 10 m world that is mostly empty.
+/// A step is walked through the voxels along its chord and its length and
+/// deposit are shared in proportion; a step inside one voxel is a single
+/// lookup. At the end of the run every thread adds its table into a shared
+/// one under a lock, and the master writes it to EBL_mesh_<run>.bin (see
+/// B1MeshFormat) with the memory used against a dense 1 mm mesh. Only the
+/// steps in the volumes of the scored regions are given to the scorer (see
+/// B1SteppingAction).
+
+class B1MeshScorer : public B1SteppingPlugin
+{
+   public:
+      static B1MeshScorer * Instance();
+
+      static void     SetEnabled(G4bool v)               { fgEnabled = v; }
+      static G4bool   IsEnabled()                        { return fgEnabled; }
+      static void     SetBinSize(G4double l)             { fgBinSize = l; }
+      static G4double GetBinSize()                       { return fgBinSize; }
+      static void     SetRegions(const G4String& names)  { fgRegionNames = names; }
+
+      void BeginOfRun();
+
+      /// Add this thread's voxels to the shared table
+      void EndOfRun();
+
+      /// Write the shared table (master, after the workers' EndOfRun)
+      static void Write(G4int runNumber, G4int nevents);
+
+      inline void Score(const G4Step * step);
+
+      /// Stepping plugin: the logical volumes of the scored regions
+      virtual G4bool Select(std::vector<const G4LogicalVolume*>& volumes,
+                            std::vector<const G4ParticleDefinition*>& particles);
+      virtual void   Step(const G4Step * step) { Score(step); }
+
+   private:
+      B1MeshScorer();
+
+      void Deposit(const G4ThreeVector& p1, const G4ThreeVector& p2, G4double edep, G4double length);
+      inline void Add(const G4int i[3], G4double edep, G4double length);
+
+   private:
+      static G4bool                      fgEnabled;
+      static G4double                    fgBinSize;
+      static G4String                    fgRegionNames;
+      static B1VoxelHash               * fgMerged;
+      static std::size_t                 fgPeakMemory;   // largest thread table
+      static G4ThreadLocal B1MeshScorer * fgInstance;
+
+      B1VoxelHash                     fTable;
+      std::vector<const G4Region*>    fRegions;
+      G4double                        fInv;            // inverse bin size
+      G4long                          fOutside;        // voxels beyond the index range
+};
+
+//______________________________________________________________________________
+
+inline void B1MeshScorer::Score(const G4Step * step)
+{
+   const G4StepPoint * pre = step->GetPreStepPoint();
+   G4double length = step->GetStepLength();
+   G4double edep   = step->GetTotalEnergyDeposit();
+   if( length <= 0.0 && edep <= 0.0 ) return;
+
+   Deposit(pre->GetPosition(), step->GetPostStepPoint()->GetPosition(), edep, length);
+}
+//______________________________________________________________________________
+
+inline void B1MeshScorer::Add(const G4int i[3], G4double edep, G4double length)
+{
+   std::uint64_t key;
+   if( !B1VoxelHash::Key(i[0], i[1], i[2], key) ) {
+      fOutside++;
+      return;
+   }
+   B1VoxelHash::Entry& e = fTable.Get(key);
+   e.edep   += edep;
+   e.length += length;
+}
+
+#endif
+
@@ -0,0 +1,82 @@
+#ifndef B1NavigationBenchmark_h
+#define B1NavigationBenchmark_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include <map>
+#include <vector>
+
+class G4VPhysicalVolume;
+class G4LogicalVolume;
+class G4Navigator;
+
+/// Geometry-only navigation benchmark.
+///
+/// Geantino-like straight tracks are stepped from boundary to boundary with
+/// a G4Navigator in the mass world and, optionally, a second navigator in a
+/// parallel world (as G4PathFinder does during tracking). No physics is
+/// involved, so the timing is that of the geometry alone.
+///
+/// Source patterns:
+///  - pencil : start points uniform in a square spot, direction +z
+///  - cone   : start points uniform in a square spot, directions uniform
+///             inside a cone around +z
+///  - iso    : start points uniform in a square spot, isotropic directions
+///  - grid   : start points on a regular grid over the spot, direction +z
+
+class B1NavigationBenchmark
+{
+   public:
+      enum Pattern { kPencil = 0, kCone, kIsotropic, kGrid };
+
+      struct VolumeStat {
+         G4long   steps;
+         G4double time;     // seconds spent in ComputeStep + Locate
+      };
+
+      struct Result {
+         G4long   tracks;
+         G4long   steps;
+         G4double totalTime;       // seconds
+         G4double massTime;        // seconds in the mass world navigator
+         G4double parallelTime;    // seconds in the parallel world navigator
+         std::map<const G4LogicalVolume*, VolumeStat> volumes;
+      };
+
+   public:
+      B1NavigationBenchmark(G4VPhysicalVolume * massWorld, G4VPhysicalVolume * parallelWorld = 0);
+      ~B1NavigationBenchmark();
+
+      void SetPattern(G4int p)                    { fPattern    = p; }
+      void SetNumberOfTracks(G4int n)             { fNTracks    = n; }
+      void SetOrigin(const G4ThreeVector& o)      { fOrigin     = o; }
+      void SetSpotHalfWidth(G4double w)           { fSpot       = w; }
+      void SetConeHalfAngle(G4double a)           { fConeAngle  = a; }
+      void SetMaxSteps(G4int n)                   { fMaxSteps   = n; }
+      void SetSeed(G4long s)                      { fSeed       = s; }
+
+      static G4int PatternFromName(const G4String& name);
+
+      /// Navigate all tracks and return the accumulated timing.
+      Result Run();
+
+      static void Print(const Result& r);
+
+   private:
+      void GenerateTracks(std::vector<G4ThreeVector>& pos, std::vector<G4ThreeVector>& dir) const;
+
+   private:
+      G4Navigator * fMassNavigator;
+      G4Navigator * fParallelNavigator;
+
+      G4int         fPattern;
+      G4int         fNTracks;
+      G4ThreeVector fOrigin;
+      G4double      fSpot;
+      G4double      fConeAngle;
+      G4int         fMaxSteps;
+      G4long        fSeed;
+};
+
+#endif
+
@@ -0,0 +1,96 @@
+#ifndef B1OverlapChecker_h
+#define B1OverlapChecker_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4AffineTransform.hh"
+#include <vector>
+
+class G4LogicalVolume;
+class G4VSolid;
+
+/// Multi-threaded overlap check of the daughters of a set of mother volumes.
+///
+/// As in G4PVPlacement::CheckOverlaps, points are sampled on the surface of
+/// each daughter and tested against the mother (protrusions) and against the
+/// siblings whose bounding boxes intersect (overlaps). Parameterised volumes
+/// are expanded into one instance per copy. The sibling pairs are found by
+/// sorting the bounding boxes along the axis where they are most spread
+/// out and sweeping, not by testing every pair. The daughters are shared
+/// out between threads, and the check (the pair search included) stops
+/// early when the time or the point budget is exhausted.
+///
+/// Surface points of boxes are generated with a private generator per
+/// thread. Other solids use GetPointOnSurface, which draws from the Geant4
+/// engine of the calling thread (thread-local in multi-threaded builds,
+/// where it is seeded per thread; a sequential build checks on one thread).
+
+class B1OverlapChecker
+{
+   public:
+      struct Overlap {
+         G4String      volume;
+         G4int         copyNo;
+         G4String      other;         // mother name for a protrusion
+         G4int         otherCopyNo;   // -1 for a protrusion
+         G4double      depth;
+         G4ThreeVector point;         // in the mother frame
+      };
+
+      struct Result {
+         G4int    volumes;       // daughter instances to check
+         G4int    checked;       // instances fully checked
+         G4long   points;
+         G4double time;          // seconds
+         G4bool   truncated;     // a budget was hit
+         std::vector<Overlap> overlaps;   // worst first
+      };
+
+   public:
+      B1OverlapChecker();
+      ~B1OverlapChecker();
+
+      void SetNumberOfThreads(G4int n)   { fNThreads     = n; }
+      void SetPointsPerVolume(G4int n)   { fNPoints      = n; }
+      void SetTimeBudget(G4double s)     { fTimeBudget   = s; }
+      void SetPointBudget(G4long n)      { fPointBudget  = n; }
+      void SetTolerance(G4double t)      { fTolerance    = t; }
+      void SetSeed(G4long s)             { fSeed         = s; }
+
+      /// Check the daughters of each mother. The geometry must not be
+      /// modified while the check runs.
+      Result Check(const std::vector<G4LogicalVolume*>& mothers);
+
+      static void Print(const Result& r, G4int nmax = 20);
+
+   private:
+      struct Instance {
+         G4String            name;
+         G4int               copyNo;
+         G4int               mother;
+         const G4VSolid    * solid;
+         G4VSolid          * owned;       // clone of a parameterised copy
+         G4AffineTransform   toMother;
+         G4AffineTransform   fromMother;
+         G4ThreeVector       bmin, bmax;  // bounding box in the mother frame
+         std::vector<G4int>  neighbours;
+      };
+
+      /// False if the time budget ran out in the pair search
+      G4bool BuildInstances(const std::vector<G4LogicalVolume*>& mothers);
+      void ClearInstances();
+
+   private:
+      G4int     fNThreads;
+      G4int     fNPoints;
+      G4double  fTimeBudget;
+      G4long    fPointBudget;
+      G4double  fTolerance;
+      G4long    fSeed;
+
+      std::vector<G4LogicalVolume*> fMothers;
+      std::vector<Instance>         fInstances;
+};
+
+#endif
+
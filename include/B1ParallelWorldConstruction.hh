@@ -2,15 +2,16 @@
 #define B1ParallelWorldConstruction_h 1
 
 #include "globals.hh"
-#include <array>
+#include <vector>
 
 class G4VPhysicalVolume;
 class G4LogicalVolume;
-class B1DetectorMessenger;
 class G4Material;
 class G4VSolid;
 class FakeSD;
 class G4VisAttributes;
+class B1PlaneParameterisation;
+class B1ParallelWorldMessenger;
 #include "G4ThreeVector.hh"
 #include "G4String.hh"
 #include "G4VUserParallelWorld.hh"
@@ -19,7 +20,18 @@ class G4VisAttributes;
 /// A parallel world construction class
 ///
 /// - void Construct()
-///     creates a parallel world in the mass world and parameterized volumes
+///     creates the scoring planes in the parallel world: fNplanes thin
+///     discs spread over fSpanDistance, as the copies of a single
+///     parameterised volume
+/// - void ConstructSD()
+///     attaches one FakeSD (per thread) to all the planes; it dispatches
+///     the hits on the copy number
+///
+/// The number of planes is set at run time (/B1/planes/setNumberOfPlanes)
+/// and the geometry, sensitive detector and registration cost do not grow
+/// with it. Only the planes listed with /B1/planes/setHistogramPlanes get
+/// the full set of histograms (by default all of them up to 10 planes, or
+/// 10 evenly spaced planes).
 //
 class B1ParallelWorldConstruction : public G4VUserParallelWorld
 {
@@ -31,13 +43,18 @@ class B1ParallelWorldConstruction : public G4VUserParallelWorld
       G4ThreeVector fStartingPoint;
       double        fDet_size;
 
-      static const int fNplanes = 10;
-      std::array< G4ThreeVector      , fNplanes > fDet_pos   ;
-      std::array< G4VSolid          *, fNplanes > fDet_solid ;
-      std::array< G4LogicalVolume   *, fNplanes > fDet_log   ;
-      std::array< G4VPhysicalVolume *, fNplanes > fDet_phys  ;
-      std::array< FakeSD            *, fNplanes > fDet_det  ;
-      std::array< G4VisAttributes   *, fNplanes > fDet_vis  ;
+      G4int                fNplanes;
+      std::vector<G4int>   fHistogramPlanes;
+
+      G4VSolid                 * fDet_solid;
+      G4LogicalVolume          * fDet_log;
+      G4VPhysicalVolume        * fDet_phys;
+      B1PlaneParameterisation  * fDet_param;
+      G4VisAttributes          * fDet_vis;
+
+      B1ParallelWorldMessenger * fMessenger;
+
+      static const G4int fMaxDefaultHistogramPlanes = 10;
 
    public:
       B1ParallelWorldConstruction(G4String& parallelWorldName);
@@ -47,12 +64,25 @@ class B1ParallelWorldConstruction : public G4VUserParallelWorld
          fNeedsRebuilt = true;
          fSpanDistance = L;
       }
+      void SetNumberOfPlanes(G4int n);
+      void SetHistogramPlanes(const std::vector<G4int>& planes) { fHistogramPlanes = planes; }
+
+      G4int              GetNumberOfPlanes() const { return fNplanes; }
+      std::vector<G4int> GetHistogramPlanes() const;
+
+      /// Plane i is centred on GetStartingPoint() + i*GetPlaneStep() and is
+      /// normal to GetDirection(); used by the analytic plane scorer, which
+      /// does not need the parallel world to be registered.
+      G4ThreeVector      GetStartingPoint() const { return fStartingPoint; }
+      G4ThreeVector      GetDirection()     const { return fDirection; }
+      G4ThreeVector      GetPlaneStep()     const;
+      G4double           GetPlaneRadius()   const { return fDet_size/2.0; }
 
    public:
       virtual void Construct();
+      virtual void ConstructSD();
 
 
 };
 
 #endif
-
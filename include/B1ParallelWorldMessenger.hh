@@ -0,0 +1,38 @@
+#ifndef B1ParallelWorldMessenger_h
+#define B1ParallelWorldMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class B1ParallelWorldConstruction;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+
+/// Messenger class that defines commands for B1ParallelWorldConstruction.
+///
+/// It implements commands:
+/// - /B1/planes/setNumberOfPlanes n
+/// - /B1/planes/setHistogramPlanes "i j k ..."
+/// - /B1/planes/setSpanDistance value unit
+
+class B1ParallelWorldMessenger: public G4UImessenger
+{
+  public:
+    B1ParallelWorldMessenger(B1ParallelWorldConstruction* );
+    virtual ~B1ParallelWorldMessenger();
+    
+    virtual void SetNewValue(G4UIcommand*, G4String);
+    
+  private:
+    B1ParallelWorldConstruction*  fParallelWorld;
+
+    G4UIdirectory*           fPlanesDirectory;
+
+    G4UIcmdWithAnInteger      * fNumberOfPlanesCmd;
+    G4UIcmdWithAString        * fHistogramPlanesCmd;
+    G4UIcmdWithADoubleAndUnit * fSpanDistanceCmd;
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef B1ParameterSweep_h
+#define B1ParameterSweep_h 1
+
+#include "globals.hh"
+#include <vector>
+
+/// In-process parameter sweep driver.
+///
+/// The scan file holds one block per point: any number of UI commands
+/// (normally /B1/det/... settings) followed by a line "beamOn N".
+/// Blank lines and lines starting with '#' are ignored, e.g.
+///
+///    /B1/det/setCollimatorLength 10 cm
+///    beamOn 10000
+///    /B1/det/setCollimatorLength 20 cm
+///    beamOn 10000
+///
+/// Settings carry over from one point to the next. Each point is run with
+/// its own run number (first, first+1, ...), so each one writes its own
+/// output file. Physics tables are built once, and between points only the
+/// geometry touched by the settings is rebuilt.
+
+class B1ParameterSweep
+{
+   public:
+      struct Point {
+         std::vector<G4String> commands;
+         G4int                 events;
+      };
+
+   public:
+      B1ParameterSweep(G4int firstRunNumber = 0);
+      ~B1ParameterSweep();
+
+      /// Parse the scan file. Returns false if it cannot be read or a
+      /// beamOn line is malformed.
+      G4bool Read(const G4String& fileName);
+
+      /// Read the scan file and run all points.
+      G4bool Execute(const G4String& fileName);
+
+      const std::vector<Point>& GetPoints() const { return fPoints; }
+
+   private:
+      G4int              fFirstRunNumber;
+      std::vector<Point> fPoints;
+};
+
+#endif
+
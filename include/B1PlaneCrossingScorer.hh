@@ -0,0 +1,100 @@
+#ifndef B1PlaneCrossingScorer_h
+#define B1PlaneCrossingScorer_h 1
+
+#include "globals.hh"
+#include "G4Step.hh"
+#include "B1SteppingPlugin.hh"
+#include <vector>
+#include <algorithm>
+
+class B1ParallelWorldConstruction;
+class B1PlaneHistograms;
+class B1Run;
+
+/// Analytic scoring of the planes normal to z, without the parallel world.
+///
+/// The z positions of the planes are kept sorted and every step is checked
+/// from the stepping action: a plane is crossed when it lies between the
+/// pre- and post-step z (z1 < z <= z2 going forward, z2 <= z < z1 going
+/// backward), which costs one comparison when no plane is in range and one
+/// binary search otherwise. The crossing point is interpolated on the step
+/// chord and the kinetic energy over the continuous loss of the step, and
+/// the same histograms as FakeSD are filled (and the hit stream, if on).
+/// The steps come from B1SteppingAction, the scorer being a plugin for all
+/// the volumes.
+///
+/// With the parallel world switched off (ebl1 --scoring=analytic) the
+/// second navigator and G4ParallelWorldPhysics are not used at all. With
+/// --scoring=both the analytic histograms are booked as /zplanes/... and
+/// /zp<i>/... next to the parallel world ones, and the crossings per plane
+/// of both are compared at the end of the run.
+
+class B1PlaneCrossingScorer : public B1SteppingPlugin
+{
+   public:
+      static B1PlaneCrossingScorer * Instance();
+
+      static void   SetEnabled(G4bool v)    { fgEnabled = v; }
+      static G4bool IsEnabled()             { return fgEnabled; }
+      static void   SetValidation(G4bool v) { fgValidation = v; }
+      static G4bool IsValidation()          { return fgValidation; }
+
+      /// Book the histograms (once), from B1RunAction::BookHistograms
+      void Book(const B1ParallelWorldConstruction * planes);
+
+      /// Take the plane layout
+      void BeginOfRun(const B1ParallelWorldConstruction * planes);
+
+      /// In validation mode, add the crossings of both scorers to the run
+      void EndOfRun(B1Run * run);
+
+      /// Flush the per-event sums of the planes (see B1PlaneHistograms)
+      void EndOfEvent();
+
+      inline void Score(const G4Step * step);
+
+      /// Stepping plugin: every volume while on
+      virtual G4bool Select(std::vector<const G4LogicalVolume*>&,
+                            std::vector<const G4ParticleDefinition*>&) { return fgEnabled && fActive; }
+      virtual void   Step(const G4Step * step) { Score(step); }
+
+   private:
+      B1PlaneCrossingScorer();
+
+      void Cross(std::size_t i, const G4Step * step);
+
+   private:
+      static G4bool                               fgEnabled;
+      static G4bool                               fgValidation;
+      static G4ThreadLocal B1PlaneCrossingScorer * fgInstance;
+
+      G4bool                   fActive;
+      std::vector<G4double>    fZ;          // sorted plane positions
+      std::vector<G4int>       fPlane;      // plane number of fZ[i]
+      G4double                 fX0, fY0;    // centre of the planes
+      G4double                 fR2;         // squared radius of the planes
+      B1PlaneHistograms      * fHistograms;
+};
+
+//______________________________________________________________________________
+
+inline void B1PlaneCrossingScorer::Score(const G4Step * step)
+{
+   if( !fActive ) return;
+
+   G4double z1 = step->GetPreStepPoint()->GetPosition().z();
+   G4double z2 = step->GetPostStepPoint()->GetPosition().z();
+
+   if( z2 > z1 ) {
+      if( z2 < fZ.front() || z1 >= fZ.back() ) return;
+      std::size_t i = std::upper_bound(fZ.begin(), fZ.end(), z1) - fZ.begin();
+      for( ; i < fZ.size() && fZ[i] <= z2; i++) Cross(i, step);
+   } else if( z2 < z1 ) {
+      if( z1 <= fZ.front() || z2 > fZ.back() ) return;
+      std::size_t i = std::lower_bound(fZ.begin(), fZ.end(), z1) - fZ.begin();
+      for( ; i > 0 && fZ[i-1] >= z2; i--) Cross(i-1, step);
+   }
+}
+
+#endif
+
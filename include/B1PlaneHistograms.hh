@@ -0,0 +1,127 @@
+#ifndef B1PlaneHistograms_h
+#define B1PlaneHistograms_h 1
+
+#include "globals.hh"
+#include <vector>
+
+class B1HistogramStore;
+class B1ConvergenceMonitor;
+
+/// Histograms of the scoring plane crossings, booked in the calling
+/// thread's B1HistogramStore.
+///
+/// Every plane is counted in <dir>/crossings, <dir>/events (events with at
+/// least one crossing) and <dir>/ekin_vs_plane; the full set of histograms
+/// (<prefix><i>/...) is only booked for the planes given at construction.
+/// Filled by FakeSD (parallel world planes) and by B1PlaneCrossingScorer
+/// (analytic planes) with the same quantities.
+///
+/// The crossings are also summed per plane and species over the event and
+/// flushed once by EndOfEvent(), which fills the per-event observables of
+/// the full set: multiplicity (n_<species>, zero included) and summed
+/// kinetic energy (esum_<species>, events with a crossing) per event.
+/// Only the planes crossed in the event are visited.
+///
+/// One instance per thread (statistics = true) also feeds the
+/// B1ConvergenceMonitor of the thread.
+
+class B1PlaneHistograms
+{
+   public:
+      /// Species of the per-event sums
+      enum Species {
+         kGamma    = 0,
+         kElectron = 1,
+         kPositron = 2,
+         kNeutron  = 3,
+         kOther    = 4,
+         kNSpecies = 5
+      };
+
+      /// B1HistogramStore ids of the histograms of one plane
+      struct PlaneSet {
+         G4int  fPlane;
+
+         G4int  fhForward_0 ;
+         G4int  fhBackward_0;
+
+         G4int  fhXvsE_all ;
+         G4int  fhXvsE_gamma ;
+         G4int  fhXvsE_not_gamma ;
+         G4int  fhXvsE_n ;
+
+         G4int  fhXY0_all;
+         G4int  fhXY1_all;
+         G4int  fhXY2_all;
+
+         G4int  fhXY0_gamma;
+         G4int  fhXY1_gamma;
+         G4int  fhXY2_gamma;
+
+         G4int  fhN[kNSpecies];       // multiplicity per event
+         G4int  fhEsum[kNSpecies];    // summed kinetic energy per event
+      };
+
+   public:
+      B1PlaneHistograms(const G4String& dir, const G4String& prefix,
+                        G4int nplanes, const std::vector<G4int>& histogramPlanes,
+                        G4bool statistics);
+
+      /// One crossing of plane: x and y in cm, ekin in MeV. The sign of pz
+      /// selects the forward or backward histogram.
+      void Fill(G4int plane, G4int pdg, G4double x, G4double y, G4double pz, G4double ekin);
+
+      /// Flush the per-event sums into the histograms
+      void EndOfEvent();
+      /// Drop the per-event sums (aborted event)
+      void ClearEvent();
+
+      G4int GetNumberOfPlanes() const { return fNplanes; }
+
+      static inline G4int GetSpecies(G4int pdg);
+      static const char * GetSpeciesName(G4int species);
+
+      /// Crossings per plane since the last ResetCrossings()
+      const std::vector<G4long>& GetCrossings() const { return fCrossings; }
+      void ResetCrossings();
+
+   private:
+      /// Sums of one plane over the current event
+      struct EventSums {
+         G4int     total;
+         G4int     forward;          // pz >= 0, as forw0
+         G4int     n[kNSpecies];
+         G4double  esum[kNSpecies];
+      };
+
+      PlaneSet BookPlane(G4int plane, const G4String& name, G4double hist_Emax);
+
+   private:
+      B1HistogramStore       * fStore;
+      B1ConvergenceMonitor   * fMonitor;         // or 0
+      G4int                    fNplanes;
+      G4int                    fhCrossings;
+      G4int                    fhEkinVsPlane;
+      G4int                    fhEvents;
+      std::vector<G4int>       fSetOfPlane;      // index in fPlaneSets, or -1
+      std::vector<PlaneSet>    fPlaneSets;
+      std::vector<G4long>      fCrossings;
+      std::vector<EventSums>   fEventSums;       // per plane
+      std::vector<G4int>       fTouched;         // planes crossed in this event
+};
+
+//______________________________________________________________________________
+
+inline G4int B1PlaneHistograms::GetSpecies(G4int pdg)
+{
+   switch( pdg ) {
+      case 22   : return kGamma;
+      case 11   : return kElectron;
+      case -11  : return kPositron;
+      case 2112 : return kNeutron;
+      default   : return kOther;
+   }
+}
+
+#endif
+
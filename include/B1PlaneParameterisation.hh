@@ -0,0 +1,33 @@
+#ifndef B1PlaneParameterisation_h
+#define B1PlaneParameterisation_h 1
+
+#include "globals.hh"
+#include "G4VPVParameterisation.hh"
+#include "G4ThreeVector.hh"
+
+class G4VPhysicalVolume;
+
+/// Parameterisation of the parallel world scoring planes.
+///
+/// Plane i is the same (unrotated) solid placed at
+///   r_i = start + i*step
+/// so that any number of planes is a single physical volume.
+
+class B1PlaneParameterisation : public G4VPVParameterisation
+{
+   private:
+      G4int         fNPlanes;
+      G4ThreeVector fStart;
+      G4ThreeVector fStep;
+
+   public:
+      B1PlaneParameterisation(G4int nplanes, const G4ThreeVector& start, const G4ThreeVector& step);
+      virtual ~B1PlaneParameterisation();
+
+      G4int         GetNumberOfPlanes() const { return fNPlanes; }
+      G4ThreeVector GetPlanePosition(G4int copyNo) const { return fStart + copyNo*fStep; }
+
+      virtual void ComputeTransformation(const G4int copyNo, G4VPhysicalVolume* physVol) const;
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef B1ProgressReporter_h
+#define B1ProgressReporter_h 1
+
+#include "globals.hh"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class G4Run;
+
+/// Progress of the event loop, printed from a separate thread.
+///
+/// Each thread that processes events owns one counter, padded to its own
+/// cache lines, and counts its events with a relaxed atomic increment
+/// (Count(), from B1Run::RecordEvent); nothing else happens on the worker
+/// side. A reporter thread started by the master wakes up every interval of
+/// wall-clock time, samples the counters and prints the events done, the
+/// rate over the last interval, the estimated time left and the imbalance
+/// between the threads ((max - min)/mean of the per-thread events, with
+/// the slowest thread). An interval of 0 switches the reporter off.
+
+class B1ProgressReporter
+{
+   public:
+      /// Interval between two reports (G4 time units, 0 for none)
+      static void     SetInterval(G4double t) { fgInterval = t; }
+      static G4double GetInterval()           { return fgInterval; }
+
+      /// Master: reset the counters and start the reporter thread.
+      /// Every thread: pick its own counter.
+      static void BeginOfRun(const G4Run * run);
+      /// Master: stop the reporter thread
+      static void EndOfRun();
+
+      static inline void Count();
+
+   private:
+      struct Counter {
+         std::atomic<G4long>  n;
+         char                 pad[128 - sizeof(std::atomic<G4long>)];
+      };
+
+      static void Report();
+      /// Print one report, return the events done
+      static G4long Print(G4double elapsed, G4double interval, G4long last);
+
+   private:
+      static G4double                 fgInterval;
+      static G4long                   fgToBeProcessed;
+      static G4int                    fgNcounters;
+      static std::unique_ptr<Counter[]> fgCounters;
+      static std::thread              fgThread;
+      static std::mutex               fgMutex;
+      static std::condition_variable  fgWake;
+      static G4bool                   fgStop;
+      static G4ThreadLocal Counter  * fgCounter;
+};
+
+//______________________________________________________________________________
+
+inline void B1ProgressReporter::Count()
+{
+   if( fgCounter ) fgCounter->n.fetch_add(1, std::memory_order_relaxed);
+}
+
+#endif
+
@@ -3,15 +3,38 @@
 
 #include "G4Run.hh"
 #include "globals.hh"
+#include "B1Accumulators.hh"
+#include <vector>
 
 class G4Event;
+class G4Region;
+
+/// Run with the per-thread accumulators of the application (B1Accumulators).
+///
+/// Every thread registers the same accumulators in the constructor. The
+/// worker runs are not merged one by one into the master run (G4's Merge()
+/// is serialised on one lock): at the end of its run each worker enters a
+/// binary reduction tree with Reduce(), where the last of two siblings to
+/// arrive merges the other's accumulators into its own and goes up a level,
+/// so the threads merge in parallel and the depth is log2(threads). The
+/// master takes the result with Collect() in its EndOfRunAction.
 
 class B1Run : public G4Run
 {
    private:
       G4int     fRunNumber;
-      G4double  fEdep;
-      G4double  fEdep2;
+      B1Accumulators                  fAccumulators;
+      std::vector<const G4Region*>    fRegions;      // index in "secondaries"
+
+      // accumulator ids
+      G4int     fEdep;
+      G4int     fEventsWithEdep;
+      G4int     fSecondaries;
+      G4int     fParallelCrossings;
+      G4int     fAnalyticCrossings;
+      G4int     fOpticalPhotons;
+      G4int     fOpticalDropped;
+      G4int     fEventsOverBudget;
 
    public:
       B1Run(G4int rn = 0);
@@ -20,14 +43,57 @@ class B1Run : public G4Run
       virtual void Merge(const G4Run*);
       virtual void RecordEvent(const G4Event*);
 
+      /// Energy deposited in one event
       void AddEdep (G4double edep); 
 
+      /// Secondaries produced in steps that start in region
+      inline void AddSecondaries(const G4Region * region, G4long n);
+      G4int            GetNumberOfRegions() const { return fRegions.size(); }
+      const G4Region * GetRegion(G4int i) const   { return fRegions[i]; }
+      G4double         GetSecondaries(G4int i) const;
+
+      /// Crossings per plane of the parallel world planes and of the
+      /// analytic scorer, when both are on (--scoring=both)
+      void AddPlaneCrossings(const std::vector<G4long>& parallel, const std::vector<G4long>& analytic);
+      const std::vector<G4double>& GetParallelCrossings() const { return fAccumulators.GetArray(fParallelCrossings); }
+      const std::vector<G4double>& GetAnalyticCrossings() const { return fAccumulators.GetArray(fAnalyticCrossings); }
+
+      /// An optical photon under the stacking budget: stacked or dropped,
+      /// the first dropped one of its event
+      inline void AddOpticalPhoton(G4bool dropped, G4bool firstDropped);
+
       // get methods
-      G4double GetEdep()  const { return fEdep; }
-      G4double GetEdep2() const { return fEdep2; }
+      G4double GetEdep()  const { return fAccumulators.GetSum(fEdep); }
+      G4double GetEdep2() const { return fAccumulators.GetSum2(fEdep); }
+
+      B1Accumulators&       GetAccumulators()       { return fAccumulators; }
+      const B1Accumulators& GetAccumulators() const { return fAccumulators; }
+
+      /// Worker: hand this thread's accumulators to the reduction tree
+      void Reduce() const;
+      /// Master: take the reduced accumulators of all the workers
+      void Collect();
 
 };
 
+//______________________________________________________________________________
+
+inline void B1Run::AddSecondaries(const G4Region * region, G4long n)
+{
+   for(std::size_t i = 0; i < fRegions.size(); i++) {
+      if( fRegions[i] == region ) {
+         fAccumulators.Add(fSecondaries, i, n);
+         return;
+      }
+   }
+}
+//______________________________________________________________________________
+
+inline void B1Run::AddOpticalPhoton(G4bool dropped, G4bool firstDropped)
+{
+   fAccumulators.Count(dropped ? fOpticalDropped : fOpticalPhotons);
+   if( firstDropped ) fAccumulators.Count(fEventsOverBudget);
+}
 
 #endif
 
@@ -3,9 +3,15 @@
 
 #include "G4UserRunAction.hh"
 #include "globals.hh"
+#include "G4Timer.hh"
 
 class G4Run;
 class G4LogicalVolume;
+class B1RunMessenger;
+class B1StackingMessenger;
+class B1Run;
+class B1SteppingAction;
+class B1PlaneHistograms;
 
 
 /// Run action class
@@ -13,6 +19,10 @@ class G4LogicalVolume;
 /// In EndOfRunAction(), it calculates the dose in the selected volume 
 /// from the energy deposit accumulated via stepping and event actions.
 /// The computed dose is then printed on the screen.
+/// The master also prints the event rate and the number of secondaries
+/// produced in each region, and with --scoring=both the crossings per plane
+/// of the parallel world and analytic planes, and the run accumulators
+/// reduced over the workers (B1Run::Reduce, B1Run::Collect).
 
 class B1RunAction : public G4UserRunAction
 {
@@ -20,6 +30,13 @@ class B1RunAction : public G4UserRunAction
 
       G4int   fRunNumber;
 
+   private:
+      B1RunMessenger      * fMessenger;
+      B1StackingMessenger * fStackingMessenger;
+      G4Timer               fTimer;
+      B1SteppingAction    * fSteppingAction;   // worker, or 0
+      B1PlaneHistograms   * fPlaneHistograms;  // parallel world planes, or 0
+
    public:
       B1RunAction(G4int rn = 0);
       virtual ~B1RunAction();
@@ -28,6 +45,22 @@ class B1RunAction : public G4UserRunAction
       virtual void BeginOfRunAction(const G4Run*);
       virtual void   EndOfRunAction(const G4Run*);
 
+      void  SetRunNumber(G4int rn) { fRunNumber = rn; }
+      G4int GetRunNumber() const   { return fRunNumber; }
+
+      /// Stepping action whose dispatch table is rebuilt every run
+      void  SetSteppingAction(B1SteppingAction * sa) { fSteppingAction = sa; }
+
+   private:
+      /// Book the histograms of this thread on the first run. The analysis
+      /// managers are merged by histogram id, so the master and every worker
+      /// book the same histograms in the same order, here, before anything
+      /// else is booked.
+      void  BookHistograms();
+
+      /// Crossings per plane of the parallel world and analytic planes
+      void  PrintPlaneValidation(const B1Run * run) const;
+
 };
 
 #endif
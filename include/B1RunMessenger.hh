@@ -0,0 +1,65 @@
+#ifndef B1RunMessenger_h
+#define B1RunMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class B1RunAction;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithABool;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithADouble;
+
+/// Messenger class that defines commands for B1RunAction.
+///
+/// It implements commands:
+/// - /B1/run/setRunNumber n
+/// - /B1/run/sweep scanfile
+/// - /B1/run/benchmarkHistograms nfills
+/// - /B1/run/writeHits bool
+/// - /B1/run/hitBlockSize nhits
+/// - /B1/run/scoreMesh bool
+/// - /B1/run/meshBinSize value unit
+/// - /B1/run/meshRegions "Radiator Chamber"
+/// - /B1/run/targetPrecision rel
+/// - /B1/run/checkInterval nevents
+/// - /B1/run/ratioPlanes "num den"
+/// - /B1/run/progressInterval value unit
+/// - /B1/run/profileEvents bool
+/// - /B1/run/slowEvents n
+/// - /B1/run/profileSteps bool
+
+class B1RunMessenger: public G4UImessenger
+{
+  public:
+    B1RunMessenger(B1RunAction* );
+    virtual ~B1RunMessenger();
+    
+    virtual void SetNewValue(G4UIcommand*, G4String);
+    
+  private:
+    B1RunAction*             fRunAction;
+
+    G4UIdirectory*           fRunDirectory;
+
+    G4UIcmdWithAnInteger      * fRunNumberCmd;
+    G4UIcmdWithAString        * fSweepCmd;
+    G4UIcmdWithAnInteger      * fHistBenchCmd;
+    G4UIcmdWithABool          * fWriteHitsCmd;
+    G4UIcmdWithAnInteger      * fHitBlockSizeCmd;
+    G4UIcmdWithABool          * fScoreMeshCmd;
+    G4UIcmdWithADoubleAndUnit * fMeshBinSizeCmd;
+    G4UIcmdWithAString        * fMeshRegionsCmd;
+    G4UIcmdWithADouble        * fTargetPrecisionCmd;
+    G4UIcmdWithAnInteger      * fCheckIntervalCmd;
+    G4UIcmdWithAString        * fRatioPlanesCmd;
+    G4UIcmdWithADoubleAndUnit * fProgressIntervalCmd;
+    G4UIcmdWithABool          * fProfileEventsCmd;
+    G4UIcmdWithAnInteger      * fSlowEventsCmd;
+    G4UIcmdWithABool          * fProfileStepsCmd;
+};
+
+#endif
+
@@ -0,0 +1,51 @@
+#ifndef B1SolidBenchmark_h
+#define B1SolidBenchmark_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+class G4VSolid;
+
+/// Microbenchmark and cross-check of the navigation methods of a solid.
+///
+/// Points are sampled uniformly in the extent of the reference solid (with
+/// a small margin) and directions isotropically, using a private generator
+/// so that the simulation random number sequence is not touched.
+
+class B1SolidBenchmark
+{
+   public:
+      struct Rates {
+         G4double inside;        // Inside() calls per second
+         G4double distToIn;      // DistanceToIn(p,v) calls per second
+         G4double distToOut;     // DistanceToOut(p,v) calls per second
+      };
+
+      struct Comparison {
+         G4int    nPoints;
+         G4int    nInsideMismatch;
+         G4int    nDistMismatch;
+         G4double maxDistDiff;
+      };
+
+   public:
+      B1SolidBenchmark(G4int npoints = 100000, G4long seed = 12345);
+      ~B1SolidBenchmark();
+
+      /// Calls per second of Inside, DistanceToIn(p,v) and DistanceToOut(p,v).
+      /// The points are sampled in the frame of the solid.
+      Rates Benchmark(const G4VSolid * solid) const;
+
+      /// Compare a test solid against a reference solid. offset is the
+      /// position of the test solid's frame in the reference frame.
+      /// Distances that differ by more than tolerance are counted.
+      Comparison Compare(const G4VSolid * ref, const G4VSolid * test,
+                         const G4ThreeVector& offset, G4double tolerance) const;
+
+   private:
+      G4int   fNPoints;
+      G4long  fSeed;
+};
+
+#endif
+
@@ -0,0 +1,92 @@
+#ifndef B1StackingAction_h
+#define B1StackingAction_h 1
+
+#include "G4UserStackingAction.hh"
+#include "G4ClassificationOfNewTrack.hh"
+#include "globals.hh"
+#include <vector>
+#include <atomic>
+
+class G4Track;
+class G4LogicalVolume;
+class G4ParticleDefinition;
+class G4Navigator;
+class B1Run;
+
+/// Stacking action with classes per particle and origin volume, and a
+/// per-event budget of optical photons.
+///
+/// A rule gives the class of the new tracks of a particle ("all" for any)
+/// created in a logical volume ("all" for anywhere): kill, urgent,
+/// waiting (tracked once the urgent stack is empty) or postpone (to the
+/// next event). The last matching rule wins; without a match a track is
+/// urgent, as without a stacking action. Postponed tracks are urgent in
+/// the next event and do not count against its photon budget. The rules
+/// are shared by the threads and resolved to particle and volume pointers
+/// by each thread at the first event after they changed.
+///
+/// With a budget, the optical photons of an event beyond it are killed
+/// before they are tracked. Only the urgent and waiting photons count, the
+/// postponed ones being tracked in the next event. The photons stacked and
+/// dropped are counted in the run accumulators (B1Run), as are the
+/// secondaries per region of their vertex.
+
+class B1StackingAction : public G4UserStackingAction
+{
+   public:
+      enum Class {
+         kKill     = 0,
+         kUrgent   = 1,
+         kWaiting  = 2,
+         kPostpone = 3
+      };
+
+   public:
+      B1StackingAction();
+      virtual ~B1StackingAction();
+
+      /// Add a rule; false if the class is unknown
+      static G4bool AddRule(const G4String& particle, const G4String& volume, const G4String& cls);
+      static void   ClearRules();
+      static void   PrintRules();
+
+      /// Optical photons tracked per event, -1 for no budget
+      static void   SetOpticalPhotonBudget(G4long n) { fgOpticalBudget = n; }
+      static G4long GetOpticalPhotonBudget()         { return fgOpticalBudget; }
+
+      virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track);
+      virtual void                       PrepareNewEvent();
+
+   private:
+      struct Rule {
+         G4String  particle;
+         G4String  volume;
+         G4int     cls;
+      };
+
+      struct Resolved {
+         const G4ParticleDefinition * particle;   // 0 for all
+         const G4LogicalVolume      * volume;     // 0 for all
+         G4ClassificationOfNewTrack   cls;
+      };
+
+      void Resolve();
+      const G4LogicalVolume * OriginVolume(const G4Track* track);
+
+   private:
+      static std::vector<Rule>   fgRules;
+      static std::atomic<G4int>  fgVersion;        // of the rules, read unlocked
+      static std::atomic<G4long> fgOpticalBudget;
+
+      std::vector<Resolved>          fRules;
+      G4int                          fVersion;
+      G4bool                         fVolumeRules;
+      const G4ParticleDefinition   * fOpticalPhoton;
+      G4long                         fOpticalBudget;   // this event
+      G4long                         fOpticalPhotons;  // this event
+      B1Run                        * fRun;
+      G4Navigator                  * fNavigator;       // origin of tracks without a touchable
+};
+
+#endif
+
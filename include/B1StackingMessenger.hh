@@ -0,0 +1,40 @@
+#ifndef B1StackingMessenger_h
+#define B1StackingMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithoutParameter;
+
+/// Messenger class that defines commands for B1StackingAction.
+///
+/// It implements commands:
+/// - /B1/stack/setClass particle volume kill|urgent|waiting|postpone
+/// - /B1/stack/clearClasses
+/// - /B1/stack/opticalPhotonBudget n
+/// - /B1/stack/print
+///
+/// The settings are shared by the threads, so the commands are only
+/// executed on the master (which has no stacking action of its own).
+
+class B1StackingMessenger: public G4UImessenger
+{
+  public:
+    B1StackingMessenger();
+    virtual ~B1StackingMessenger();
+    
+    virtual void SetNewValue(G4UIcommand*, G4String);
+    
+  private:
+    G4UIdirectory*           fStackDirectory;
+
+    G4UIcommand               * fSetClassCmd;
+    G4UIcmdWithoutParameter   * fClearClassesCmd;
+    G4UIcmdWithAnInteger      * fOpticalBudgetCmd;
+    G4UIcmdWithoutParameter   * fPrintCmd;
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef B1StepProfiler_h
+#define B1StepProfiler_h 1
+
+#include "globals.hh"
+#include "G4Step.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4VProcess.hh"
+#include "B1SteppingPlugin.hh"
+#include <cstdint>
+#include <chrono>
+#include <unordered_map>
+#include <map>
+#include <string>
+#include <tuple>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/// Where the time goes: steps and wall time per (logical volume, particle,
+/// process that limited the step).
+///
+/// A stepping plugin for every step, registered first. Each step is
+/// charged with the time since the previous step of the thread (or since
+/// the start of the event), read from the time stamp counter: the
+/// transport and physics of the step, the scorers of the previous one and,
+/// for the first step of a track, the stacking and the track set-up. The
+/// counters are per thread, in a hash table keyed by the three pointers.
+/// At the end of the run the ticks are converted with the thread's own
+/// calibration against the steady clock and added by name into a shared
+/// table; the master prints the most expensive entries and writes them all
+/// to EBL_steps_<run>.csv.
+
+class B1StepProfiler : public B1SteppingPlugin
+{
+   public:
+      static B1StepProfiler * Instance();
+
+      static void   SetEnabled(G4bool v) { fgEnabled = v; }
+      static G4bool IsEnabled()          { return fgEnabled; }
+
+      void BeginOfRun();
+      void BeginOfEvent()                { fLast = Ticks(); }
+      /// Add this thread's counters to the shared table
+      void EndOfRun();
+      /// Print the shared table and write it (master)
+      static void Print(G4int runNumber);
+
+      virtual G4bool Select(std::vector<const G4LogicalVolume*>&,
+                            std::vector<const G4ParticleDefinition*>&) { return fgEnabled; }
+      virtual void   Step(const G4Step * step);
+
+   private:
+      struct Key {
+         const G4LogicalVolume       * volume;
+         const G4ParticleDefinition  * particle;
+         const G4VProcess            * process;
+         bool operator==(const Key& o) const {
+            return volume == o.volume && particle == o.particle && process == o.process;
+         }
+      };
+
+      struct KeyHash {
+         std::size_t operator()(const Key& k) const {
+            std::uintptr_t h = reinterpret_cast<std::uintptr_t>(k.volume);
+            h = h*0x9e3779b97f4a7c15ULL ^ reinterpret_cast<std::uintptr_t>(k.particle);
+            h = h*0x9e3779b97f4a7c15ULL ^ reinterpret_cast<std::uintptr_t>(k.process);
+            return h ^ (h >> 29);
+         }
+      };
+
+      struct Cell {
+         G4long         steps;
+         std::uint64_t  ticks;
+      };
+
+      /// Shared totals, by volume, particle and process names
+      struct Total {
+         G4long    steps;
+         G4double  seconds;
+      };
+      typedef std::tuple<std::string, std::string, std::string> Names;
+
+      B1StepProfiler();
+
+      static inline std::uint64_t Ticks();
+      static G4double Seconds();
+
+   private:
+      static G4bool                           fgEnabled;
+      static std::map<Names, Total>           fgTotals;
+      static G4ThreadLocal B1StepProfiler   * fgInstance;
+
+      std::unordered_map<Key, Cell, KeyHash>  fCells;
+      std::uint64_t                           fLast;
+      std::uint64_t                           fTicks0;
+      G4double                                fSeconds0;
+};
+
+//______________________________________________________________________________
+
+inline std::uint64_t B1StepProfiler::Ticks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+   return __rdtsc();
+#else
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+//______________________________________________________________________________
+
+inline void B1StepProfiler::Step(const G4Step * step)
+{
+   std::uint64_t now = Ticks();
+   Key key;
+   key.volume   = step->GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume();
+   key.particle = step->GetTrack()->GetDefinition();
+   key.process  = step->GetPostStepPoint()->GetProcessDefinedStep();
+   Cell& c = fCells[key];
+   c.steps++;
+   c.ticks += now - fLast;
+   fLast = now;
+}
+
+#endif
+
@@ -2,11 +2,27 @@
 #define B1SteppingAction_h 1
 
 #include "G4UserSteppingAction.hh"
+#include "G4Step.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4ParticleDefinition.hh"
 #include "globals.hh"
+#include "B1SteppingPlugin.hh"
+#include <vector>
 
 class B1EventAction;
 
-class G4LogicalVolume;
+/// Stepping action dispatching the steps to B1SteppingPlugin scorers.
+///
+/// The scorers of the application (step and event profilers, analytic
+/// planes, mesh) are taken at the beginning of each run when they are
+/// switched on, so a disabled scorer is never instantiated; other plugins
+/// (the scoring volume deposit) are registered once. BeginOfRun() asks
+/// each plugin for its volumes and particles and builds a table
+/// indexed by the instance id of the logical volumes, holding for each
+/// volume the list of plugins to call (with their particle mask), or
+/// nothing. A step in a volume without plugins costs the volume lookup and
+/// one indexed load.
 
 class B1SteppingAction : public G4UserSteppingAction
 {
@@ -14,13 +30,49 @@ class B1SteppingAction : public G4UserSteppingAction
     B1SteppingAction(B1EventAction* eventAction);
     virtual ~B1SteppingAction();
 
+    /// Add a plugin, called after the scorers of the application and
+    /// deleted with the action if owned
+    void Register(B1SteppingPlugin * plugin, G4bool owned);
+
+    /// Build the dispatch table (every thread, from B1RunAction)
+    void BeginOfRun();
+
     // method from the base class
     virtual void UserSteppingAction(const G4Step*);
 
   private:
-    B1EventAction*  fEventAction;
-    G4LogicalVolume* fScoringVolume;
+    struct Entry {
+      B1SteppingPlugin*          plugin;
+      const std::vector<char>*   particles;   // by particle definition id, or 0 for all
+    };
+    typedef std::vector<Entry> Dispatch;
+
+  private:
+    B1EventAction*                    fEventAction;
+    std::vector<B1SteppingPlugin*>    fPlugins;
+    std::vector<B1SteppingPlugin*>    fOwned;
+    std::vector<Dispatch*>            fTable;       // by logical volume instance id
+    std::vector<Dispatch*>            fDispatches;  // distinct lists of fTable
+    std::vector< std::vector<char> >  fParticles;   // particle masks of the plugins
 };
 
-#endif
+//___________________________________________________________________
 
+inline void B1SteppingAction::UserSteppingAction(const G4Step* step)
+{
+  std::size_t id = step->GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume()->GetInstanceID();
+  if (id >= fTable.size()) return;
+  const Dispatch* dispatch = fTable[id];
+  if (!dispatch) return;
+
+  G4int pid = -1;
+  for (const Entry& e : *dispatch) {
+    if (e.particles) {
+      if (pid < 0) pid = step->GetTrack()->GetDefinition()->GetParticleDefinitionID();
+      if (std::size_t(pid) >= e.particles->size() || !(*e.particles)[pid]) continue;
+    }
+    e.plugin->Step(step);
+  }
+}
+
+#endif
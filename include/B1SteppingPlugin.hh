@@ -0,0 +1,31 @@
+#ifndef B1SteppingPlugin_h
+#define B1SteppingPlugin_h 1
+
+#include "globals.hh"
+#include <vector>
+
+class G4Step;
+class G4LogicalVolume;
+class G4ParticleDefinition;
+
+/// A scorer called by B1SteppingAction for the steps it asked for.
+///
+/// At the beginning of every run, on each thread, Select() says whether
+/// the plugin scores the run and for which logical volumes and particles
+/// (no volume: all of them, no particle: all of them). B1SteppingAction
+/// builds its per-volume dispatch table from the answers, and Step() is
+/// then only called for the selected steps, in the order of registration.
+
+class B1SteppingPlugin
+{
+   public:
+      virtual ~B1SteppingPlugin() { }
+
+      virtual G4bool Select(std::vector<const G4LogicalVolume*>& volumes,
+                            std::vector<const G4ParticleDefinition*>& particles) = 0;
+
+      virtual void Step(const G4Step * step) = 0;
+};
+
+#endif
+
@@ -0,0 +1,112 @@
+#ifndef B1VoxelHash_h
+#define B1VoxelHash_h 1
+
+#include "globals.hh"
+#include <vector>
+#include <cstdint>
+
+/// Open-addressing hash table of voxel sums, keyed by the packed voxel
+/// indices.
+///
+/// The table is a flat array of entries with linear probing and a
+/// power-of-two capacity kept at most half full, so a lookup is a hash, a
+/// mask and usually one or two compares, and the memory only grows with the
+/// number of voxels actually scored. Each index is stored on 21 bits
+/// (|i| < 2^20); Key() rejects voxels outside that range.
+
+class B1VoxelHash
+{
+   public:
+      struct Entry {
+         std::uint64_t key;
+         G4double      edep;
+         G4double      length;
+      };
+
+      static const std::uint64_t kEmpty = ~std::uint64_t(0);
+
+   public:
+      B1VoxelHash(std::size_t capacity = 1 << 16);
+
+      static inline G4bool Key(G4int ix, G4int iy, G4int iz, std::uint64_t& key);
+      static inline void   Index(std::uint64_t key, G4int& ix, G4int& iy, G4int& iz);
+
+      /// The entry of key, inserted with zero sums if it is new
+      inline Entry& Get(std::uint64_t key);
+
+      /// Add the sums of other
+      void Merge(const B1VoxelHash& other);
+      void Clear();
+
+      std::size_t GetSize()     const { return fSize; }
+      std::size_t GetCapacity() const { return fEntries.size(); }
+      std::size_t GetMemory()   const { return fEntries.size()*sizeof(Entry); }
+
+      /// All slots; the unused ones have key == kEmpty
+      const std::vector<Entry>& GetEntries() const { return fEntries; }
+
+   private:
+      static inline std::uint64_t Hash(std::uint64_t key);
+      void Grow();
+
+   private:
+      std::vector<Entry>  fEntries;
+      std::size_t         fSize;
+      std::size_t         fMask;
+};
+
+//______________________________________________________________________________
+
+inline G4bool B1VoxelHash::Key(G4int ix, G4int iy, G4int iz, std::uint64_t& key)
+{
+   const G4int kMax = 1 << 20;
+   if( ix < -kMax || ix >= kMax || iy < -kMax || iy >= kMax || iz < -kMax || iz >= kMax ) return false;
+   // z major, so that sorted keys are sorted by iz, iy, ix
+   key = (std::uint64_t(iz + kMax) << 42) | (std::uint64_t(iy + kMax) << 21) | std::uint64_t(ix + kMax);
+   return true;
+}
+//______________________________________________________________________________
+
+inline void B1VoxelHash::Index(std::uint64_t key, G4int& ix, G4int& iy, G4int& iz)
+{
+   const G4int         kMax  = 1 << 20;
+   const std::uint64_t kMask = (std::uint64_t(1) << 21) - 1;
+   ix = G4int(key & kMask) - kMax;
+   iy = G4int((key >> 21) & kMask) - kMax;
+   iz = G4int((key >> 42) & kMask) - kMax;
+}
+//______________________________________________________________________________
+
+inline std::uint64_t B1VoxelHash::Hash(std::uint64_t key)
+{
+   // splitmix64 finaliser: neighbouring voxels land far apart
+   key ^= key >> 30;
+   key *= 0xbf58476d1ce4e5b9ULL;
+   key ^= key >> 27;
+   key *= 0x94d049bb133111ebULL;
+   key ^= key >> 31;
+   return key;
+}
+//______________________________________________________________________________
+
+inline B1VoxelHash::Entry& B1VoxelHash::Get(std::uint64_t key)
+{
+   std::size_t i = Hash(key) & fMask;
+   while( true ) {
+      Entry& e = fEntries[i];
+      if( e.key == key ) return e;
+      if( e.key == kEmpty ) {
+         if( 2*(fSize + 1) > fEntries.size() ) {
+            Grow();
+            return Get(key);
+         }
+         e.key = key;
+         fSize++;
+         return e;
+      }
+      i = (i + 1) & fMask;
+   }
+}
+
+#endif
+
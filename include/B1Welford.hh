@@ -0,0 +1,48 @@
+#ifndef B1Welford_h
+#define B1Welford_h 1
+
+#include "globals.hh"
+#include <cmath>
+
+/// Running mean and variance (Welford), mergeable across threads (Chan et
+/// al.), so that no sample has to be kept and the sums do not lose
+/// precision on long runs.
+
+struct B1Welford
+{
+   G4double n;
+   G4double mean;
+   G4double m2;
+
+   B1Welford() : n(0.0), mean(0.0), m2(0.0) { }
+
+   void Add(G4double x)
+   {
+      n += 1.0;
+      G4double d = x - mean;
+      mean += d/n;
+      m2   += d*(x - mean);
+   }
+
+   void Merge(const B1Welford& o)
+   {
+      if( o.n == 0.0 ) return;
+      G4double nt = n + o.n;
+      G4double d  = o.mean - mean;
+      mean += d*o.n/nt;
+      m2   += o.m2 + d*d*n*o.n/nt;
+      n     = nt;
+   }
+
+   G4double Variance() const { return (n > 1.0) ? m2/(n - 1.0) : 0.0; }
+   G4double RMS()      const { return std::sqrt(Variance()); }
+
+   /// Relative uncertainty of the mean
+   G4double RelativeError() const
+   {
+      return (n > 1.0 && mean != 0.0) ? std::sqrt(Variance()/n)/std::fabs(mean) : 0.0;
+   }
+};
+
+#endif
+
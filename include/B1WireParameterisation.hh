@@ -0,0 +1,73 @@
+#ifndef B1WireParameterisation_h
+#define B1WireParameterisation_h 1
+
+#include "globals.hh"
+#include "G4VPVParameterisation.hh"
+#include "G4ThreeVector.hh"
+#include "G4RotationMatrix.hh"
+
+class G4VPhysicalVolume;
+class G4Box;
+
+/// Parameterisation of the drift chamber wire plane.
+///
+/// Wire i is a box of square cross section (spacing/3 half width) placed at
+///   y_i = y0 + spacing/2 + i*spacing
+/// with a length that grows linearly with the wire index
+///   L_i = L0 + i*spacing/sin(angle)
+/// All wires share one rotation (wire axis along x).
+
+class B1WireParameterisation : public G4VPVParameterisation
+{
+   private:
+      G4int              fNWires;
+      G4double           fSpacing;
+      G4double           fAngle;
+      G4double           fLength0;
+      G4double           fY0;
+      G4double           fZ;
+      G4double           fInvSinAngle;
+      G4RotationMatrix * fRotation;
+
+   public:
+      B1WireParameterisation(G4int    nwires,
+                             G4double spacing,
+                             G4double angle,
+                             G4double length0,
+                             G4double y0,
+                             G4double z);
+      virtual ~B1WireParameterisation();
+
+      G4int    GetNumberOfWires() const { return fNWires; }
+      G4double GetSpacing() const { return fSpacing; }
+      G4double GetAngle() const { return fAngle; }
+      G4double GetLength0() const { return fLength0; }
+      G4double GetY0() const { return fY0; }
+      G4double GetZ() const { return fZ; }
+      G4double GetWireHalfWidth() const { return fSpacing/3.0; }
+      G4double GetWireLength(G4int copyNo) const { return fLength0 + copyNo*fSpacing*fInvSinAngle; }
+      G4double GetWireY(G4int copyNo) const { return fY0 + fSpacing/2.0 + copyNo*fSpacing; }
+      G4double GetMaxWireLength() const { return GetWireLength(fNWires-1); }
+
+      virtual void ComputeTransformation(const G4int copyNo, G4VPhysicalVolume* physVol) const;
+
+      virtual void ComputeDimensions(G4Box& wire, const G4int copyNo, const G4VPhysicalVolume* physVol) const;
+
+   private:
+      // Dummy declarations to get rid of warnings
+      void ComputeDimensions(G4Trd&,const G4int,const G4VPhysicalVolume*) const {}
+      void ComputeDimensions(G4Trap&,const G4int,const G4VPhysicalVolume*) const {}
+      void ComputeDimensions(G4Cons&,const G4int,const G4VPhysicalVolume*) const {}
+      void ComputeDimensions(G4Sphere&,const G4int,const G4VPhysicalVolume*) const {}
+      void ComputeDimensions(G4Orb&,const G4int,const G4VPhysicalVolume*) const {}
+      void ComputeDimensions(G4Ellipsoid&,const G4int,const G4VPhysicalVolume*) const {}
+      void ComputeDimensions(G4Torus&,const G4int,const G4VPhysicalVolume*) const {}
+      void ComputeDimensions(G4Para&,const G4int,const G4VPhysicalVolume*) const {}
+      void ComputeDimensions(G4Hype&,const G4int,const G4VPhysicalVolume*) const {}
+      void ComputeDimensions(G4Tubs&,const G4int,const G4VPhysicalVolume*) const {}
+      void ComputeDimensions(G4Polycone&,const G4int,const G4VPhysicalVolume*) const {}
+      void ComputeDimensions(G4Polyhedra&,const G4int,const G4VPhysicalVolume*) const {}
+};
+
+#endif
+
@@ -3,64 +3,30 @@
 
 #include "G4VSensitiveDetector.hh"
 #include "FakeSDHit.hh"
-#include "B1Analysis.hh"
+
+#include <vector>
 
 class G4Step;
 class G4HCofThisEvent;
 class G4TouchableHistory;
+class B1PlaneHistograms;
+
+/// Sensitive detector shared by all the scoring planes.
+///
+/// The planes are the copies of one parameterised volume and hits are
+/// dispatched on the copy number. The histograms are those of
+/// B1PlaneHistograms: every plane is counted in the crossings and
+/// energy-vs-plane histograms, the full set (/p<i>/...) is only booked for
+/// the selected planes. The histograms are booked by B1RunAction, which
+/// books the same set on the master (where there is no sensitive detector)
+/// so that the threads can be merged, and set here before the first event.
+/// ProcessHits only adds to per-event sums for the crossings; they are
+/// flushed in EndOfEvent.
 
 class FakeSD : public G4VSensitiveDetector
 {
   public:
-     G4AnalysisManager * fAnalysisManager;
-
-     G4int  fhForward_0 ;
-     G4int  fhBackward_0;
-
-     G4int  fhXvsE_all ;
-     G4int  fhXvsE_gamma ;
-     G4int  fhXvsE_not_gamma ;
-     G4int  fhXvsE_n ;
-
-     G4int  fhXY0_all;
-     G4int  fhXY1_all;
-     G4int  fhXY2_all;
-
-     G4int  fhXY0_gamma;
-     G4int  fhXY1_gamma;
-     G4int  fhXY2_gamma;
-
-     G4int  fhBackScatEnergy;
-     G4int  fhForwardScatEnergy;
-     G4int  fhBackScatXYEnergyWt;
-     G4int  fhForwardScatXYEnergyWt;
-     G4int  fhBackScatXYEnergyWt_1;
-     G4int  fhForwardScatXYEnergyWt_1;
-
-     G4int  fhBackScat_XY;
-     G4int  fhForwardScat_XY;
-     G4int  fhBackScat_XY_1;
-     G4int  fhForwardScat_XY_1;
-
-     G4int fhEDD_x_y0;
-     G4int fhEDD_y_x0;
-     G4int fhEDD_x_y0_1;
-     G4int fhEDD_y_x0_1;
-
-     G4int fhEDD_x_y0_2;
-     G4int fhEDD_y_x0_2;
-
-     G4int fhEDD_x_y0_3;
-     G4int fhEDD_y_x0_3;
-
-     G4int fhEDD_x_y0_4;
-     G4int fhEDD_y_x0_4;
-
-     G4int fhEDDNonIonizing_x_y0;
-     G4int fhEDDNonIonizing_y_x0;
-
-  public:
-      FakeSD(G4String name);
+      FakeSD(G4String name, G4int nplanes);
       ~FakeSD();
 
       void Initialize(G4HCofThisEvent*HCE);
@@ -70,8 +36,16 @@ class FakeSD : public G4VSensitiveDetector
       void DrawAll();
       void PrintAll();
 
+      G4int GetNumberOfPlanes() const { return fNplanes; }
+
+      /// Histograms of the planes, owned by the run action of the thread
+      void                SetHistograms(B1PlaneHistograms * h) { fHistograms = h; }
+      B1PlaneHistograms * GetHistograms() const { return fHistograms; }
+
   private:
       G4int HCID;
+      G4int                         fNplanes;
+      B1PlaneHistograms           * fHistograms;
       FakeSDHitsCollection *hitsCollection;
 
 };
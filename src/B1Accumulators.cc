@@ -0,0 +1,141 @@
+#include "B1Accumulators.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+
+//______________________________________________________________________________
+
+G4int B1Accumulators::Define(const G4String& name, G4int type, std::size_t offset)
+{
+   Definition d;
+   d.name   = name;
+   d.type   = type;
+   d.offset = offset;
+   fDefinitions.push_back(d);
+   return fDefinitions.size() - 1;
+}
+//______________________________________________________________________________
+
+G4int B1Accumulators::AddCounter(const G4String& name)
+{
+   fCounters.push_back(0);
+   return Define(name, kCounter, fCounters.size() - 1);
+}
+//______________________________________________________________________________
+
+G4int B1Accumulators::AddSum(const G4String& name)
+{
+   Sum zero = {0.0, 0.0, 0.0, 0.0, 0.0};
+   fSums.push_back(zero);
+   return Define(name, kSum, fSums.size() - 1);
+}
+//______________________________________________________________________________
+
+G4int B1Accumulators::AddArray(const G4String& name, std::size_t size)
+{
+   fArrays.push_back(std::vector<G4double>(size, 0.0));
+   return Define(name, kArray, fArrays.size() - 1);
+}
+//______________________________________________________________________________
+
+G4int B1Accumulators::Find(const G4String& name) const
+{
+   for(std::size_t i = 0; i < fDefinitions.size(); i++) {
+      if( fDefinitions[i].name == name ) return i;
+   }
+   return -1;
+}
+//______________________________________________________________________________
+
+G4double B1Accumulators::GetEntries(G4int id) const { return fSums[fDefinitions[id].offset].n; }
+G4double B1Accumulators::GetSum(G4int id)     const { return fSums[fDefinitions[id].offset].swx; }
+G4double B1Accumulators::GetSum2(G4int id)    const { return fSums[fDefinitions[id].offset].swx2; }
+//______________________________________________________________________________
+
+G4double B1Accumulators::GetMean(G4int id) const
+{
+   const Sum& s = fSums[fDefinitions[id].offset];
+   return (s.sw != 0.0) ? s.swx/s.sw : 0.0;
+}
+//______________________________________________________________________________
+
+G4double B1Accumulators::GetRMS(G4int id) const
+{
+   const Sum& s = fSums[fDefinitions[id].offset];
+   if( s.sw == 0.0 ) return 0.0;
+   G4double mean = s.swx/s.sw;
+   G4double var  = s.swx2/s.sw - mean*mean;
+   return (var > 0.0) ? std::sqrt(var) : 0.0;
+}
+//______________________________________________________________________________
+
+G4double B1Accumulators::GetMeanError(G4int id) const
+{
+   // with the effective number of entries of the weights
+   const Sum& s = fSums[fDefinitions[id].offset];
+   if( s.sw2 == 0.0 ) return 0.0;
+   G4double neff = s.sw*s.sw/s.sw2;
+   return (neff > 1.0) ? GetRMS(id)/std::sqrt(neff - 1.0) : 0.0;
+}
+//______________________________________________________________________________
+
+void B1Accumulators::Merge(const B1Accumulators& other)
+{
+   if( fDefinitions.empty() ) {
+      *this = other;
+      return;
+   }
+   std::size_t nc = std::min(fCounters.size(), other.fCounters.size());
+   for(std::size_t i = 0; i < nc; i++) fCounters[i] += other.fCounters[i];
+
+   std::size_t ns = std::min(fSums.size(), other.fSums.size());
+   for(std::size_t i = 0; i < ns; i++) {
+      Sum&       s = fSums[i];
+      const Sum& o = other.fSums[i];
+      s.n    += o.n;
+      s.sw   += o.sw;
+      s.sw2  += o.sw2;
+      s.swx  += o.swx;
+      s.swx2 += o.swx2;
+   }
+
+   std::size_t na = std::min(fArrays.size(), other.fArrays.size());
+   for(std::size_t i = 0; i < na; i++) {
+      std::vector<G4double>&       a = fArrays[i];
+      const std::vector<G4double>& o = other.fArrays[i];
+      if( a.size() < o.size() ) a.resize(o.size(), 0.0);
+      for(std::size_t j = 0; j < o.size(); j++) a[j] += o[j];
+   }
+}
+//______________________________________________________________________________
+
+void B1Accumulators::Reset()
+{
+   Sum zero = {0.0, 0.0, 0.0, 0.0, 0.0};
+   std::fill(fCounters.begin(), fCounters.end(), 0);
+   std::fill(fSums.begin(), fSums.end(), zero);
+   for(auto& a : fArrays) std::fill(a.begin(), a.end(), 0.0);
+}
+//______________________________________________________________________________
+
+void B1Accumulators::Print() const
+{
+   for(std::size_t id = 0; id < fDefinitions.size(); id++) {
+      const Definition& d = fDefinitions[id];
+      G4cout << std::setw(24) << d.name << " : ";
+      if( d.type == kCounter ) {
+         G4cout << GetCount(id);
+      } else if( d.type == kSum ) {
+         G4cout << GetMean(id) << " +- " << GetMeanError(id)
+            << " (rms " << GetRMS(id) << ", " << GetEntries(id) << " entries)";
+      } else {
+         const std::vector<G4double>& a = GetArray(id);
+         G4cout << a.size() << " elements, total " << std::accumulate(a.begin(), a.end(), 0.0);
+      }
+      G4cout << G4endl;
+   }
+}
+//______________________________________________________________________________
+
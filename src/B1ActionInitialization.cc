@@ -3,6 +3,7 @@
 #include "B1RunAction.hh"
 #include "B1EventAction.hh"
 #include "B1SteppingAction.hh"
+#include "B1StackingAction.hh"
 
 
 B1ActionInitialization::B1ActionInitialization(G4int rn) : G4VUserActionInitialization(),
@@ -26,12 +27,17 @@ void B1ActionInitialization::Build() const
 
    SetUserAction(new B1PrimaryGeneratorAction);
 
-   SetUserAction(new B1RunAction(fRunNumber));
+   B1RunAction* runAction = new B1RunAction(fRunNumber);
+   SetUserAction(runAction);
 
    B1EventAction* eventAction = new B1EventAction;
    SetUserAction(eventAction);
 
-   SetUserAction(new B1SteppingAction(eventAction));
+   B1SteppingAction* steppingAction = new B1SteppingAction(eventAction);
+   SetUserAction(steppingAction);
+   runAction->SetSteppingAction(steppingAction);
+
+   SetUserAction(new B1StackingAction);
 }  
 //______________________________________________________________________________
 
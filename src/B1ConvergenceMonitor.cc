@@ -0,0 +1,184 @@
+#include "B1ConvergenceMonitor.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Threading.hh"
+#include "G4RunManager.hh"
+#include <cmath>
+#include <iomanip>
+
+namespace {
+   G4Mutex monitorMutex = G4MUTEX_INITIALIZER;
+}
+
+G4double                                     B1ConvergenceMonitor::fgTarget        = 0.0;
+G4int                                        B1ConvergenceMonitor::fgCheckInterval = 1000;
+G4int                                        B1ConvergenceMonitor::fgNumPlane      = 2;
+G4int                                        B1ConvergenceMonitor::fgDenPlane      = 1;
+std::atomic<bool>                            B1ConvergenceMonitor::fgStop(false);
+std::map<G4int, B1ConvergenceMonitor::RatioSums> B1ConvergenceMonitor::fgPublished;
+B1ConvergenceMonitor::RatioSums              B1ConvergenceMonitor::fgTotalRatio    = {0, 0, 0, 0, 0, 0};
+std::vector<B1ConvergenceMonitor::PlaneStats> B1ConvergenceMonitor::fgTotalStats;
+std::vector<G4int>                           B1ConvergenceMonitor::fgPrintPlanes;
+G4double                                     B1ConvergenceMonitor::fgTotalEvents   = 0.0;
+G4ThreadLocal B1ConvergenceMonitor         * B1ConvergenceMonitor::fgInstance      = 0;
+
+//______________________________________________________________________________
+
+void B1ConvergenceMonitor::RatioSums::Merge(const RatioSums& o)
+{
+   n   += o.n;
+   sx  += o.sx;
+   sy  += o.sy;
+   sxx += o.sxx;
+   syy += o.syy;
+   sxy += o.sxy;
+}
+//______________________________________________________________________________
+
+G4double B1ConvergenceMonitor::RatioSums::RelativeError() const
+{
+   // delta method on sx/sy, with the per-event covariance of x and y
+   if( n < 2.0 || sx <= 0.0 || sy <= 0.0 ) return 0.0;
+   G4double vx  = sxx/n - (sx/n)*(sx/n);
+   G4double vy  = syy/n - (sy/n)*(sy/n);
+   G4double cxy = sxy/n - (sx/n)*(sy/n);
+   G4double rel2 = n*(vx/(sx*sx) + vy/(sy*sy) - 2.0*cxy/(sx*sy));
+   return (rel2 > 0.0) ? std::sqrt(rel2) : 0.0;
+}
+//______________________________________________________________________________
+
+B1ConvergenceMonitor * B1ConvergenceMonitor::Instance()
+{
+   if( !fgInstance ) fgInstance = new B1ConvergenceMonitor();
+   return fgInstance;
+}
+//______________________________________________________________________________
+
+B1ConvergenceMonitor::B1ConvergenceMonitor() :
+   fNplanes(0), fEvents(0)
+{
+   RatioSums zero = {0, 0, 0, 0, 0, 0};
+   fRatio = zero;
+}
+//______________________________________________________________________________
+
+void B1ConvergenceMonitor::Configure(G4int nplanes, const std::vector<G4int>& printPlanes)
+{
+   fNplanes     = nplanes;
+   fPrintPlanes = printPlanes;
+   fStats.assign(nplanes*B1PlaneHistograms::kNSpecies, PlaneStats());
+}
+//______________________________________________________________________________
+
+void B1ConvergenceMonitor::BeginOfRun()
+{
+   RatioSums zero = {0, 0, 0, 0, 0, 0};
+   fRatio  = zero;
+   fEvents = 0;
+   fStats.assign(fNplanes*B1PlaneHistograms::kNSpecies, PlaneStats());
+
+   // the master starts before the workers: it clears the shared state
+   if( G4Threading::IsMasterThread() ) {
+      G4AutoLock lock(&monitorMutex);
+      fgStop         = false;
+      fgTotalRatio   = zero;
+      fgTotalEvents  = 0.0;
+      fgTotalStats.clear();
+      fgPublished.clear();
+   }
+}
+//______________________________________________________________________________
+
+void B1ConvergenceMonitor::AddEventCounts(G4int plane, const G4int * n)
+{
+   PlaneStats * s = &fStats[plane*B1PlaneHistograms::kNSpecies];
+   for(G4int i = 0; i < B1PlaneHistograms::kNSpecies; i++) {
+      s[i].sumN  += n[i];
+      s[i].sumN2 += G4double(n[i])*n[i];
+   }
+}
+//______________________________________________________________________________
+
+void B1ConvergenceMonitor::EndOfEvent(G4int forwardNum, G4int forwardDen)
+{
+   fRatio.n   += 1.0;
+   fRatio.sx  += forwardNum;
+   fRatio.sy  += forwardDen;
+   fRatio.sxx += G4double(forwardNum)*forwardNum;
+   fRatio.syy += G4double(forwardDen)*forwardDen;
+   fRatio.sxy += G4double(forwardNum)*forwardDen;
+   fEvents++;
+
+   if( fgTarget > 0.0 && fEvents % fgCheckInterval == 0 ) Publish();
+}
+//______________________________________________________________________________
+
+void B1ConvergenceMonitor::Publish()
+{
+   G4AutoLock lock(&monitorMutex);
+   fgPublished[G4Threading::G4GetThreadId()] = fRatio;
+   if( fgStop ) return;
+
+   RatioSums all = {0, 0, 0, 0, 0, 0};
+   for(const auto& p : fgPublished) all.Merge(p.second);
+   G4double rel = all.RelativeError();
+   if( all.sx > 0.0 && rel > 0.0 && rel <= fgTarget ) {
+      fgStop = true;
+      G4cout << " convergence : ratio " << all.Ratio() << " +- " << 100.0*rel << " % after "
+         << all.n << " events, stopping the run" << G4endl;
+   }
+}
+//______________________________________________________________________________
+
+void B1ConvergenceMonitor::EndOfRun()
+{
+   G4AutoLock lock(&monitorMutex);
+   fgTotalRatio.Merge(fRatio);
+   fgTotalEvents += fEvents;
+   if( fgTotalStats.size() < fStats.size() ) fgTotalStats.resize(fStats.size());
+   for(std::size_t i = 0; i < fStats.size(); i++) {
+      fgTotalStats[i].energy.Merge(fStats[i].energy);
+      fgTotalStats[i].sumN  += fStats[i].sumN;
+      fgTotalStats[i].sumN2 += fStats[i].sumN2;
+   }
+   if( fgPrintPlanes.empty() ) fgPrintPlanes = fPrintPlanes;
+}
+//______________________________________________________________________________
+
+void B1ConvergenceMonitor::Print()
+{
+   G4AutoLock lock(&monitorMutex);
+   if( fgTotalEvents == 0.0 ) return;
+
+   G4double n = fgTotalEvents;
+   G4cout << std::setw(8) << "plane"
+      << std::setw(12) << "species"
+      << std::setw(14) << "crossings"
+      << std::setw(12) << "+- (%)"
+      << std::setw(14) << "<E> (MeV)"
+      << std::setw(12) << "rms (MeV)"
+      << std::setw(12) << "+- (%)" << G4endl;
+   for(G4int plane : fgPrintPlanes) {
+      for(G4int s = 0; s < B1PlaneHistograms::kNSpecies; s++) {
+         std::size_t i = plane*B1PlaneHistograms::kNSpecies + s;
+         if( i >= fgTotalStats.size() ) continue;
+         const PlaneStats& st = fgTotalStats[i];
+         if( st.sumN == 0.0 ) continue;
+         // uncertainty of the total count from the spread of the per-event counts
+         G4double var    = st.sumN2/n - (st.sumN/n)*(st.sumN/n);
+         G4double relN   = (var > 0.0) ? std::sqrt(n*var)/st.sumN : 0.0;
+         G4cout << std::setw(8) << plane
+            << std::setw(12) << B1PlaneHistograms::GetSpeciesName(s)
+            << std::setw(14) << st.sumN
+            << std::setw(12) << 100.0*relN
+            << std::setw(14) << st.energy.mean
+            << std::setw(12) << st.energy.RMS()
+            << std::setw(12) << 100.0*st.energy.RelativeError() << G4endl;
+      }
+   }
+   G4cout << " transmission p" << fgNumPlane << "/p" << fgDenPlane << " (forw0) : "
+      << fgTotalRatio.Ratio() << " +- " << 100.0*fgTotalRatio.RelativeError() << " %" << G4endl;
+   if( fgStop ) G4cout << " the run was stopped at the target precision of " << 100.0*fgTarget << " %" << G4endl;
+}
+//______________________________________________________________________________
+
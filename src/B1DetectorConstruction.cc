@@ -18,11 +18,35 @@
 #include "G4SystemOfUnits.hh"
 #include "G4VisAttributes.hh"
 #include "G4UserLimits.hh"
+#include "G4Track.hh"
 #include "FakeSD.hh"
 #include "G4GenericTrap.hh"
 #include "G4TwoVector.hh"
 #include "G4IntersectionSolid.hh"
+#include "G4DisplacedSolid.hh"
 #include "G4RotationMatrix.hh"
+#include "G4PVParameterised.hh"
+#include "G4Timer.hh"
+#include "G4GeometryManager.hh"
+#include "B1WireParameterisation.hh"
+#include "B1SolidBenchmark.hh"
+#include "G4TessellatedSolid.hh"
+#include "G4TriangularFacet.hh"
+#include "G4QuadrangularFacet.hh"
+#include "B1GeometrySnapshot.hh"
+#include "B1MaterialRegistry.hh"
+#include "B1NavigationBenchmark.hh"
+#include "B1OverlapChecker.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4SmartVoxelHeader.hh"
+#include "G4SmartVoxelStat.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4VUserPhysicsList.hh"
+#include "G4StateManager.hh"
+#include <iomanip>
 
 //___________________________________________________________________
 
@@ -53,7 +77,15 @@ B1DetectorConstruction::B1DetectorConstruction() :
    window_thickness             ( 8.0*mm  ),
    scoring2_diameter            ( 20.0*cm ),
    scoring2_length              ( 0.01*mm    ),
+   trap_width                   ( 195.259*mm ),
+   wire_spacing                 ( 1.0*cm     ),
+   wire_angle                   ( 80.0*degree),
+   wire_length0                 ( 21.5*cm    ),
+   wire_y0                      ( 10.0*cm    ),
+   fNWires                      ( 300 ),
+   fUseWireParameterisation     ( true ),
    fScoringVolume               ( 0),
+   fScoringPlanes               ( 0),
    fHasBeenBuilt(false)
 {
    fMessenger = new B1DetectorMessenger(this);
@@ -98,6 +130,23 @@ B1DetectorConstruction::B1DetectorConstruction() :
    scoring2_solid   = 0;
    scoring2_log     = 0;
    scoring2_phys    = 0;
+   fWireParam       = 0;
+   fWireRotation    = 0;
+   fMaterialsBuilt  = false;
+   for(int i = 0; i < 3; i++) {
+      fRegionLimits[i] = 0;
+      fRegionCuts[i]   = 0;
+   }
+   fUseSnapshot     = false;
+   fSnapshotDir     = ".";
+   fRegionSolidMode     = kRegionBoolean;
+   fCollimatorSolidMode = kRegionBoolean;
+
+   world_vis        = 0;
+   beampipe_vis     = 0;
+   radiator_vis     = 0;
+   collimator_vis   = 0;
+   collimator2_vis  = 0;
 }
 //___________________________________________________________________
 
@@ -107,10 +156,67 @@ B1DetectorConstruction::~B1DetectorConstruction()
 }
 //______________________________________________________________________________
 
-void B1DetectorConstruction::Rebuild()
+void B1DetectorConstruction::Rebuild(G4int flags)
+{
+   // Only the volumes affected by the changed parameters are rebuilt.
+   // Materials, vis attributes and untouched solids are reused.
+   G4Timer timer;
+   timer.Start();
+
+   if( flags & kRebuildCollimator ) flags |= kRebuildWires;
+
+   if( flags == kRebuildNone ) {
+      G4cout << "B1DetectorConstruction::Rebuild() : nothing to rebuild" << G4endl;
+      return;
+   }
+
+   G4GeometryManager * geoman = G4GeometryManager::GetInstance();
+   G4bool              closed = geoman->IsGeometryClosed();
+
+   if(closed) geoman->OpenGeometry(GetRebuildHandle(flags));
+
+   CalculatePositions();
+   if( flags & kRebuildCollimator ) {
+      ConstructCollimator();
+   }
+   if( flags & kRebuildWires ) {
+      ConstructWires();
+   }
+   if( flags & (kRebuildCollimator|kRebuildWires) ) {
+      ConstructRegions();
+   }
+   if( flags & kRebuildPositions ) {
+      beampipe_phys->SetTranslation(beampipe_pos);
+      radiator_phys->SetTranslation(radiator_pos);
+      collimator_phys->SetTranslation(collimator_pos + GetRegionOffset());
+   }
+
+   if(closed) geoman->CloseGeometry(true, false, GetRebuildHandle(flags));
+
+   timer.Stop();
+   G4cout << "B1DetectorConstruction::Rebuild() :"
+      << ((flags & kRebuildPositions)  ? " positions"  : "")
+      << ((flags & kRebuildCollimator) ? " collimator" : "")
+      << ((flags & kRebuildWires)      ? " wires"      : "")
+      << " rebuilt in " << timer.GetRealElapsed()*1000.0 << " ms" << G4endl;
+
+   // Volumes were replaced: the run manager still has to reset the
+   // navigators (whose history may point at deleted volumes) and, in MT,
+   // have the workers pick up the new geometry at the next run. The subtree
+   // voxels above keep the geometry usable in between.
+   if( G4RunManager::GetRunManager() ) {
+      G4RunManager::GetRunManager()->GeometryHasBeenModified();
+   }
+}
+//______________________________________________________________________________
+
+G4VPhysicalVolume * B1DetectorConstruction::GetRebuildHandle(G4int flags) const
 {
-   B1DetectorConstruction::Construct();
-   G4RunManager::GetRunManager()->GeometryHasBeenModified();
+   // Opening/closing the geometry at a physical volume rebuilds the voxels of
+   // its mother and of its own subtree. The beampipe has no daughters, so it
+   // is used when only placements in the world have moved.
+   if( flags & (kRebuildCollimator|kRebuildWires) ) return collimator_phys;
+   return beampipe_phys;
 }
 //______________________________________________________________________________
 
@@ -127,226 +233,105 @@ void B1DetectorConstruction::CalculatePositions()
    scoring2_pos     = { 0, 0, collimator_z_end + collimator_target_center_gap };
 }
 //______________________________________________________________________________
+
+void B1DetectorConstruction::ConstructMaterials()
+{
+   // The registry builds each material (and the scintillator optical
+   // properties) once per job and returns the cached instances afterwards.
+   if(fMaterialsBuilt) return;
+
+   B1MaterialRegistry * materials = B1MaterialRegistry::Instance();
+
+   world_mat        = materials->GetMaterial("G4_AIR");
+   beampipe_mat     = materials->GetMaterial("beampipe_mat");
+   radiator_mat     = materials->GetMaterial("Scintillator");
+   collimator_mat   = materials->GetMaterial("DC_gas");//nist->FindOrBuildMaterial(fCollimatorMatName);
+   collimator2_mat  = collimator_mat;
+
+   G4cout << "B1DetectorConstruction::ConstructMaterials() : "
+      << B1MaterialRegistry::GetTableSize() << " materials in the table" << G4endl;
+
+   fMaterialsBuilt = true;
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::ConstructVisAttributes()
+{
+   if(world_vis) return;
+
+   world_vis   = new G4VisAttributes(G4Colour(0.0/256.0, 200.0/256.0, 0.0/256.0, 0.4));
+   //(*world_vis) = G4VisAttributes::GetInvisible();
+   world_vis->SetForceWireframe(true);
+
+   beampipe_vis = new G4VisAttributes(G4Colour(0.0/256.0, 0.0/256.0, 192.0/256.0, 0.4));
+
+   radiator_vis = new G4VisAttributes(G4Colour(256.0/256.0, 1.0/256.0, 1.0/256.0, 0.4));
+
+   collimator_vis = new G4VisAttributes(G4Colour(250.0/256.0, 0.0/256.0, 1.0/256.0, 0.4));
+   collimator_vis->SetForceWireframe(true);
+
+   collimator2_vis = new G4VisAttributes(G4Colour(0.0/256.0, 200.0/256.0, 30.0/256.0, 0.4));
+   collimator2_vis->SetForceWireframe(true);
+}
+//______________________________________________________________________________
+
 G4VPhysicalVolume* B1DetectorConstruction::Construct()
 {  
    //std::cout << "============================================================" << std::endl;
    //std::cout << "B1DetectorConstruction::Construct()" << std::endl;
 
-   // Get nist material manager
-
-   G4NistManager* nist = G4NistManager::Instance();
+   G4Timer timer;
+   timer.Start();
 
    CalculatePositions();
 
-   bool    checkOverlaps    = false;
-   int     natoms           = 0;
-   int     ncomponents      = 0;
-   double  A                = 0.0;
-   double  Z                = 0.0;
-   double  thickness        = 0.0;
-   double  surface_z        = 0.0;
-   double  red              = 0.0;
-   double  green            = 0.0;
-   double  blue             = 0.0;
-   double  alpha            = 0.0;
-   double  density          = 0.0;
-   double  pressure         = 0.0;
-   double  temperature      = 0.0;
-   double  a                = 0.0;
+   // the snapshot key includes the materials
+   ConstructMaterials();
+
+   if( fUseSnapshot && !world_phys && LoadSnapshot() ) {
+      ConstructRegions();
+      fHasBeenBuilt = true;
+      return world_phys;
+   }
 
+   ConstructVisAttributes();
+
+   bool    checkOverlaps    = false;
 
    // ------------------------------------------------------------------------
    // World
    // ------------------------------------------------------------------------
-   density     = universe_mean_density;
-   pressure    = 1.e-7*bar;
-   temperature = 0.1*kelvin;
-   red         = 0.0/256.0;
-   green       = 200.0/256.0;
-   blue        = 0.0/256.0;
-   alpha       = 0.4;
-
-   world_mat   = nist->FindOrBuildMaterial("G4_AIR");
    if(!world_solid) world_solid = new G4Box( "World", 0.5*world_x, 0.5 * world_y, 0.5 * world_z );
    if(!world_log)   world_log = new G4LogicalVolume( world_solid, world_mat, "world_log" );
    if(!world_phys)  world_phys  = new G4PVPlacement( 0, G4ThreeVector(), world_log, "world_phys", 0, false, 0, checkOverlaps );
-
-   G4Colour            world_color {red, green, blue, alpha }; 
-   G4VisAttributes   * world_vis   = new G4VisAttributes(world_color);
-   //(*world_vis) = G4VisAttributes::GetInvisible();
-   world_vis->SetForceWireframe(true);
    world_log->SetVisAttributes(world_vis);
 
    // ------------------------------------------------------------------------
    // beam vacuum  
    // ------------------------------------------------------------------------
-   density     = universe_mean_density;
-   pressure    = 1.e-7*bar;
-   temperature = 0.1*kelvin;
-   red       = 0.0/256.0;
-   green     = 0.0/256.0;
-   blue      = 192.0/256.0;
-   alpha     = 0.4;
-
-
-   if(!beampipe_mat)   beampipe_mat   = new G4Material("beampipe_mat", /*z=*/1.0, /*a=*/1.01*g/mole, density, kStateGas,temperature,pressure);
    if(!beampipe_solid) beampipe_solid  = new G4Tubs("beampipe_solid", 0.0, beampipe_diameter/2.0, beampipe_length/2.0, 0.0, 360.*deg );
    if(!beampipe_log  ) beampipe_log   = new G4LogicalVolume(beampipe_solid, beampipe_mat,"beampipe_log");
    if(!beampipe_phys ) beampipe_phys  = new G4PVPlacement(0,beampipe_pos, beampipe_log, "beampipe_phys",world_log,false,0,checkOverlaps);                                  
-
-   G4Colour            beampipe_color {red, green, blue, alpha };   // Gray 
-   G4VisAttributes   * beampipe_vis   = new G4VisAttributes(beampipe_color);
    beampipe_log->SetVisAttributes(beampipe_vis);
 
-
    // ------------------------------------------------------------------------
    // radiator target centered at origin
    // ------------------------------------------------------------------------
-   red       = 256.0/256.0;
-   green     = 1.0/256.0;
-   blue      = 1.0/256.0;
-   alpha     = 0.4;
-
-   if(radiator_phys) delete radiator_phys;
-   if(radiator_log) delete radiator_log;
-   if(radiator_solid) delete radiator_solid;
-
-   //radiator_mat   = nist->FindOrBuildMaterial("G4_Cu");
-   // define Elements
-   a = 1.01*g/mole;
-   G4Element* elH  = new G4Element("Hydrogen", "H",  1.0, a);
-   a = 12.01*g/mole;
-   density   = 1.032*g/cm3;
-   G4Element* elC  = new G4Element("Carbon"  , "C",  6.0, a);
-   radiator_mat = new G4Material("Scintillator", density, 2);
-   radiator_mat->AddElement(elC, 9);
-   radiator_mat->AddElement(elH, 10);
-
-   const G4int NUMENTRIES = 9;
-   G4double Scnt_PP[NUMENTRIES] = { 1.6*eV, 6.7*eV, 6.8*eV, 6.9*eV,
-      7.0*eV, 7.1*eV, 7.2*eV, 7.3*eV, 7.4*eV };
-
-   G4double Scnt_FAST[NUMENTRIES] = { 0.000134, 0.004432, 0.053991, 0.241971, 
-      0.398942, 0.000134, 0.004432, 0.053991,
-      0.241971 };
-   G4double Scnt_SLOW[NUMENTRIES] = { 0.000010, 0.000020, 0.000030, 0.004000,
-      0.008000, 0.005000, 0.020000, 0.001000,
-      0.000010 };
-   G4double rindex[NUMENTRIES]     = { 1.58, 1.58, 1.58, 1.58, 1.58, 1.58, 1.58, 1.58, 1.58 };
-
-   G4MaterialPropertiesTable* Scnt_MPT = new G4MaterialPropertiesTable();
-
-   Scnt_MPT->AddProperty("FASTCOMPONENT", Scnt_PP, Scnt_FAST, NUMENTRIES);
-   Scnt_MPT->AddProperty("SLOWCOMPONENT", Scnt_PP, Scnt_SLOW, NUMENTRIES);
-   Scnt_MPT->AddProperty(     "RINDEX"  , Scnt_PP, rindex,    NUMENTRIES);
-   Scnt_MPT->AddConstProperty("SCINTILLATIONYIELD", 1./MeV);
-   Scnt_MPT->AddConstProperty("RESOLUTIONSCALE", 2.0);
-   Scnt_MPT->AddConstProperty("FASTTIMECONSTANT",  1.*ns);
-   Scnt_MPT->AddConstProperty("SLOWTIMECONSTANT", 10.*ns);
-   Scnt_MPT->AddConstProperty("YIELDRATIO", 0.8);
-
-   //Scnt->SetMaterialPropertiesTable(Scnt_MPT);
-   //const G4int NUMENTRIES = 2; //32;
-   //G4double ppckov[NUMENTRIES]     = { 1.9074494*eV  , 6.5254848*eV  };
-   //G4double rindex[NUMENTRIES]     = { 1.58          , 1.58          };
-   //G4double absorption[NUMENTRIES] = { 1000.0000000*m, 802.8323273*m };
-   //G4MaterialPropertiesTable *scint_MPT = new G4MaterialPropertiesTable();
-   //scint_MPT->AddConstProperty("SCINTILLATIONYIELD", 1000./MeV);
-   //scint_MPT->AddProperty(     "RINDEX"            , ppckov,  rindex,     NUMENTRIES);
-   //scint_MPT->AddProperty(     "ABSLENGTH"         , ppckov,  absorption, NUMENTRIES);
-
-   radiator_mat->SetMaterialPropertiesTable(Scnt_MPT);
-
-   radiator_solid = new G4Tubs("radiator_solid", 0.0, radiator_diameter/2.0, radiator_thickness/2.0, 0.0, 360.*deg );
-   radiator_log   = new G4LogicalVolume(radiator_solid, radiator_mat,"radiator_log");
-   radiator_phys  = new G4PVPlacement(0,radiator_pos, radiator_log, "radiator_phys",world_log,false,0,checkOverlaps);                                  
-   G4Colour            radiator_color {red, green, blue, alpha };   // Gray 
-   G4VisAttributes   * radiator_vis   = new G4VisAttributes(radiator_color);
-   radiator_log->SetVisAttributes(radiator_vis);
-
-   //G4UserLimits * scoring_limits = new G4UserLimits(0.004*um);
-   //scoring_log->SetUserLimits(scoring_limits);
+   ConstructRadiator();
 
    // ------------------------------------------------------------------------
    // Inner Collimator 
    // ------------------------------------------------------------------------
-   // Part I : Upstream inner cone 
-   red       = 250.0/256.0;
-   green     = 0.0/256.0;
-   blue      = 1.0/256.0;
-   alpha     = 0.4;
-
-   G4VSolid * temp_box    = new G4Box("DC_placement_box_solid",5*m,5*m,5*m);
-   G4VSolid * temp_region = 0;
-   //temp_region    = new G4Box("R1trap_solid_BOX", 4.0*m, 4.0*m, 1.0*m); 
-
-   double trap_width = 195.259*mm;
-   std::vector< G4TwoVector> trap_points = {
-      {-103.734*mm, 179.672 *mm},
-      {-1625.95*mm, 3172.94 *mm},
-      {1625.95 *mm, 3172.94 *mm},
-      {103.734 *mm, 179.672 *mm},
-      {-103.734*mm, -2.42984*mm},
-      {-1683.74*mm, 3103.61 *mm},
-      {1683.74 *mm, 3103.61 *mm},
-      {103.734 *mm, -2.42984*mm}
-   };
-   temp_region    = new G4GenericTrap("R1trap_solid", trap_width/2.0, trap_points);
-   G4VSolid * fRegion1_solid = new G4IntersectionSolid("RI_solid", temp_box, temp_region, 0,  G4ThreeVector(0.0,0.0,trap_width/2.0) );
-
-   if(collimator_phys)  delete collimator_phys;
-   if(collimator_log)   delete collimator_log;
-   if(collimator_solid) delete collimator_solid;
-
-   G4NistManager * matman = G4NistManager::Instance();
-   G4Element     * Ar     = new G4Element("Argon", "Ar", /*z    = */18, /*a            = */ 39.95*g/mole);
-   G4Material    * fGasMaterial  = new G4Material("DC_gas", /* density = */ 1.8*mg/cm3, /*nel = */ 3);
-   fGasMaterial->AddElement(Ar, 90*perCent);
-   fGasMaterial->AddMaterial(matman->FindOrBuildMaterial("G4_O"),  6.6*perCent);
-   fGasMaterial->AddMaterial(matman->FindOrBuildMaterial("G4_C"),  3.4*perCent);
-
-   collimator_mat   = fGasMaterial;//nist->FindOrBuildMaterial(fCollimatorMatName);
-   collimator_solid = fRegion1_solid;
-   collimator_log   = new G4LogicalVolume(collimator_solid, collimator_mat,"collimator_log");
-   collimator_phys  = new G4PVPlacement(0,collimator_pos, collimator_log, "collimator_phys",world_log,false,0,checkOverlaps);                                  
-
-   G4Colour            collimator_color {red, green, blue, alpha };   // Gray 
-   G4VisAttributes   * collimator_vis   = new G4VisAttributes(collimator_color);
-   collimator_vis->SetForceWireframe(true);
-   collimator_log->SetVisAttributes(collimator_vis);
+   // Part I : drift chamber gas region
+   ConstructCollimator();
 
    // ------------------------------------------------------------------------
-   // Part II  
-   red       = 0.0/256.0;
-   green     = 200.0/256.0;
-   blue      = 30.0/256.0;
-   alpha     = 0.4;
-   G4Colour            collimator2_color {red, green, blue, alpha };   // Gray 
-   G4VisAttributes   * collimator2_vis   = new G4VisAttributes(collimator2_color);
-   collimator2_vis->SetForceWireframe(true);
-   G4RotationMatrix * wire_rot = new G4RotationMatrix();
-   wire_rot->rotateY(90.0*degree);
-
-   double wire_spacing = 1.0*cm;
-   double sqrtof3 = sin(80.0*degree);//sqrt(3.0);
-
-   for(int iWire = 0; iWire < 300; iWire ++ ) {
-      double deltaL     = iWire*wire_spacing/sqrtof3;
-      double hex_length = 21.5*cm + deltaL ;
-      double y_position = 10.0*cm + wire_spacing/2.0 + iWire*wire_spacing;
-
-      collimator2_pos = {0.0, y_position, trap_width/2.0};
-
-      G4VSolid * hex_polyhedra = new G4Box("wire_box",wire_spacing/3.0,wire_spacing/3.0, hex_length/2.0 );
-
-      collimator2_mat   = fGasMaterial;//nist->FindOrBuildMaterial(fCollimatorMatName);
-      collimator2_solid = hex_polyhedra;
-      collimator2_log   = new G4LogicalVolume(collimator2_solid, collimator2_mat,"collimator2_log");
-      collimator2_phys  = new G4PVPlacement(wire_rot,collimator2_pos, collimator2_log, "collimator2_phys",collimator_log,false,0,false);
-
-      collimator2_log->SetVisAttributes(collimator2_vis);
-   }
+   // Part II  : wire plane
+   ConstructWires();
 
+   // ------------------------------------------------------------------------
+   // Regions
+   ConstructRegions();
 
    // ------------------------------------------------------------------------
    // Outer Collimator 
@@ -457,21 +442,721 @@ G4VPhysicalVolume* B1DetectorConstruction::Construct()
    //fScoringVolume = scoring2_log;
    fHasBeenBuilt = true;
 
+   timer.Stop();
+   G4cout << "B1DetectorConstruction::Construct() : " << fNWires << " wires ("
+      << (fUseWireParameterisation ? "parameterised" : "placements") << ") built in "
+      << timer.GetRealElapsed()*1000.0 << " ms" << G4endl;
+
+   if(fUseSnapshot) SaveSnapshot(timer.GetRealElapsed());
+
    return world_phys;
 }
+//______________________________________________________________________________
+
+std::uint64_t B1DetectorConstruction::GetParameterHash() const
+{
+   // FNV-1a over the parameters, the materials as the snapshot saves them
+   // and the version of the construction code below. Bump kContentVersion
+   // when the code builds a different geometry from the same parameters.
+   const std::uint32_t kContentVersion = 1;
+
+   std::uint64_t hash = 14695981039346656037ULL;
+   auto mix = [&hash](const void * data, std::size_t n) {
+      const unsigned char * bytes = static_cast<const unsigned char*>(data);
+      for(std::size_t i = 0; i < n; i++) {
+         hash ^= bytes[i];
+         hash *= 1099511628211ULL;
+      }
+   };
+   mix(&kContentVersion, sizeof(kContentVersion));
+
+   const std::uint64_t materials = B1GeometrySnapshot::MaterialHash(
+      { world_mat, beampipe_mat, radiator_mat, collimator_mat, collimator2_mat });
+   mix(&materials, sizeof(materials));
+
+   const G4double lengths[] = {
+      world_x, world_y, world_z, radiator_thickness, radiator_diameter,
+      collimator_target_center_gap, collimator_upstream_ID, collimator_downstream_ID,
+      collimator_OD, outer_collimator_ID, outer_collimator_OD, collimator_diameter,
+      collimator_tooth_slope, radiator_collimator_gap, collimator_length,
+      beampipe_length, beampipe_diameter, trap_width,
+      wire_spacing, wire_angle, wire_length0, wire_y0 };
+   mix(lengths, sizeof(lengths));
+
+   const G4int flags[] = { fNWires, G4int(fUseWireParameterisation), fRegionSolidMode };
+   mix(flags, sizeof(flags));
+   mix(fCollimatorMatName.data(), fCollimatorMatName.size());
+   return hash;
+}
+//______________________________________________________________________________
+
+G4bool B1DetectorConstruction::LoadSnapshot()
+{
+   G4Timer timer;
+   timer.Start();
+
+   B1GeometrySnapshot  snapshot;
+   G4String            file_name = B1GeometrySnapshot::FileName(fSnapshotDir, GetParameterHash());
+   G4VPhysicalVolume * world     = snapshot.Read(file_name, GetParameterHash());
+   if( !world ) return false;
+
+   world_phys     = world;
+   world_log      = world->GetLogicalVolume();
+   beampipe_log   = snapshot.FindLogical("beampipe_log");
+   radiator_log   = snapshot.FindLogical("radiator_log");
+   collimator_log = snapshot.FindLogical("collimator_log");
+   beampipe_phys  = snapshot.FindPhysical("beampipe_phys");
+   radiator_phys  = snapshot.FindPhysical("radiator_phys");
+   collimator_phys= snapshot.FindPhysical("collimator_phys");
+
+   world_solid      = world_log->GetSolid();
+   beampipe_solid   = beampipe_log->GetSolid();
+   radiator_solid   = radiator_log->GetSolid();
+   collimator_solid = collimator_log->GetSolid();
+
+   fCollimatorSolidMode = fRegionSolidMode;
+
+   // the wire plane, so that a later Rebuild() can clear it
+   for(auto pv : snapshot.GetPhysicals()) {
+      if( pv->GetName() != "collimator2_phys" ) continue;
+      collimator2_phys  = pv;
+      collimator2_log   = pv->GetLogicalVolume();
+      collimator2_solid = collimator2_log->GetSolid();
+      fWireParam        = dynamic_cast<B1WireParameterisation*>(pv->GetParameterisation());
+      if(fWireParam) break;
+      fWirePlacements.push_back(pv);
+      fWireRotation = pv->GetRotation();
+   }
+
+   // Rebuilds use the cached vis attributes
+   ConstructVisAttributes();
+   world_log->SetVisAttributes(world_vis);
+   beampipe_log->SetVisAttributes(beampipe_vis);
+   radiator_log->SetVisAttributes(radiator_vis);
+   collimator_log->SetVisAttributes(collimator_vis);
+   if(fWireParam) collimator2_log->SetVisAttributes(collimator2_vis);
+   for(auto pv : fWirePlacements) pv->GetLogicalVolume()->SetVisAttributes(collimator2_vis);
+
+   timer.Stop();
+   G4cout << "B1DetectorConstruction::Construct() : geometry loaded from " << file_name
+      << " in " << timer.GetRealElapsed()*1000.0 << " ms (built from code in "
+      << snapshot.GetBuildTime()*1000.0 << " ms, "
+      << (snapshot.GetBuildTime() - timer.GetRealElapsed())*1000.0 << " ms saved)" << G4endl;
+   return true;
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::SaveSnapshot(G4double buildTime)
+{
+   B1GeometrySnapshot snapshot;
+   G4String           file_name = B1GeometrySnapshot::FileName(fSnapshotDir, GetParameterHash());
+   if( snapshot.Write(file_name, GetParameterHash(), buildTime, world_phys) ) {
+      G4cout << "B1DetectorConstruction::Construct() : geometry snapshot written to " << file_name << G4endl;
+   }
+}
 //___________________________________________________________________
 
+void B1DetectorConstruction::ConstructRadiator()
+{
+   bool    checkOverlaps    = false;
+
+   if(radiator_phys) {
+      world_log->RemoveDaughter(radiator_phys);
+      delete radiator_phys;
+   }
+   if(radiator_log) delete radiator_log;
+   if(radiator_solid) delete radiator_solid;
+
+   radiator_solid = new G4Tubs("radiator_solid", 0.0, radiator_diameter/2.0, radiator_thickness/2.0, 0.0, 360.*deg );
+   radiator_log   = new G4LogicalVolume(radiator_solid, radiator_mat,"radiator_log");
+   radiator_phys  = new G4PVPlacement(0,radiator_pos, radiator_log, "radiator_phys",world_log,false,0,checkOverlaps);                                  
+   radiator_log->SetVisAttributes(radiator_vis);
+
+   //G4UserLimits * scoring_limits = new G4UserLimits(0.004*um);
+   //scoring_log->SetUserLimits(scoring_limits);
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::ConstructCollimator()
+{
+   bool    checkOverlaps    = false;
+
+   // The region solid does not depend on any of the collimator parameters, so
+   // it is only rebuilt when the solid mode changes.
+   G4VSolid * old_solid = 0;
+   if(!collimator_solid || fCollimatorSolidMode != fRegionSolidMode) {
+      old_solid            = collimator_solid;
+      collimator_solid     = BuildRegionSolid(fRegionSolidMode);
+      fCollimatorSolidMode = fRegionSolidMode;
+   }
+
+   ClearWires();
+   if(collimator_phys) {
+      world_log->RemoveDaughter(collimator_phys);
+      delete collimator_phys;
+   }
+   if(collimator_log)   delete collimator_log;
+
+   if(old_solid)        DeleteRegionSolid(old_solid);
+
+   collimator_log   = new G4LogicalVolume(collimator_solid, collimator_mat,"collimator_log");
+   collimator_phys  = new G4PVPlacement(0,collimator_pos + GetRegionOffset(), collimator_log, "collimator_phys",world_log,false,0,checkOverlaps);                                  
+   collimator_log->SetVisAttributes(collimator_vis);
+}
+//______________________________________________________________________________
+
+G4GenericTrap * B1DetectorConstruction::BuildRegionTrap() const
+{
+   std::vector< G4TwoVector> trap_points = {
+      {-103.734*mm, 179.672 *mm},
+      {-1625.95*mm, 3172.94 *mm},
+      {1625.95 *mm, 3172.94 *mm},
+      {103.734 *mm, 179.672 *mm},
+      {-103.734*mm, -2.42984*mm},
+      {-1683.74*mm, 3103.61 *mm},
+      {1683.74 *mm, 3103.61 *mm},
+      {103.734 *mm, -2.42984*mm}
+   };
+   return new G4GenericTrap("R1trap_solid", trap_width/2.0, trap_points);
+}
+//______________________________________________________________________________
+
+G4VSolid * B1DetectorConstruction::BuildRegionSolid(G4int mode) const
+{
+   G4GenericTrap * trap = BuildRegionTrap();
+
+   if( mode == kRegionGenericTrap ) {
+      // Same envelope, without the boolean
+      return trap;
+   }
+
+   if( mode == kRegionTessellated ) {
+      // Planar facets through the 8 vertices. This is exact when the trap is
+      // not twisted, otherwise each twisted side is split into two triangles.
+      std::vector<G4TwoVector> v  = trap->GetVertices();
+      G4double                 dz = trap->GetZHalfLength();
+      G4bool                   twisted = trap->IsTwisted();
+      delete trap;
+
+      G4ThreeVector b[4], t[4];
+      for(int i = 0; i < 4; i++) {
+         b[i] = G4ThreeVector(v[i].x(),   v[i].y(),   -dz);
+         t[i] = G4ThreeVector(v[i+4].x(), v[i+4].y(),  dz);
+      }
+      G4TessellatedSolid * tess = new G4TessellatedSolid("RI_tess_solid");
+      tess->AddFacet(new G4QuadrangularFacet(b[0], b[1], b[2], b[3], ABSOLUTE));
+      tess->AddFacet(new G4QuadrangularFacet(t[3], t[2], t[1], t[0], ABSOLUTE));
+      for(int i = 0; i < 4; i++) {
+         int j = (i+1)%4;
+         if(twisted) {
+            tess->AddFacet(new G4TriangularFacet(b[i], t[i], t[j], ABSOLUTE));
+            tess->AddFacet(new G4TriangularFacet(b[i], t[j], b[j], ABSOLUTE));
+         } else {
+            tess->AddFacet(new G4QuadrangularFacet(b[i], t[i], t[j], b[j], ABSOLUTE));
+         }
+      }
+      tess->SetSolidClosed(true);
+      return tess;
+   }
+
+   G4VSolid * temp_box    = new G4Box("DC_placement_box_solid",5*m,5*m,5*m);
+   //temp_region    = new G4Box("R1trap_solid_BOX", 4.0*m, 4.0*m, 1.0*m); 
+   return new G4IntersectionSolid("RI_solid", temp_box, trap, 0,  G4ThreeVector(0.0,0.0,trap_width/2.0) );
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::DeleteRegionSolid(G4VSolid * solid) const
+{
+   // The boolean solid does not own its box and trap, nor the displaced
+   // solid it wraps the trap in, and all of them are in the solid store.
+   G4BooleanSolid * boolean = dynamic_cast<G4BooleanSolid*>(solid);
+   if( !boolean ) {
+      delete solid;
+      return;
+   }
+   G4VSolid         * box       = boolean->GetConstituentSolid(0);
+   G4VSolid         * trap      = boolean->GetConstituentSolid(1);
+   G4DisplacedSolid * displaced = dynamic_cast<G4DisplacedSolid*>(trap);
+   if( displaced ) trap = displaced->GetConstituentMovedSolid();
+   delete boolean;
+   delete displaced;
+   delete box;
+   delete trap;
+}
+//______________________________________________________________________________
+
+G4ThreeVector B1DetectorConstruction::GetRegionOffset() const
+{
+   // The boolean solid has its frame at the box centre, with the trap shifted
+   // by half its width. The direct solids are placed at the trap centre.
+   if( fRegionSolidMode == kRegionBoolean ) return G4ThreeVector();
+   return G4ThreeVector(0.0, 0.0, trap_width/2.0);
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::SetRegionSolid(G4String mode)
+{
+   if(      mode == "boolean"     ) fRegionSolidMode = kRegionBoolean;
+   else if( mode == "generictrap" ) fRegionSolidMode = kRegionGenericTrap;
+   else if( mode == "tessellated" ) fRegionSolidMode = kRegionTessellated;
+   else {
+      G4ExceptionDescription msg;
+      msg << "Unknown region solid mode " << mode;
+      G4Exception("B1DetectorConstruction::SetRegionSolid()", "B1Det0001", JustWarning, msg);
+      return;
+   }
+   if(fHasBeenBuilt) Rebuild(kRebuildCollimator);
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::BenchmarkRegionSolids(G4int npoints) const
+{
+   // Cross-check the direct solids against the boolean solid and time the
+   // navigation calls of each of them.
+   const char * names[3] = {"boolean", "generictrap", "tessellated"};
+   G4VSolid   * solids[3];
+   for(int i = 0; i < 3; i++) solids[i] = BuildRegionSolid(i);
+
+   G4ThreeVector    offset(0.0, 0.0, trap_width/2.0);
+   B1SolidBenchmark bench(npoints);
+
+   G4cout << "------------------------------------------------------------------------\n";
+   G4cout << " Region solid benchmark (" << npoints << " points)\n";
+   G4cout << std::setw(14) << "solid"
+      << std::setw(14) << "Inside/s"
+      << std::setw(16) << "DistToIn/s"
+      << std::setw(16) << "DistToOut/s"
+      << std::setw(12) << "mismatch"
+      << std::setw(16) << "max |dd| (mm)" << G4endl;
+
+   for(int i = 0; i < 3; i++) {
+      B1SolidBenchmark::Rates      r = bench.Benchmark(solids[i]);
+      B1SolidBenchmark::Comparison c = {0, 0, 0, 0.0};
+      if(i > 0) c = bench.Compare(solids[0], solids[i], offset, 1.0*um);
+      G4cout << std::setw(14) << names[i]
+         << std::setw(14) << r.inside
+         << std::setw(16) << r.distToIn
+         << std::setw(16) << r.distToOut
+         << std::setw(12) << c.nInsideMismatch + c.nDistMismatch
+         << std::setw(16) << c.maxDistDiff/mm << G4endl;
+   }
+   for(int i = 0; i < 3; i++) DeleteRegionSolid(solids[i]);
+}
+//______________________________________________________________________________
+
+G4int B1DetectorConstruction::CheckOverlaps(G4int npoints, G4int nthreads, G4double maxTime) const
+{
+   // checkOverlaps stays false in Construct(): the serial G4PVPlacement
+   // check is far too slow for the wire plane.
+   if(!world_log) return 0;
+
+   B1OverlapChecker checker;
+   checker.SetPointsPerVolume(npoints);
+   if(nthreads > 0) checker.SetNumberOfThreads(nthreads);
+   checker.SetTimeBudget(maxTime);
+
+   B1OverlapChecker::Result r = checker.Check({world_log, collimator_log});
+   B1OverlapChecker::Print(r);
+   return r.overlaps.size();
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::ConstructRegions()
+{
+   // The logical volumes of the radiator and of the chamber are the roots of
+   // their regions. Rebuilt volumes are added again; deleted ones remove
+   // themselves from their region.
+   G4RegionStore * store    = G4RegionStore::GetInstance();
+   G4Region      * radiator = store->FindOrCreateRegion("Radiator");
+   G4Region      * chamber  = store->FindOrCreateRegion("Chamber");
+
+   if( !radiator_log->IsRootRegion() ) radiator->AddRootLogicalVolume(radiator_log);
+   if( !collimator_log->IsRootRegion() ) chamber->AddRootLogicalVolume(collimator_log);
+   if( fRegionCuts[kRadiatorRegion] ) radiator->SetProductionCuts(fRegionCuts[kRadiatorRegion]);
+   if( fRegionCuts[kChamberRegion]  ) chamber->SetProductionCuts(fRegionCuts[kChamberRegion]);
+
+   // User limits are looked up on the logical volume of the track, so they
+   // are set on every volume of the region.
+   G4LogicalVolume * roots[3] = { radiator_log, collimator_log, world_log };
+   for(int i = 0; i < 3; i++) {
+      std::vector<G4LogicalVolume*> volumes(1, roots[i]);
+      while( !volumes.empty() ) {
+         G4LogicalVolume * lv = volumes.back();
+         volumes.pop_back();
+         lv->SetUserLimits(fRegionLimits[i]);
+         for(int j = 0; j < lv->GetNoDaughters(); j++) {
+            G4LogicalVolume * daughter = lv->GetDaughter(j)->GetLogicalVolume();
+            if( !daughter->IsRootRegion() ) volumes.push_back(daughter);
+         }
+      }
+   }
+}
+//______________________________________________________________________________
+
+G4int B1DetectorConstruction::FindRegionIndex(const G4String& name) const
+{
+   if( name == "Radiator" ) return kRadiatorRegion;
+   if( name == "Chamber"  ) return kChamberRegion;
+   if( name == "World"    ) return kWorldRegion;
+   G4ExceptionDescription msg;
+   msg << "Unknown region " << name << " (Radiator, Chamber or World)";
+   G4Exception("B1DetectorConstruction::FindRegionIndex()", "B1Det0003", JustWarning, msg);
+   return -1;
+}
+//______________________________________________________________________________
+
+G4UserLimits * B1DetectorConstruction::GetRegionLimits(G4int index)
+{
+   if(!fRegionLimits[index]) {
+      fRegionLimits[index] = new G4UserLimits();
+      if(fHasBeenBuilt) ConstructRegions();
+   }
+   return fRegionLimits[index];
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::SetRegionCut(G4String region, G4String particle, G4double cut)
+{
+   G4int index = FindRegionIndex(region);
+   if(index < 0) return;
+
+   // The default cuts are set from the physics list at /run/initialize,
+   // which would overwrite World cuts given before it.
+   G4ApplicationState state = G4StateManager::GetStateManager()->GetCurrentState();
+   if( index == kWorldRegion && state == G4State_PreInit ) {
+      G4ExceptionDescription msg;
+      msg << "The World cuts can only be changed after /run/initialize (use /run/setCut before it)";
+      G4Exception("B1DetectorConstruction::SetRegionCut()", "B1Det0004", JustWarning, msg);
+      return;
+   }
+
+   G4ProductionCuts * cuts = 0;
+   if( index == kWorldRegion ) {
+      cuts = G4ProductionCutsTable::GetProductionCutsTable()->GetDefaultProductionCuts();
+   } else {
+      if(!fRegionCuts[index]) {
+         // Start from the current default cuts. Before /run/initialize these
+         // are still zero, so the physics list default cut value is used.
+         fRegionCuts[index] = new G4ProductionCuts(
+            *G4ProductionCutsTable::GetProductionCutsTable()->GetDefaultProductionCuts());
+         const G4VUserPhysicsList * physics = G4RunManager::GetRunManager()->GetUserPhysicsList();
+         const char * names[4] = { "gamma", "e-", "e+", "proton" };
+         for(int i = 0; physics && i < 4; i++) {
+            if( fRegionCuts[index]->GetProductionCut(names[i]) <= 0.0 ) {
+               fRegionCuts[index]->SetProductionCut(physics->GetDefaultCutValue(), names[i]);
+            }
+         }
+      }
+      cuts = fRegionCuts[index];
+   }
+
+   if( particle == "all" ) cuts->SetProductionCut(cut);
+   else                    cuts->SetProductionCut(cut, particle);
+
+   if(fHasBeenBuilt) ConstructRegions();
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::SetRegionStepMax(G4String region, G4double l)
+{
+   G4int index = FindRegionIndex(region);
+   if(index >= 0) GetRegionLimits(index)->SetMaxAllowedStep(l);
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::SetRegionMinEkin(G4String region, G4double e)
+{
+   G4int index = FindRegionIndex(region);
+   if(index >= 0) GetRegionLimits(index)->SetUserMinEkine(e);
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::SetRegionMaxTime(G4String region, G4double t)
+{
+   G4int index = FindRegionIndex(region);
+   if(index >= 0) GetRegionLimits(index)->SetUserMaxTime(t);
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::PrintRegions() const
+{
+   const char       * names[3] = { "Radiator", "Chamber", "World" };
+   G4ProductionCuts * defaults = G4ProductionCutsTable::GetProductionCutsTable()->GetDefaultProductionCuts();
+   G4Track            dummy;
+
+   G4cout << "------------------------------------------------------------------------\n";
+   G4cout << std::setw(10) << "region"
+      << std::setw(12) << "gamma (mm)"
+      << std::setw(12) << "e- (mm)"
+      << std::setw(12) << "e+ (mm)"
+      << std::setw(14) << "proton (mm)"
+      << std::setw(14) << "step (mm)"
+      << std::setw(14) << "Ekin (MeV)"
+      << std::setw(12) << "time (ns)" << G4endl;
+   for(int i = 0; i < 3; i++) {
+      G4ProductionCuts * cuts = fRegionCuts[i] ? fRegionCuts[i] : defaults;
+      G4cout << std::setw(10) << names[i]
+         << std::setw(12) << cuts->GetProductionCut("gamma")/mm
+         << std::setw(12) << cuts->GetProductionCut("e-")/mm
+         << std::setw(12) << cuts->GetProductionCut("e+")/mm
+         << std::setw(14) << cuts->GetProductionCut("proton")/mm;
+      if( fRegionLimits[i] ) {
+         G4cout << std::setw(14) << fRegionLimits[i]->GetMaxAllowedStep(dummy)/mm
+            << std::setw(14) << fRegionLimits[i]->GetUserMinEkine(dummy)/MeV
+            << std::setw(12) << fRegionLimits[i]->GetUserMaxTime(dummy)/ns;
+      } else {
+         G4cout << std::setw(14) << "-" << std::setw(14) << "-" << std::setw(12) << "-";
+      }
+      G4cout << G4endl;
+   }
+}
+//______________________________________________________________________________
+
+G4LogicalVolume * B1DetectorConstruction::FindLogicalVolume(const G4String& name) const
+{
+   for(auto lv : *G4LogicalVolumeStore::GetInstance()) {
+      if( lv->GetName() == name ) return lv;
+   }
+   G4ExceptionDescription msg;
+   msg << "No logical volume named " << name;
+   G4Exception("B1DetectorConstruction::FindLogicalVolume()", "B1Det0002", JustWarning, msg);
+   return 0;
+}
+//______________________________________________________________________________
+
+G4double B1DetectorConstruction::ReoptimiseVolume(G4LogicalVolume * lv) const
+{
+   // Opening/closing the geometry at a daughter rebuilds the voxels of its
+   // mother (lv) and of the subtree below it. While the geometry is open the
+   // new settings are picked up when the run manager closes it.
+   G4GeometryManager * geoman = G4GeometryManager::GetInstance();
+   if( !geoman->IsGeometryClosed() || lv->GetNoDaughters() == 0 ) return 0.0;
+
+   G4Timer timer;
+   timer.Start();
+   geoman->OpenGeometry(lv->GetDaughter(0));
+   geoman->CloseGeometry(true, false, lv->GetDaughter(0));
+   timer.Stop();
+   return timer.GetRealElapsed();
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::SetSmartless(G4String volume, G4double smartless)
+{
+   G4LogicalVolume * lv = FindLogicalVolume(volume);
+   if(!lv) return;
+   lv->SetSmartless(smartless);
+   ReoptimiseVolume(lv);
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::SetVoxelOptimisation(G4String volume, G4bool val)
+{
+   G4LogicalVolume * lv = FindLogicalVolume(volume);
+   if(!lv) return;
+   lv->SetOptimisation(val);
+   ReoptimiseVolume(lv);
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::PrintVoxelInfo(G4String volume) const
+{
+   G4LogicalVolume * lv = FindLogicalVolume(volume);
+   if(!lv) return;
+
+   G4cout << " " << lv->GetName() << " : " << lv->GetNoDaughters() << " daughters"
+      << ", optimised " << lv->IsToOptimise()
+      << ", smartless " << lv->GetSmartless();
+   if( lv->GetVoxelHeader() ) {
+      G4SmartVoxelStat stat(lv, lv->GetVoxelHeader(), 0.0, 0.0);
+      G4cout << ", " << stat.GetNumberHeads() << " heads, " << stat.GetNumberNodes() << " nodes, "
+         << stat.GetMemoryUse()/1024.0 << " kB";
+   } else {
+      G4cout << ", no voxels";
+   }
+   G4cout << G4endl;
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::TuneSmartless(G4String volume, G4double smin, G4double smax,
+                                           G4int nvalues, G4int ntracks)
+{
+   G4LogicalVolume * lv = FindLogicalVolume(volume);
+   if(!lv || !world_phys) return;
+
+   // Navigation needs closed (voxelised) geometry. It is left as it was found.
+   G4GeometryManager * geoman = G4GeometryManager::GetInstance();
+   G4bool              closed = geoman->IsGeometryClosed();
+   if(!closed) geoman->CloseGeometry(true);
+
+   // Isotropic geantinos from the middle of the wire plane cross most wires
+   G4double      wire_z = trap_width/2.0 - GetRegionOffset().z();
+   G4ThreeVector source = collimator_phys->GetTranslation()
+      + G4ThreeVector(0.0, wire_y0 + fNWires*wire_spacing/2.0, wire_z);
+
+   B1NavigationBenchmark bench(world_phys);
+   bench.SetPattern(B1NavigationBenchmark::kIsotropic);
+   bench.SetNumberOfTracks(ntracks);
+   bench.SetOrigin(source);
+   bench.SetSpotHalfWidth(wire_spacing);
+
+   G4double original   = lv->GetSmartless();
+   G4double best       = original;
+   G4double best_time  = -1.0;
+
+   G4cout << "------------------------------------------------------------------------\n";
+   G4cout << " Smartless tuning of " << lv->GetName() << " (" << ntracks << " tracks)\n";
+   G4cout << std::setw(12) << "smartless"
+      << std::setw(10) << "heads"
+      << std::setw(10) << "nodes"
+      << std::setw(14) << "memory (kB)"
+      << std::setw(14) << "build (ms)"
+      << std::setw(14) << "steps"
+      << std::setw(12) << "ns/step" << G4endl;
+
+   for(int i = 0; i < nvalues; i++) {
+      G4double smartless = (nvalues > 1) ? smin + i*(smax - smin)/(nvalues - 1) : smin;
+      lv->SetSmartless(smartless);
+      G4double build_time = ReoptimiseVolume(lv);
+
+      G4long heads = 0, nodes = 0, memory = 0;
+      if( lv->GetVoxelHeader() ) {
+         G4SmartVoxelStat stat(lv, lv->GetVoxelHeader(), 0.0, 0.0);
+         heads  = stat.GetNumberHeads();
+         nodes  = stat.GetNumberNodes();
+         memory = stat.GetMemoryUse();
+      }
+      B1NavigationBenchmark::Result r = bench.Run();
+      G4double ns_per_step = (r.steps > 0) ? 1.0e9*r.massTime/r.steps : 0.0;
+
+      G4cout << std::setw(12) << smartless
+         << std::setw(10) << heads
+         << std::setw(10) << nodes
+         << std::setw(14) << memory/1024.0
+         << std::setw(14) << build_time*1000.0
+         << std::setw(14) << r.steps
+         << std::setw(12) << ns_per_step << G4endl;
+
+      if( best_time < 0.0 || ns_per_step < best_time ) {
+         best_time = ns_per_step;
+         best      = smartless;
+      }
+   }
+
+   lv->SetSmartless(best);
+   ReoptimiseVolume(lv);
+   G4cout << " " << lv->GetName() << " smartless set to " << best
+      << " (was " << original << ")" << G4endl;
+
+   if(!closed) geoman->OpenGeometry();
+}
+//______________________________________________________________________________
+//______________________________________________________________________________
+
+void B1DetectorConstruction::ClearWires()
+{
+   if(fWireParam) {
+      collimator_log->RemoveDaughter(collimator2_phys);
+      delete collimator2_phys;
+      delete collimator2_log;
+      delete collimator2_solid;
+      delete fWireParam;
+      fWireParam = 0;
+   }
+   for(auto pv : fWirePlacements) {
+      collimator_log->RemoveDaughter(pv);
+      delete pv->GetLogicalVolume()->GetSolid();
+      delete pv->GetLogicalVolume();
+      delete pv;
+   }
+   fWirePlacements.clear();
+   if(fWireRotation) {
+      delete fWireRotation;
+      fWireRotation = 0;
+   }
+   collimator2_phys  = 0;
+   collimator2_log   = 0;
+   collimator2_solid = 0;
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::ConstructWires()
+{
+   // The wire plane is built either as a single parameterised volume (default)
+   // or as one placement per wire, which is kept for benchmark comparisons.
+   ClearWires();
+
+   // wires sit in the middle of the trap, whichever frame the region uses
+   double wire_z = trap_width/2.0 - GetRegionOffset().z();
+
+   if(fUseWireParameterisation) {
+      fWireParam = new B1WireParameterisation(fNWires, wire_spacing, wire_angle,
+                                              wire_length0, wire_y0, wire_z);
+
+      // Dimensions are set per copy by the parameterisation
+      collimator2_solid = new G4Box("wire_box", fWireParam->GetWireHalfWidth(),
+                                    fWireParam->GetWireHalfWidth(), wire_length0/2.0);
+      collimator2_log   = new G4LogicalVolume(collimator2_solid, collimator2_mat, "collimator2_log");
+      collimator2_phys  = new G4PVParameterised("collimator2_phys", collimator2_log, collimator_log,
+                                                kUndefined, fNWires, fWireParam, false);
+      collimator2_log->SetVisAttributes(collimator2_vis);
+      return;
+   }
+
+   fWireRotation = new G4RotationMatrix();
+   fWireRotation->rotateY(90.0*degree);
+
+   double sin_angle = sin(wire_angle);
+
+   for(int iWire = 0; iWire < fNWires; iWire ++ ) {
+      double deltaL     = iWire*wire_spacing/sin_angle;
+      double hex_length = wire_length0 + deltaL ;
+      double y_position = wire_y0 + wire_spacing/2.0 + iWire*wire_spacing;
+
+      collimator2_pos = {0.0, y_position, wire_z};
+
+      collimator2_solid = new G4Box("wire_box",wire_spacing/3.0,wire_spacing/3.0, hex_length/2.0 );
+      collimator2_log   = new G4LogicalVolume(collimator2_solid, collimator2_mat,"collimator2_log");
+      collimator2_phys  = new G4PVPlacement(fWireRotation,collimator2_pos, collimator2_log, "collimator2_phys",collimator_log,false,iWire,false);
+
+      collimator2_log->SetVisAttributes(collimator2_vis);
+      fWirePlacements.push_back(collimator2_phys);
+   }
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::SetNumberOfWires(G4int n)
+{
+   fNWires = n;
+   if(fHasBeenBuilt) Rebuild(kRebuildWires);
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::SetWireSpacing(G4double l)
+{
+   wire_spacing = l;
+   if(fHasBeenBuilt) Rebuild(kRebuildWires);
+}
+//______________________________________________________________________________
+
+void B1DetectorConstruction::SetWireParameterisation(G4bool val)
+{
+   fUseWireParameterisation = val;
+   if(fHasBeenBuilt) Rebuild(kRebuildWires);
+}
+//______________________________________________________________________________
+
 void B1DetectorConstruction::SetCollimatorMaterial(G4String materialName)
 {
    fCollimatorMatName = materialName;
-   if(fHasBeenBuilt) Rebuild();
+   if(fHasBeenBuilt) Rebuild(kRebuildNone);
 }
 //______________________________________________________________________________
 
 void     B1DetectorConstruction::SetRadiatorCollimatorGap(G4double l)
 {   
    radiator_collimator_gap = l; 
-   if(fHasBeenBuilt) Rebuild();
+   if(fHasBeenBuilt) Rebuild(kRebuildPositions);
 }
 //______________________________________________________________________________
 
@@ -479,34 +1164,34 @@ void     B1DetectorConstruction::SetInnerCollimatorOD(G4double l)
 {   
    collimator_OD       = l;
    outer_collimator_ID = l;
-   if(fHasBeenBuilt) Rebuild();
+   if(fHasBeenBuilt) Rebuild(kRebuildNone);
 }
 //______________________________________________________________________________
 
 void     B1DetectorConstruction::SetInnerCollimatorUpstreamID(G4double l)
 {   
    collimator_upstream_ID       = l;
-   if(fHasBeenBuilt) Rebuild();
+   if(fHasBeenBuilt) Rebuild(kRebuildNone);
 }
 //______________________________________________________________________________
 
 void     B1DetectorConstruction::SetInnerCollimatorDownstreamID(G4double l)
 {   
    collimator_downstream_ID       = l;
-   if(fHasBeenBuilt) Rebuild();
+   if(fHasBeenBuilt) Rebuild(kRebuildNone);
 }
 //______________________________________________________________________________
 void     B1DetectorConstruction::SetCollimatorLength(G4double l)
 {   
    collimator_length = l;
-   if(fHasBeenBuilt) Rebuild();
+   if(fHasBeenBuilt) Rebuild(kRebuildPositions);
 }
 //______________________________________________________________________________
 
 void     B1DetectorConstruction::SetCollimatorToothSlope(G4double l)
 {   
    collimator_tooth_slope = l;
-   if(fHasBeenBuilt) Rebuild();
+   if(fHasBeenBuilt) Rebuild(kRebuildNone);
 }
 //______________________________________________________________________________
 
@@ -529,7 +1214,11 @@ void     B1DetectorConstruction::PrintConfigInfo() const
          << "           collimator OD  : " << collimator_OD/cm                 << " cm\n"
          << " radiator collimator gap  : " << radiator_collimator_gap/cm       << " cm\n"
          << "  collimator target dist  : " << collimator_target_center_gap/cm  << " cm\n"
-         << "      radiator thickness  : " << radiator_thickness/cm            << " cm\n";
+         << "      radiator thickness  : " << radiator_thickness/cm            << " cm\n"
+         << "         number of wires  : " << fNWires                          << "\n"
+         << "            wire spacing  : " << wire_spacing/cm                  << " cm\n"
+         << "      wire parameterised  : " << fUseWireParameterisation         << "\n"
+         << "       region solid mode  : " << fRegionSolidMode                 << "\n";
    } else {
       std::cout << " detector not built yet" << std::endl;
    }
@@ -1,11 +1,17 @@
 #include "B1DetectorMessenger.hh"
 #include "B1DetectorConstruction.hh"
+#include "B1MaterialRegistry.hh"
 
 #include "G4UIdirectory.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithADouble.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
 #include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include <sstream>
 
 //______________________________________________________________________________
 
@@ -69,6 +75,150 @@ B1DetectorMessenger::B1DetectorMessenger(B1DetectorConstruction* Det) :
   fRadiatorCollimatorGapCmd->SetUnitCategory("Length");
   fRadiatorCollimatorGapCmd->AvailableForStates(G4State_Idle);
 
+  fNumberOfWiresCmd = new G4UIcmdWithAnInteger("/B1/det/setNumberOfWires",this);
+  fNumberOfWiresCmd->SetGuidance("Set the number of wires in the drift chamber wire plane.");
+  fNumberOfWiresCmd->SetParameterName("n",false);
+  fNumberOfWiresCmd->SetRange("n>0");
+  fNumberOfWiresCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fWireSpacingCmd = new G4UIcmdWithADoubleAndUnit("/B1/det/setWireSpacing",this);
+  fWireSpacingCmd->SetGuidance("Set the center to center spacing of the wires.");
+  fWireSpacingCmd->SetParameterName("spacing",false);
+  fWireSpacingCmd->SetUnitCategory("Length");
+  fWireSpacingCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fWireParameterisationCmd = new G4UIcmdWithABool("/B1/det/setWireParameterisation",this);
+  fWireParameterisationCmd->SetGuidance("Build the wire plane as one parameterised volume (true, default)");
+  fWireParameterisationCmd->SetGuidance("or as one logical volume and placement per wire (false).");
+  fWireParameterisationCmd->SetParameterName("param",false);
+  fWireParameterisationCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fRegionSolidCmd = new G4UIcmdWithAString("/B1/det/setRegionSolid",this);
+  fRegionSolidCmd->SetGuidance("Select how the drift chamber region solid is built:");
+  fRegionSolidCmd->SetGuidance("  boolean     : 5 m box intersected with the generic trap (default)");
+  fRegionSolidCmd->SetGuidance("  generictrap : the generic trap alone, same envelope");
+  fRegionSolidCmd->SetGuidance("  tessellated : planar facets through the trap vertices");
+  fRegionSolidCmd->SetParameterName("mode",false);
+  fRegionSolidCmd->SetCandidates("boolean generictrap tessellated");
+  fRegionSolidCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fBenchmarkRegionSolidCmd = new G4UIcmdWithAnInteger("/B1/det/benchmarkRegionSolid",this);
+  fBenchmarkRegionSolidCmd->SetGuidance("Time Inside/DistanceToIn/DistanceToOut for each region solid mode");
+  fBenchmarkRegionSolidCmd->SetGuidance("and cross-check the direct solids against the boolean solid.");
+  fBenchmarkRegionSolidCmd->SetParameterName("npoints",true);
+  fBenchmarkRegionSolidCmd->SetDefaultValue(100000);
+  fBenchmarkRegionSolidCmd->SetRange("npoints>0");
+  fBenchmarkRegionSolidCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fSmartlessCmd = new G4UIcommand("/B1/det/setSmartless",this);
+  fSmartlessCmd->SetGuidance("Set the smartless value (average slices per daughter) used to");
+  fSmartlessCmd->SetGuidance("voxelise a logical volume (Geant4 default 2).");
+  G4UIparameter * volumeParam = new G4UIparameter("volume",'s',true);
+  volumeParam->SetDefaultValue("collimator_log");
+  fSmartlessCmd->SetParameter(volumeParam);
+  G4UIparameter * smartlessParam = new G4UIparameter("smartless",'d',false);
+  smartlessParam->SetParameterRange("smartless>0");
+  fSmartlessCmd->SetParameter(smartlessParam);
+  fSmartlessCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fVoxelOptimisationCmd = new G4UIcommand("/B1/det/setVoxelOptimisation",this);
+  fVoxelOptimisationCmd->SetGuidance("Enable or disable smart voxels for the daughters of a logical volume.");
+  volumeParam = new G4UIparameter("volume",'s',true);
+  volumeParam->SetDefaultValue("collimator_log");
+  fVoxelOptimisationCmd->SetParameter(volumeParam);
+  fVoxelOptimisationCmd->SetParameter(new G4UIparameter("optimise",'b',false));
+  fVoxelOptimisationCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fPrintVoxelInfoCmd = new G4UIcmdWithAString("/B1/det/printVoxelInfo",this);
+  fPrintVoxelInfoCmd->SetGuidance("Print the voxel settings, heads, nodes and memory of a logical volume.");
+  fPrintVoxelInfoCmd->SetParameterName("volume",true);
+  fPrintVoxelInfoCmd->SetDefaultValue("collimator_log");
+  fPrintVoxelInfoCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fTuneSmartlessCmd = new G4UIcommand("/B1/det/tuneSmartless",this);
+  fTuneSmartlessCmd->SetGuidance("Voxelise a logical volume with nvalues smartless values from min to max,");
+  fTuneSmartlessCmd->SetGuidance("time geantino navigation from the wire plane for each, print the voxel");
+  fTuneSmartlessCmd->SetGuidance("memory and timing, and keep the fastest value.");
+  volumeParam = new G4UIparameter("volume",'s',true);
+  volumeParam->SetDefaultValue("collimator_log");
+  fTuneSmartlessCmd->SetParameter(volumeParam);
+  G4UIparameter * minParam = new G4UIparameter("min",'d',true);
+  minParam->SetDefaultValue(0.5);
+  fTuneSmartlessCmd->SetParameter(minParam);
+  G4UIparameter * maxParam = new G4UIparameter("max",'d',true);
+  maxParam->SetDefaultValue(8.0);
+  fTuneSmartlessCmd->SetParameter(maxParam);
+  G4UIparameter * nvaluesParam = new G4UIparameter("nvalues",'i',true);
+  nvaluesParam->SetDefaultValue(16);
+  nvaluesParam->SetParameterRange("nvalues>0");
+  fTuneSmartlessCmd->SetParameter(nvaluesParam);
+  G4UIparameter * ntracksParam = new G4UIparameter("ntracks",'i',true);
+  ntracksParam->SetDefaultValue(20000);
+  ntracksParam->SetParameterRange("ntracks>0");
+  fTuneSmartlessCmd->SetParameter(ntracksParam);
+  fTuneSmartlessCmd->AvailableForStates(G4State_Idle);
+
+  fCheckOverlapsCmd = new G4UIcommand("/B1/det/checkOverlaps",this);
+  fCheckOverlapsCmd->SetGuidance("Check the world and drift chamber daughters for overlaps, sampling");
+  fCheckOverlapsCmd->SetGuidance("npoints surface points per volume on nthreads threads (0: all cores).");
+  fCheckOverlapsCmd->SetGuidance("The check stops after the given number of seconds (0: no limit).");
+  G4UIparameter * npointsParam = new G4UIparameter("npoints",'i',true);
+  npointsParam->SetDefaultValue(1000);
+  npointsParam->SetParameterRange("npoints>0");
+  fCheckOverlapsCmd->SetParameter(npointsParam);
+  G4UIparameter * nthreadsParam = new G4UIparameter("nthreads",'i',true);
+  nthreadsParam->SetDefaultValue(0);
+  nthreadsParam->SetParameterRange("nthreads>=0");
+  fCheckOverlapsCmd->SetParameter(nthreadsParam);
+  G4UIparameter * secondsParam = new G4UIparameter("seconds",'d',true);
+  secondsParam->SetDefaultValue(30.0);
+  secondsParam->SetParameterRange("seconds>=0");
+  fCheckOverlapsCmd->SetParameter(secondsParam);
+  fCheckOverlapsCmd->AvailableForStates(G4State_Idle);
+
+  fRegionCutCmd = new G4UIcommand("/B1/det/setRegionCut",this);
+  fRegionCutCmd->SetGuidance("Set the production cut of a particle (or all) in a region.");
+  fRegionCutCmd->SetGuidance("The World cuts are the default cuts and can only be set after /run/initialize.");
+  fRegionCutCmd->SetGuidance("Other regions start from the physics list default cut.");
+  G4UIparameter * regionParam = new G4UIparameter("region",'s',false);
+  regionParam->SetParameterCandidates("Radiator Chamber World");
+  fRegionCutCmd->SetParameter(regionParam);
+  G4UIparameter * particleParam = new G4UIparameter("particle",'s',false);
+  particleParam->SetParameterCandidates("gamma e- e+ proton all");
+  fRegionCutCmd->SetParameter(particleParam);
+  G4UIparameter * cutParam = new G4UIparameter("cut",'d',false);
+  cutParam->SetParameterRange("cut>=0");
+  fRegionCutCmd->SetParameter(cutParam);
+  G4UIparameter * cutUnitParam = new G4UIparameter("unit",'s',true);
+  cutUnitParam->SetDefaultValue("mm");
+  cutUnitParam->SetParameterCandidates(G4UIcommand::UnitsList("Length"));
+  fRegionCutCmd->SetParameter(cutUnitParam);
+  fRegionCutCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fRegionStepMaxCmd = MakeRegionCommand("setRegionStepMax", "Set the maximum step length in a region.", "mm");
+  fRegionMinEkinCmd = MakeRegionCommand("setRegionMinEkin", "Kill tracks below this kinetic energy in a region.", "MeV");
+  fRegionMaxTimeCmd = MakeRegionCommand("setRegionMaxTime", "Kill tracks after this global time in a region.", "ns");
+
+  fPrintRegionsCmd = new G4UIcmdWithoutParameter("/B1/det/printRegions",this);
+  fPrintRegionsCmd->SetGuidance("Print the production cuts and user limits of the regions.");
+  fPrintRegionsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fPrintMaterialsCmd = new G4UIcmdWithoutParameter("/B1/det/printMaterials",this);
+  fPrintMaterialsCmd->SetGuidance("Print the cached materials and the size of the material table.");
+  fPrintMaterialsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fUseSnapshotCmd = new G4UIcmdWithABool("/B1/det/useSnapshot",this);
+  fUseSnapshotCmd->SetGuidance("Load the geometry from a binary snapshot written by a previous job");
+  fUseSnapshotCmd->SetGuidance("with the same parameters, or write one after building it.");
+  fUseSnapshotCmd->SetParameterName("use",true);
+  fUseSnapshotCmd->SetDefaultValue(true);
+  fUseSnapshotCmd->AvailableForStates(G4State_PreInit);
+
+  fSnapshotDirCmd = new G4UIcmdWithAString("/B1/det/setSnapshotDir",this);
+  fSnapshotDirCmd->SetGuidance("Directory of the geometry snapshots (default: current directory).");
+  fSnapshotDirCmd->SetParameterName("dir",false);
+  fSnapshotDirCmd->AvailableForStates(G4State_PreInit);
+
   fTargMatCmd = new G4UIcmdWithAString("/B1/det/setTargetMaterial",this);
   fTargMatCmd->SetGuidance("Select Material of the Target.");
   fTargMatCmd->SetParameterName("choice",false);
@@ -87,6 +237,27 @@ B1DetectorMessenger::B1DetectorMessenger(B1DetectorConstruction* Det) :
 }
 //______________________________________________________________________________
 
+G4UIcommand * B1DetectorMessenger::MakeRegionCommand(const G4String& name, const G4String& guidance,
+                                                     const G4String& defaultUnit)
+{
+  G4String      path = "/B1/det/" + name;
+  G4UIcommand * cmd  = new G4UIcommand(path,this);
+  cmd->SetGuidance(guidance);
+  G4UIparameter * regionParam = new G4UIparameter("region",'s',false);
+  regionParam->SetParameterCandidates("Radiator Chamber World");
+  cmd->SetParameter(regionParam);
+  G4UIparameter * valueParam = new G4UIparameter("value",'d',false);
+  valueParam->SetParameterRange("value>=0");
+  cmd->SetParameter(valueParam);
+  G4UIparameter * unitParam = new G4UIparameter("unit",'s',true);
+  unitParam->SetDefaultValue(defaultUnit);
+  unitParam->SetParameterCandidates(G4UIcommand::UnitsList(G4UIcommand::CategoryOf(defaultUnit)));
+  cmd->SetParameter(unitParam);
+  cmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  return cmd;
+}
+//______________________________________________________________________________
+
 B1DetectorMessenger::~B1DetectorMessenger()
 {
   delete fRadiatorMatCmd;
@@ -96,6 +267,24 @@ B1DetectorMessenger::~B1DetectorMessenger()
   delete fTargMatCmd;
   delete fChamMatCmd;
   delete fStepMaxCmd;
+  delete fNumberOfWiresCmd;
+  delete fWireSpacingCmd;
+  delete fWireParameterisationCmd;
+  delete fRegionSolidCmd;
+  delete fBenchmarkRegionSolidCmd;
+  delete fSmartlessCmd;
+  delete fVoxelOptimisationCmd;
+  delete fPrintVoxelInfoCmd;
+  delete fTuneSmartlessCmd;
+  delete fCheckOverlapsCmd;
+  delete fRegionCutCmd;
+  delete fRegionStepMaxCmd;
+  delete fRegionMinEkinCmd;
+  delete fRegionMaxTimeCmd;
+  delete fPrintRegionsCmd;
+  delete fPrintMaterialsCmd;
+  delete fUseSnapshotCmd;
+  delete fSnapshotDirCmd;
   delete fB1Directory;
   delete fDetDirectory;
 }
@@ -125,6 +314,97 @@ void B1DetectorMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
       fDetectorConstruction->SetInnerCollimatorOD( G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
    }
 
+   if( command == fNumberOfWiresCmd ) {
+      fDetectorConstruction->SetNumberOfWires( G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+   }
+
+   if( command == fWireSpacingCmd ) {
+      fDetectorConstruction->SetWireSpacing( G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+   }
+
+   if( command == fWireParameterisationCmd ) {
+      fDetectorConstruction->SetWireParameterisation( G4UIcmdWithABool::GetNewBoolValue(newValue));
+   }
+
+   if( command == fRegionSolidCmd ) {
+      fDetectorConstruction->SetRegionSolid(newValue);
+   }
+
+   if( command == fBenchmarkRegionSolidCmd ) {
+      fDetectorConstruction->BenchmarkRegionSolids( G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+   }
+
+   if( command == fSmartlessCmd ) {
+      G4String volume;
+      G4double smartless = 2.0;
+      std::istringstream is(newValue);
+      is >> volume >> smartless;
+      fDetectorConstruction->SetSmartless(volume, smartless);
+   }
+
+   if( command == fVoxelOptimisationCmd ) {
+      G4String volume, optimise;
+      std::istringstream is(newValue);
+      is >> volume >> optimise;
+      fDetectorConstruction->SetVoxelOptimisation(volume, G4UIcommand::ConvertToBool(optimise));
+   }
+
+   if( command == fPrintVoxelInfoCmd ) {
+      fDetectorConstruction->PrintVoxelInfo(newValue);
+   }
+
+   if( command == fTuneSmartlessCmd ) {
+      G4String volume;
+      G4double smin = 0.5, smax = 8.0;
+      G4int    nvalues = 16, ntracks = 20000;
+      std::istringstream is(newValue);
+      is >> volume >> smin >> smax >> nvalues >> ntracks;
+      fDetectorConstruction->TuneSmartless(volume, smin, smax, nvalues, ntracks);
+   }
+
+   if( command == fCheckOverlapsCmd ) {
+      G4int    npoints = 1000, nthreads = 0;
+      G4double seconds = 30.0;
+      std::istringstream is(newValue);
+      is >> npoints >> nthreads >> seconds;
+      fDetectorConstruction->CheckOverlaps(npoints, nthreads, seconds);
+   }
+
+   if( command == fRegionCutCmd ) {
+      G4String region, particle, unit;
+      G4double value = 0.0;
+      std::istringstream is(newValue);
+      is >> region >> particle >> value >> unit;
+      fDetectorConstruction->SetRegionCut(region, particle, value*G4UIcommand::ValueOf(unit));
+   }
+
+   if( command == fRegionStepMaxCmd || command == fRegionMinEkinCmd || command == fRegionMaxTimeCmd ) {
+      G4String region, unit;
+      G4double value = 0.0;
+      std::istringstream is(newValue);
+      is >> region >> value >> unit;
+      value *= G4UIcommand::ValueOf(unit);
+      if( command == fRegionStepMaxCmd ) fDetectorConstruction->SetRegionStepMax(region, value);
+      if( command == fRegionMinEkinCmd ) fDetectorConstruction->SetRegionMinEkin(region, value);
+      if( command == fRegionMaxTimeCmd ) fDetectorConstruction->SetRegionMaxTime(region, value);
+   }
+
+   if( command == fPrintRegionsCmd ) {
+      fDetectorConstruction->PrintRegions();
+   }
+
+   if( command == fPrintMaterialsCmd ) {
+      B1MaterialRegistry::Instance()->Print();
+   }
+
+   if( command == fUseSnapshotCmd ) {
+      fDetectorConstruction->SetUseSnapshot( G4UIcmdWithABool::GetNewBoolValue(newValue));
+   }
+
+   if( command == fSnapshotDirCmd ) {
+      fDetectorConstruction->SetSnapshotDir(newValue);
+   }
+
    if( command == fPrintConfigInfoCmd ) {
       fDetectorConstruction->PrintConfigInfo();
    }
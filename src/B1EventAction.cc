@@ -1,5 +1,10 @@
 #include "B1EventAction.hh"
 #include "B1Run.hh"
+#include "B1HitStream.hh"
+#include "B1PlaneCrossingScorer.hh"
+#include "B1ConvergenceMonitor.hh"
+#include "B1EventProfiler.hh"
+#include "B1StepProfiler.hh"
 
 #include "G4Event.hh"
 #include "G4RunManager.hh"
@@ -14,18 +19,30 @@ B1EventAction::~B1EventAction()
 {}
 //______________________________________________________________________________
 
-void B1EventAction::BeginOfEventAction(const G4Event*)
+void B1EventAction::BeginOfEventAction(const G4Event* event)
 {    
   fEdep = 0.;
+  if( B1HitStream::IsEnabled() ) B1HitStream::Instance()->BeginOfEvent(event->GetEventID());
+  if( B1EventProfiler::IsEnabled() ) B1EventProfiler::Instance()->BeginOfEvent();
+  if( B1StepProfiler::IsEnabled() ) B1StepProfiler::Instance()->BeginOfEvent();
 }
 //______________________________________________________________________________
 
-void B1EventAction::EndOfEventAction(const G4Event*)
+void B1EventAction::EndOfEventAction(const G4Event* event)
 {   
+  // first, so that the time does not include the end-of-event flushes
+  if( B1EventProfiler::IsEnabled() ) B1EventProfiler::Instance()->EndOfEvent(event);
+
+  if( B1PlaneCrossingScorer::IsEnabled() ) B1PlaneCrossingScorer::Instance()->EndOfEvent();
+  if( B1HitStream::IsEnabled() ) B1HitStream::Instance()->EndOfEvent();
+
+  // target precision reached (by any thread): finish this event and stop
+  if( B1ConvergenceMonitor::StopRequested() ) G4RunManager::GetRunManager()->AbortRun(true);
+
   // Called after G4Run::RecordEvent
   // accumulate statistics in B1Run
-  //B1Run* run = static_cast<B1Run*>( G4RunManager::GetRunManager()->GetNonConstCurrentRun());
-  //run->AddEdep(fEdep);
+  B1Run* run = static_cast<B1Run*>( G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  run->AddEdep(fEdep);
   //if( run->GetNumberOfEvent()%1000 == 0 ) std::cout << "EndOfEventAction\n";
 }
 //______________________________________________________________________________
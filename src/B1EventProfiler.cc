@@ -0,0 +1,227 @@
+#include "B1EventProfiler.hh"
+#include "B1HistogramStore.hh"
+#include "B1EventSeeds.hh"
+
+#include "G4Event.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "G4Threading.hh"
+#include "G4AutoLock.hh"
+
+#include <time.h>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <iomanip>
+
+namespace {
+   G4Mutex profilerMutex = G4MUTEX_INITIALIZER;
+
+   // log10(cpu time / s) bins of the quantiles: 10 per decade from 0.1 us
+   const G4int    kLogBins = 100;
+   const G4double kLogMin  = -7.0;
+}
+
+G4bool                             B1EventProfiler::fgEnabled  = false;
+G4int                              B1EventProfiler::fgNslow    = 10;
+std::vector<B1EventProfiler::SlowEvent> B1EventProfiler::fgSlowest;
+B1EventProfiler::Summary           B1EventProfiler::fgSummary  = { 0, 0.0, 0.0, std::vector<G4long>() };
+G4ThreadLocal B1EventProfiler    * B1EventProfiler::fgInstance = 0;
+
+//______________________________________________________________________________
+
+B1EventProfiler * B1EventProfiler::Instance()
+{
+   if( !fgInstance ) fgInstance = new B1EventProfiler();
+   return fgInstance;
+}
+//______________________________________________________________________________
+
+B1EventProfiler::B1EventProfiler() :
+   fBooked(false), fhCpu(-1), fhWall(-1), fhSteps(-1), fhCpuVsSteps(-1),
+   fCpu0(0.0), fWall0(0.0), fSteps(0), fTracks(0)
+{
+   fSummary.events = 0;
+   fSummary.cpu    = 0.0;
+   fSummary.wall   = 0.0;
+}
+//______________________________________________________________________________
+
+G4double B1EventProfiler::CpuTime()
+{
+   timespec ts;
+   clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+   return ts.tv_sec + 1.0e-9*ts.tv_nsec;
+}
+//______________________________________________________________________________
+
+G4double B1EventProfiler::WallTime()
+{
+   std::chrono::duration<double> t = std::chrono::steady_clock::now().time_since_epoch();
+   return t.count();
+}
+//______________________________________________________________________________
+
+G4int B1EventProfiler::LogBin(G4double t)
+{
+   if( !(t > 0.0) ) return 0;
+   G4int b = G4int(std::floor(10.0*(std::log10(t) - kLogMin)));
+   return std::min(std::max(b, 0), kLogBins - 1);
+}
+//______________________________________________________________________________
+
+G4double B1EventProfiler::Quantile(const Summary& s, G4double q)
+{
+   // upper edge of the bin that holds the quantile
+   G4long n = 0;
+   for(std::size_t b = 0; b < s.bins.size(); b++) {
+      n += s.bins[b];
+      if( n >= q*s.events ) return std::pow(10.0, kLogMin + 0.1*(b + 1));
+   }
+   return 0.0;
+}
+//______________________________________________________________________________
+
+void B1EventProfiler::Book()
+{
+   if( fBooked ) return;
+   B1HistogramStore * store = B1HistogramStore::Instance();
+   fhCpu        = store->CreateH1("/timing/cpu",  "log10(CPU time per event / s)",  100, -6, 3);
+   fhWall       = store->CreateH1("/timing/wall", "log10(wall time per event / s)", 100, -6, 3);
+   fhSteps      = store->CreateH1("/timing/steps","log10(steps per event)",          80,  0, 8);
+   fhCpuVsSteps = store->CreateH2("/timing/cpu_vs_steps","log10(CPU time / s) vs log10(steps)",
+                                  80, 0, 8, 90, -6, 3);
+   fBooked = true;
+}
+//______________________________________________________________________________
+
+void B1EventProfiler::BeginOfRun()
+{
+   fSlowest.clear();
+   fSummary.events = 0;
+   fSummary.cpu    = 0.0;
+   fSummary.wall   = 0.0;
+   fSummary.bins.assign(kLogBins, 0);
+
+   if( G4Threading::IsMasterThread() ) {
+      G4AutoLock lock(&profilerMutex);
+      fgSlowest.clear();
+      fgSummary = fSummary;
+   }
+}
+//______________________________________________________________________________
+
+void B1EventProfiler::BeginOfEvent()
+{
+   fSteps  = 0;
+   fTracks = 0;
+   fWall0  = WallTime();
+   fCpu0   = CpuTime();
+}
+//______________________________________________________________________________
+
+void B1EventProfiler::EndOfEvent(const G4Event * event)
+{
+   G4double cpu  = CpuTime()  - fCpu0;
+   G4double wall = WallTime() - fWall0;
+
+   B1HistogramStore * store = B1HistogramStore::Instance();
+   G4double lcpu   = std::log10(std::max(cpu,  1.0e-9));
+   G4double lsteps = std::log10(std::max(G4double(fSteps), 1.0));
+   store->FillH1(fhCpu,   lcpu);
+   store->FillH1(fhWall,  std::log10(std::max(wall, 1.0e-9)));
+   store->FillH1(fhSteps, lsteps);
+   store->FillH2(fhCpuVsSteps, lsteps, lcpu);
+
+   fSummary.events++;
+   fSummary.cpu  += cpu;
+   fSummary.wall += wall;
+   fSummary.bins[LogBin(cpu)]++;
+
+   // only an event that makes the list is kept
+   if( fgNslow <= 0 ) return;
+   if( G4int(fSlowest.size()) >= fgNslow && cpu <= fSlowest.front().cpu ) return;
+
+   SlowEvent e;
+   e.cpu    = cpu;
+   e.wall   = wall;
+   e.event  = event->GetEventID();
+   e.thread = G4Threading::G4GetThreadId();
+   e.steps  = fSteps;
+   e.tracks = fTracks;
+   e.seed   = B1EventSeeds::GetLastEventSeed();
+   Insert(fSlowest, e);
+}
+//______________________________________________________________________________
+
+void B1EventProfiler::Insert(std::vector<SlowEvent>& heap, const SlowEvent& e)
+{
+   // min-heap on the cpu time: the front is the fastest of the slowest
+   auto faster = [](const SlowEvent& a, const SlowEvent& b) { return a.cpu > b.cpu; };
+   if( G4int(heap.size()) < fgNslow ) {
+      heap.push_back(e);
+      std::push_heap(heap.begin(), heap.end(), faster);
+   } else if( e.cpu > heap.front().cpu ) {
+      std::pop_heap(heap.begin(), heap.end(), faster);
+      heap.back() = e;
+      std::push_heap(heap.begin(), heap.end(), faster);
+   }
+}
+//______________________________________________________________________________
+
+void B1EventProfiler::EndOfRun()
+{
+   if( fSummary.events == 0 ) return;
+   G4AutoLock lock(&profilerMutex);
+   fgSummary.events += fSummary.events;
+   fgSummary.cpu    += fSummary.cpu;
+   fgSummary.wall   += fSummary.wall;
+   fgSummary.bins.resize(kLogBins, 0);
+   for(G4int b = 0; b < kLogBins; b++) fgSummary.bins[b] += fSummary.bins[b];
+   for(const auto& e : fSlowest) Insert(fgSlowest, e);
+}
+//______________________________________________________________________________
+
+void B1EventProfiler::Print(G4int runNumber)
+{
+   G4AutoLock lock(&profilerMutex);
+   if( fgSummary.events == 0 ) return;
+
+   G4cout << std::setw(24) << "timed events" << " : " << fgSummary.events << G4endl
+      << std::setw(24) << "mean CPU per event" << " : " << fgSummary.cpu/fgSummary.events << " s" << G4endl
+      << std::setw(24) << "mean wall per event" << " : " << fgSummary.wall/fgSummary.events << " s" << G4endl
+      << std::setw(24) << "CPU quantiles" << " : 50% < " << Quantile(fgSummary, 0.5)
+      << " s, 90% < " << Quantile(fgSummary, 0.9)
+      << " s, 99% < " << Quantile(fgSummary, 0.99) << " s" << G4endl;
+   if( fgSlowest.empty() ) return;
+
+   std::vector<SlowEvent> slowest(fgSlowest);
+   std::sort(slowest.begin(), slowest.end(),
+             [](const SlowEvent& a, const SlowEvent& b) { return a.cpu > b.cpu; });
+
+   G4double top = 0.0;
+   G4cout << std::setw(10) << "event" << std::setw(8) << "thread"
+      << std::setw(14) << "CPU (s)" << std::setw(14) << "wall (s)"
+      << std::setw(14) << "steps" << std::setw(12) << "tracks"
+      << std::setw(20) << "seed" << G4endl;
+   for(const auto& e : slowest) {
+      top += e.cpu;
+      G4cout << std::setw(10) << e.event << std::setw(8) << e.thread
+         << std::setw(14) << e.cpu << std::setw(14) << e.wall
+         << std::setw(14) << e.steps << std::setw(12) << e.tracks
+         << std::setw(20) << e.seed << G4endl;
+   }
+   G4cout << " the " << slowest.size() << " slowest events took "
+      << 100.0*top/fgSummary.cpu << " % of the CPU time" << G4endl;
+
+   // the same events from their seeds (B1EventSeeds)
+   const G4Run * run = G4RunManager::GetRunManager()->GetCurrentRun();
+   if( run && !B1EventSeeds::IsReplay() ) {
+      G4cout << " replay : ebl1 -b --seed=" << B1EventSeeds::GetSeed() << " --run=" << runNumber
+         << " --replay=" << run->GetRunID() << ":";
+      for(std::size_t i = 0; i < slowest.size(); i++) G4cout << (i ? "," : "") << slowest[i].event;
+      G4cout << " <macro>" << G4endl;
+   }
+}
+//______________________________________________________________________________
+
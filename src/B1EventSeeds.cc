@@ -0,0 +1,50 @@
+#include "B1EventSeeds.hh"
+
+#include "G4Threading.hh"
+#include "Randomize.hh"
+#include <iomanip>
+
+std::uint64_t                 B1EventSeeds::fgSeed        = 0;
+G4bool                        B1EventSeeds::fgReplay      = false;
+G4int                         B1EventSeeds::fgReplayRun   = 0;
+G4int                         B1EventSeeds::fgReplayEvent = 0;
+G4ThreadLocal std::uint64_t   B1EventSeeds::fgRunSeed     = 0;
+G4ThreadLocal std::uint64_t   B1EventSeeds::fgEventSeed   = 0;
+
+//______________________________________________________________________________
+
+void B1EventSeeds::BeginOfRun(G4int runNumber, G4int runID)
+{
+   if( fgReplay ) runID = fgReplayRun;
+   fgRunSeed = Mix(fgSeed ^ Mix((std::uint64_t(std::uint32_t(runNumber)) << 32) | std::uint32_t(runID)));
+
+   if( G4Threading::IsMasterThread() ) {
+      G4cout << std::setw(24) << "event seeds" << " : seed " << fgSeed
+         << ", run number " << runNumber << ", run id " << runID;
+      if( fgReplay ) G4cout << ", replaying event " << fgReplayEvent;
+      G4cout << G4endl;
+   }
+}
+//______________________________________________________________________________
+
+std::uint64_t B1EventSeeds::GetEventSeed(G4int event)
+{
+   return Mix(fgRunSeed ^ Mix(std::uint64_t(std::uint32_t(event))));
+}
+//______________________________________________________________________________
+
+void B1EventSeeds::Reseed(G4int event)
+{
+   std::uint64_t s = GetEventSeed(fgReplay ? fgReplayEvent : event);
+   fgEventSeed = s;
+
+   // two positive 31-bit seeds (what RanecuEngine takes; other engines
+   // take at least two), never zero
+   long seeds[3];
+   seeds[0] = long((s & 0x7fffffffULL) | 1);
+   seeds[1] = long(((s >> 32) & 0x7fffffffULL) | 1);
+   seeds[2] = 0;
+   G4Random::setTheSeeds(seeds, -1);
+}
+//______________________________________________________________________________
+
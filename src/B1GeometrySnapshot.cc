@@ -0,0 +1,762 @@
+#include "B1GeometrySnapshot.hh"
+#include "B1WireParameterisation.hh"
+
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4PVPlacement.hh"
+#include "G4PVParameterised.hh"
+#include "G4Material.hh"
+#include "G4Element.hh"
+#include "G4NistManager.hh"
+#include "G4MaterialPropertiesTable.hh"
+#include "G4VisAttributes.hh"
+#include "G4Box.hh"
+#include "G4Tubs.hh"
+#include "G4GenericTrap.hh"
+#include "G4TessellatedSolid.hh"
+#include "G4TriangularFacet.hh"
+#include "G4QuadrangularFacet.hh"
+#include "G4UnionSolid.hh"
+#include "G4SubtractionSolid.hh"
+#include "G4IntersectionSolid.hh"
+#include "G4DisplacedSolid.hh"
+#include "G4RotationMatrix.hh"
+#include "G4Transform3D.hh"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+
+namespace {
+
+   const std::uint32_t kMagic   = 0x53473142; // "B1GS"
+   const std::uint32_t kVersion = 1;
+
+   enum SolidType {
+      kBox = 1, kTubs, kGenericTrap, kTessellated,
+      kUnion, kSubtraction, kIntersection
+   };
+
+   enum PhysicalType { kPlacement = 0, kWireParameterised = 1 };
+
+   // Optical properties that are saved with a material
+   const char * kPropertyKeys[] = {
+      "RINDEX", "ABSLENGTH", "RAYLEIGH", "MIEHG",
+      "FASTCOMPONENT", "SLOWCOMPONENT",
+      "WLSABSLENGTH", "WLSCOMPONENT",
+      "REFLECTIVITY", "EFFICIENCY", 0 };
+   const char * kConstPropertyKeys[] = {
+      "SCINTILLATIONYIELD", "RESOLUTIONSCALE",
+      "FASTTIMECONSTANT", "SLOWTIMECONSTANT", "YIELDRATIO",
+      "WLSTIMECONSTANT", "MIEHG_FORWARD", "MIEHG_BACKWARD", "MIEHG_FORWARD_RATIO", 0 };
+
+   template<class T> void put(std::ostream& o, const T& v)
+   {
+      o.write(reinterpret_cast<const char*>(&v), sizeof(T));
+   }
+
+   void put_string(std::ostream& o, const std::string& s)
+   {
+      std::uint32_t n = s.size();
+      put(o, n);
+      o.write(s.data(), n);
+   }
+
+   void put_vector(std::ostream& o, const G4ThreeVector& v)
+   {
+      put(o, v.x()); put(o, v.y()); put(o, v.z());
+   }
+
+   void put_rotation(std::ostream& o, const G4RotationMatrix& r)
+   {
+      put(o, r.xx()); put(o, r.xy()); put(o, r.xz());
+      put(o, r.yx()); put(o, r.yy()); put(o, r.yz());
+      put(o, r.zx()); put(o, r.zy()); put(o, r.zz());
+   }
+
+   // A material record: composition and the optical properties that are
+   // saved. ContentHash() hashes the same bytes.
+   void put_material(std::ostream& out, G4Material * mat)
+   {
+      G4NistManager * nist = G4NistManager::Instance();
+      put_string(out, mat->GetName());
+      std::uint8_t is_nist = (mat->GetName().compare(0, 3, "G4_") == 0);
+      put(out, is_nist);
+      if( !is_nist ) {
+         put(out, mat->GetDensity());
+         put(out, std::int32_t(mat->GetState()));
+         put(out, mat->GetTemperature());
+         put(out, mat->GetPressure());
+         put(out, std::uint32_t(mat->GetNumberOfElements()));
+         const G4double * fractions = mat->GetFractionVector();
+         for(std::size_t i = 0; i < mat->GetNumberOfElements(); i++) {
+            const G4Element * el = mat->GetElement(i);
+            std::uint8_t el_nist = (nist->FindElement(G4int(el->GetZ())) == el);
+            put_string(out, el->GetName());
+            put_string(out, el->GetSymbol());
+            put(out, el_nist);
+            put(out, el->GetZ());
+            put(out, el->GetA());
+            put(out, fractions[i]);
+         }
+      }
+
+      G4MaterialPropertiesTable * mpt = mat->GetMaterialPropertiesTable();
+      put(out, std::uint8_t(mpt != 0));
+      if( !mpt ) return;
+
+      std::vector<const char*> keys;
+      for(int k = 0; kPropertyKeys[k]; k++) {
+         if( mpt->GetProperty(kPropertyKeys[k]) ) keys.push_back(kPropertyKeys[k]);
+      }
+      put(out, std::uint32_t(keys.size()));
+      for(auto key : keys) {
+         G4MaterialPropertyVector * v = mpt->GetProperty(key);
+         std::uint32_t n = v->GetVectorLength();
+         put_string(out, key);
+         put(out, n);
+         for(std::uint32_t i = 0; i < n; i++) put(out, v->Energy(i));
+         for(std::uint32_t i = 0; i < n; i++) put(out, (*v)[i]);
+      }
+      keys.clear();
+      for(int k = 0; kConstPropertyKeys[k]; k++) {
+         if( mpt->ConstPropertyExists(kConstPropertyKeys[k]) ) keys.push_back(kConstPropertyKeys[k]);
+      }
+      put(out, std::uint32_t(keys.size()));
+      for(auto key : keys) {
+         put_string(out, key);
+         put(out, mpt->GetConstProperty(key));
+      }
+   }
+
+   template<class T> bool get(std::istream& i, T& v)
+   {
+      i.read(reinterpret_cast<char*>(&v), sizeof(T));
+      return bool(i);
+   }
+
+   bool get_string(std::istream& i, std::string& s)
+   {
+      std::uint32_t n = 0;
+      if( !get(i, n) || n > (1u << 20) ) return false;
+      s.resize(n);
+      if( n > 0 ) i.read(&s[0], n);
+      return bool(i);
+   }
+
+   bool get_vector(std::istream& i, G4ThreeVector& v)
+   {
+      G4double x, y, z;
+      if( !(get(i, x) && get(i, y) && get(i, z)) ) return false;
+      v.set(x, y, z);
+      return true;
+   }
+
+   bool get_rotation(std::istream& i, G4RotationMatrix& r)
+   {
+      G4double e[9];
+      for(int k = 0; k < 9; k++) if( !get(i, e[k]) ) return false;
+      r = G4RotationMatrix(CLHEP::HepRep3x3(e[0], e[1], e[2], e[3], e[4], e[5], e[6], e[7], e[8]));
+      return true;
+   }
+
+   // ------------------------------------------------------------------------
+   // Staging records: a file is read completely and checked before any
+   // Geant4 object is created, so a corrupt file leaves nothing behind
+
+   struct ElementRecord {
+      std::string   name, symbol;
+      std::uint8_t  nist;
+      G4double      Z, A, fraction;
+   };
+
+   struct PropertyRecord {
+      std::string            key;
+      std::vector<G4double>  energies, values;
+   };
+
+   struct MaterialRecord {
+      std::string                  name;
+      std::uint8_t                 nist;
+      G4double                     density, temperature, pressure;
+      std::int32_t                 state;
+      std::vector<ElementRecord>   elements;
+      std::uint8_t                 hasMPT;
+      std::vector<PropertyRecord>  properties;
+      std::vector< std::pair<std::string, G4double> > constProperties;
+   };
+
+   struct SolidRecord {
+      std::int32_t                               type;
+      std::string                                name;
+      std::vector<G4double>                      params;   // box, tubs, trap
+      std::vector< std::vector<G4ThreeVector> >  facets;   // tessellated
+      std::int32_t                               a, b;     // boolean
+      G4RotationMatrix                           rot;
+      G4ThreeVector                              trans;
+   };
+
+   struct LogicalRecord {
+      std::string   name;
+      std::int32_t  solid, material;
+      std::uint8_t  hasVis, wireframe, visible;
+      G4double      r, g, b, alpha;
+   };
+
+   struct PhysicalRecord {
+      std::string       name;
+      std::int32_t      logical, mother, copyNo;
+      std::uint8_t      kind, hasRot;
+      std::int32_t      nwires;
+      G4double          spacing, angle, length0, y0, z;
+      G4RotationMatrix  rot;
+      G4ThreeVector     trans;
+   };
+
+   // Counts above this are taken as corruption rather than allocated
+   const std::uint32_t kMaxCount = 1u << 20;
+
+   bool get_count(std::istream& i, std::uint32_t& n)
+   {
+      return get(i, n) && n <= kMaxCount;
+   }
+
+   bool read_materials(std::istream& in, std::vector<MaterialRecord>& materials)
+   {
+      std::uint32_t n = 0;
+      if( !get_count(in, n) ) return false;
+      materials.resize(n);
+      for(auto& m : materials) {
+         if( !(get_string(in, m.name) && get(in, m.nist)) ) return false;
+         if( !m.nist ) {
+            std::uint32_t nel = 0;
+            if( !(get(in, m.density) && get(in, m.state) && get(in, m.temperature) && get(in, m.pressure)
+                  && get_count(in, nel) && nel > 0) ) return false;
+            m.elements.resize(nel);
+            for(auto& e : m.elements) {
+               if( !(get_string(in, e.name) && get_string(in, e.symbol) && get(in, e.nist)
+                     && get(in, e.Z) && get(in, e.A) && get(in, e.fraction)) ) return false;
+            }
+         }
+         if( !get(in, m.hasMPT) ) return false;
+         if( !m.hasMPT ) continue;
+
+         std::uint32_t nprop = 0;
+         if( !get_count(in, nprop) ) return false;
+         m.properties.resize(nprop);
+         for(auto& p : m.properties) {
+            std::uint32_t len = 0;
+            if( !(get_string(in, p.key) && get_count(in, len)) ) return false;
+            p.energies.resize(len);
+            p.values.resize(len);
+            for(auto& x : p.energies) if( !get(in, x) ) return false;
+            for(auto& x : p.values)   if( !get(in, x) ) return false;
+         }
+         if( !get_count(in, nprop) ) return false;
+         m.constProperties.resize(nprop);
+         for(auto& p : m.constProperties) {
+            if( !(get_string(in, p.first) && get(in, p.second)) ) return false;
+         }
+      }
+      return true;
+   }
+
+   bool read_solids(std::istream& in, std::vector<SolidRecord>& solids)
+   {
+      std::uint32_t n = 0;
+      if( !get_count(in, n) ) return false;
+      solids.resize(n);
+      for(std::int32_t isol = 0; isol < std::int32_t(n); isol++) {
+         SolidRecord& s = solids[isol];
+         if( !(get(in, s.type) && get_string(in, s.name)) ) return false;
+
+         std::size_t nparams = 0;
+         if( s.type == kBox )         nparams = 3;
+         if( s.type == kTubs )        nparams = 5;
+         if( s.type == kGenericTrap ) nparams = 1 + 2*8;
+         if( nparams ) {
+            s.params.resize(nparams);
+            for(auto& x : s.params) if( !get(in, x) ) return false;
+         } else if( s.type == kTessellated ) {
+            std::uint32_t nfacets = 0;
+            if( !get_count(in, nfacets) ) return false;
+            s.facets.resize(nfacets);
+            for(auto& f : s.facets) {
+               std::uint32_t nv = 0;
+               if( !(get(in, nv) && (nv == 3 || nv == 4)) ) return false;
+               f.resize(nv);
+               for(auto& v : f) if( !get_vector(in, v) ) return false;
+            }
+         } else if( s.type == kUnion || s.type == kSubtraction || s.type == kIntersection ) {
+            // the constituents are recorded before the boolean
+            if( !(get(in, s.a) && get(in, s.b) && get_rotation(in, s.rot) && get_vector(in, s.trans)
+                  && s.a >= 0 && s.b >= 0 && s.a < isol && s.b < isol) ) return false;
+         } else {
+            return false;
+         }
+      }
+      return true;
+   }
+
+   bool read_logicals(std::istream& in, std::vector<LogicalRecord>& logicals,
+                      std::size_t nsolids, std::size_t nmaterials)
+   {
+      std::uint32_t n = 0;
+      if( !get_count(in, n) ) return false;
+      logicals.resize(n);
+      for(auto& l : logicals) {
+         if( !(get_string(in, l.name) && get(in, l.solid) && get(in, l.material) && get(in, l.hasVis)
+               && l.solid    >= 0 && l.solid    < std::int32_t(nsolids)
+               && l.material >= 0 && l.material < std::int32_t(nmaterials)) ) return false;
+         if( l.hasVis && !(get(in, l.r) && get(in, l.g) && get(in, l.b) && get(in, l.alpha)
+                           && get(in, l.wireframe) && get(in, l.visible)) ) return false;
+      }
+      return true;
+   }
+
+   bool read_physicals(std::istream& in, std::vector<PhysicalRecord>& physicals, std::size_t nlogicals)
+   {
+      std::uint32_t n = 0;
+      if( !(get_count(in, n) && n > 0) ) return false;
+      physicals.resize(n);
+      for(std::size_t iphys = 0; iphys < n; iphys++) {
+         PhysicalRecord& p = physicals[iphys];
+         if( !(get_string(in, p.name) && get(in, p.logical) && get(in, p.mother) && get(in, p.copyNo)
+               && get(in, p.kind)
+               && p.logical >= 0 && p.logical < std::int32_t(nlogicals)
+               && p.mother  < std::int32_t(nlogicals)
+               && (p.mother >= 0) == (iphys > 0)) ) return false;
+
+         if( p.kind == kWireParameterised ) {
+            if( !(get(in, p.nwires) && get(in, p.spacing) && get(in, p.angle) && get(in, p.length0)
+                  && get(in, p.y0) && get(in, p.z) && p.nwires > 0 && iphys > 0) ) return false;
+         } else if( p.kind == kPlacement ) {
+            if( !get(in, p.hasRot) ) return false;
+            if( p.hasRot && !get_rotation(in, p.rot) ) return false;
+            if( !get_vector(in, p.trans) ) return false;
+         } else {
+            return false;
+         }
+      }
+      return true;
+   }
+}
+//______________________________________________________________________________
+
+B1GeometrySnapshot::B1GeometrySnapshot() :
+   fBuildTime(0.0), fSupported(true)
+{ }
+//______________________________________________________________________________
+
+B1GeometrySnapshot::~B1GeometrySnapshot()
+{ }
+//______________________________________________________________________________
+
+G4String B1GeometrySnapshot::FileName(const G4String& dir, std::uint64_t hash)
+{
+   std::ostringstream name;
+   name << dir;
+   if( !dir.empty() && dir[dir.size()-1] != '/' ) name << "/";
+   name << "ebl_geometry_" << std::hex << std::setw(16) << std::setfill('0') << hash << ".g4snap";
+   return name.str();
+}
+//______________________________________________________________________________
+
+std::uint64_t B1GeometrySnapshot::MaterialHash(const std::vector<G4Material*>& materials)
+{
+   // FNV-1a over the file format version and the material records
+   std::ostringstream out;
+   put(out, kVersion);
+   for(auto mat : materials) put_material(out, mat);
+
+   const std::string bytes = out.str();
+   std::uint64_t     hash  = 14695981039346656037ULL;
+   for(unsigned char c : bytes) {
+      hash ^= c;
+      hash *= 1099511628211ULL;
+   }
+   return hash;
+}
+//______________________________________________________________________________
+
+G4int B1GeometrySnapshot::AddMaterial(G4Material * mat)
+{
+   auto it = fIndex.find(mat);
+   if( it != fIndex.end() ) return it->second;
+   fMaterials.push_back(mat);
+   return fIndex[mat] = fMaterials.size() - 1;
+}
+//______________________________________________________________________________
+
+G4int B1GeometrySnapshot::AddSolid(G4VSolid * solid)
+{
+   auto it = fIndex.find(solid);
+   if( it != fIndex.end() ) return it->second;
+
+   // constituents of booleans are recorded first
+   G4BooleanSolid * boolean = dynamic_cast<G4BooleanSolid*>(solid);
+   if( boolean ) {
+      G4VSolid * b = boolean->GetConstituentSolid(1);
+      G4DisplacedSolid * displaced = dynamic_cast<G4DisplacedSolid*>(b);
+      AddSolid(boolean->GetConstituentSolid(0));
+      AddSolid(displaced ? displaced->GetConstituentMovedSolid() : b);
+   } else {
+      G4GeometryType type = solid->GetEntityType();
+      if( type != "G4Box" && type != "G4Tubs" && type != "G4GenericTrap" && type != "G4TessellatedSolid" ) {
+         G4ExceptionDescription msg;
+         msg << "solid " << solid->GetName() << " of type " << type << " cannot be saved";
+         G4Exception("B1GeometrySnapshot::Write()", "B1Snap0001", JustWarning, msg);
+         fSupported = false;
+      }
+   }
+   fSolids.push_back(solid);
+   return fIndex[solid] = fSolids.size() - 1;
+}
+//______________________________________________________________________________
+
+void B1GeometrySnapshot::Collect(G4LogicalVolume * lv)
+{
+   if( fIndex.find(lv) != fIndex.end() ) return;
+
+   AddSolid(lv->GetSolid());
+   AddMaterial(lv->GetMaterial());
+   fLogicals.push_back(lv);
+   fIndex[lv] = fLogicals.size() - 1;
+
+   for(int i = 0; i < lv->GetNoDaughters(); i++) {
+      G4VPhysicalVolume * pv = lv->GetDaughter(i);
+      if( pv->IsReplicated() && !dynamic_cast<B1WireParameterisation*>(pv->GetParameterisation()) ) {
+         G4ExceptionDescription msg;
+         msg << "replicated volume " << pv->GetName() << " cannot be saved";
+         G4Exception("B1GeometrySnapshot::Write()", "B1Snap0002", JustWarning, msg);
+         fSupported = false;
+      }
+      Collect(pv->GetLogicalVolume());
+      fPhysicals.push_back(pv);
+   }
+}
+//______________________________________________________________________________
+
+G4bool B1GeometrySnapshot::Write(const G4String& fileName, std::uint64_t hash, G4double buildTime,
+                                 G4VPhysicalVolume * world)
+{
+   fMaterials.clear();
+   fSolids.clear();
+   fLogicals.clear();
+   fPhysicals.clear();
+   fIndex.clear();
+   fSupported = true;
+   fBuildTime = buildTime;
+
+   Collect(world->GetLogicalVolume());
+   fPhysicals.insert(fPhysicals.begin(), world);
+   if( !fSupported ) return false;
+
+   G4String      tmp_name = fileName + ".tmp";
+   std::ofstream out(tmp_name.c_str(), std::ios::binary);
+   if( !out ) {
+      G4ExceptionDescription msg;
+      msg << "cannot write " << tmp_name;
+      G4Exception("B1GeometrySnapshot::Write()", "B1Snap0003", JustWarning, msg);
+      return false;
+   }
+
+   put(out, kMagic);
+   put(out, kVersion);
+   put(out, hash);
+   put(out, fBuildTime);
+
+   // ------------------------------------------------------------------------
+   // Materials
+   put(out, std::uint32_t(fMaterials.size()));
+   for(auto mat : fMaterials) put_material(out, mat);
+
+   // ------------------------------------------------------------------------
+   // Solids
+   put(out, std::uint32_t(fSolids.size()));
+   for(auto solid : fSolids) {
+      G4GeometryType type = solid->GetEntityType();
+      G4BooleanSolid * boolean = dynamic_cast<G4BooleanSolid*>(solid);
+
+      if( boolean ) {
+         std::int32_t code = kIntersection;
+         if( type == "G4UnionSolid" )       code = kUnion;
+         if( type == "G4SubtractionSolid" ) code = kSubtraction;
+         put(out, code);
+         put_string(out, solid->GetName());
+
+         G4VSolid         * b         = boolean->GetConstituentSolid(1);
+         G4DisplacedSolid * displaced = dynamic_cast<G4DisplacedSolid*>(b);
+         G4RotationMatrix   rot;
+         G4ThreeVector      trans;
+         if( displaced ) {
+            b     = displaced->GetConstituentMovedSolid();
+            rot   = displaced->GetObjectRotation();
+            trans = displaced->GetObjectTranslation();
+         }
+         put(out, std::int32_t(fIndex[boolean->GetConstituentSolid(0)]));
+         put(out, std::int32_t(fIndex[b]));
+         put_rotation(out, rot);
+         put_vector(out, trans);
+         continue;
+      }
+
+      if( type == "G4Box" ) {
+         G4Box * box = static_cast<G4Box*>(solid);
+         put(out, std::int32_t(kBox));
+         put_string(out, solid->GetName());
+         put(out, box->GetXHalfLength());
+         put(out, box->GetYHalfLength());
+         put(out, box->GetZHalfLength());
+      } else if( type == "G4Tubs" ) {
+         G4Tubs * tubs = static_cast<G4Tubs*>(solid);
+         put(out, std::int32_t(kTubs));
+         put_string(out, solid->GetName());
+         put(out, tubs->GetInnerRadius());
+         put(out, tubs->GetOuterRadius());
+         put(out, tubs->GetZHalfLength());
+         put(out, tubs->GetStartPhiAngle());
+         put(out, tubs->GetDeltaPhiAngle());
+      } else if( type == "G4GenericTrap" ) {
+         G4GenericTrap * trap = static_cast<G4GenericTrap*>(solid);
+         put(out, std::int32_t(kGenericTrap));
+         put_string(out, solid->GetName());
+         put(out, trap->GetZHalfLength());
+         for(const auto& v : trap->GetVertices()) {
+            put(out, v.x());
+            put(out, v.y());
+         }
+      } else {
+         G4TessellatedSolid * tess = static_cast<G4TessellatedSolid*>(solid);
+         put(out, std::int32_t(kTessellated));
+         put_string(out, solid->GetName());
+         put(out, std::uint32_t(tess->GetNumberOfFacets()));
+         for(int i = 0; i < tess->GetNumberOfFacets(); i++) {
+            G4VFacet * facet = tess->GetFacet(i);
+            put(out, std::uint32_t(facet->GetNumberOfVertices()));
+            for(int j = 0; j < facet->GetNumberOfVertices(); j++) put_vector(out, facet->GetVertex(j));
+         }
+      }
+   }
+
+   // ------------------------------------------------------------------------
+   // Logical volumes
+   put(out, std::uint32_t(fLogicals.size()));
+   for(auto lv : fLogicals) {
+      put_string(out, lv->GetName());
+      put(out, std::int32_t(fIndex[lv->GetSolid()]));
+      put(out, std::int32_t(fIndex[lv->GetMaterial()]));
+      const G4VisAttributes * vis = lv->GetVisAttributes();
+      put(out, std::uint8_t(vis != 0));
+      if( vis ) {
+         const G4Colour& c = vis->GetColour();
+         put(out, c.GetRed());
+         put(out, c.GetGreen());
+         put(out, c.GetBlue());
+         put(out, c.GetAlpha());
+         put(out, std::uint8_t(vis->IsForceDrawingStyle() &&
+                               vis->GetForcedDrawingStyle() == G4VisAttributes::wireframe));
+         put(out, std::uint8_t(vis->IsVisible()));
+      }
+   }
+
+   // ------------------------------------------------------------------------
+   // Physical volumes, the world first
+   put(out, std::uint32_t(fPhysicals.size()));
+   for(auto pv : fPhysicals) {
+      G4LogicalVolume * mother = pv->GetMotherLogical();
+      put_string(out, pv->GetName());
+      put(out, std::int32_t(fIndex[pv->GetLogicalVolume()]));
+      put(out, std::int32_t(mother ? fIndex[mother] : -1));
+      put(out, std::int32_t(pv->GetCopyNo()));
+
+      B1WireParameterisation * wires = dynamic_cast<B1WireParameterisation*>(pv->GetParameterisation());
+      if( pv->IsParameterised() && wires ) {
+         put(out, std::uint8_t(kWireParameterised));
+         put(out, std::int32_t(wires->GetNumberOfWires()));
+         put(out, wires->GetSpacing());
+         put(out, wires->GetAngle());
+         put(out, wires->GetLength0());
+         put(out, wires->GetY0());
+         put(out, wires->GetZ());
+      } else {
+         const G4RotationMatrix * rot = pv->GetRotation();
+         put(out, std::uint8_t(kPlacement));
+         put(out, std::uint8_t(rot != 0));
+         if( rot ) put_rotation(out, *rot);
+         put_vector(out, pv->GetTranslation());
+      }
+   }
+
+   out.close();
+   if( !out || std::rename(tmp_name.c_str(), fileName.c_str()) != 0 ) {
+      std::remove(tmp_name.c_str());
+      return false;
+   }
+   return true;
+}
+//______________________________________________________________________________
+
+G4VPhysicalVolume * B1GeometrySnapshot::Read(const G4String& fileName, std::uint64_t hash)
+{
+   fMaterials.clear();
+   fSolids.clear();
+   fLogicals.clear();
+   fPhysicals.clear();
+   fIndex.clear();
+
+   std::ifstream in(fileName.c_str(), std::ios::binary);
+   if( !in ) return 0;
+
+   std::uint32_t magic = 0, version = 0;
+   std::uint64_t file_hash = 0;
+   if( !(get(in, magic) && get(in, version) && get(in, file_hash) && get(in, fBuildTime)) ) return 0;
+   if( magic != kMagic || version != kVersion || file_hash != hash ) return 0;
+
+   // ------------------------------------------------------------------------
+   // The whole file into the staging records first
+   std::vector<MaterialRecord>  materials;
+   std::vector<SolidRecord>     solids;
+   std::vector<LogicalRecord>   logicals;
+   std::vector<PhysicalRecord>  physicals;
+
+   G4bool ok = read_materials(in, materials)
+      && read_solids(in, solids)
+      && read_logicals(in, logicals, solids.size(), materials.size())
+      && read_physicals(in, physicals, logicals.size());
+
+   // the NIST materials are looked up before anything is built, the only
+   // step of the build that can fail
+   G4NistManager * nist = G4NistManager::Instance();
+   for(std::size_t i = 0; ok && i < materials.size(); i++) {
+      if( materials[i].nist ) ok = (nist->FindOrBuildMaterial(materials[i].name) != 0);
+   }
+
+   if( !ok ) {
+      G4ExceptionDescription msg;
+      msg << "snapshot " << fileName << " is corrupt, the geometry will be built from code";
+      G4Exception("B1GeometrySnapshot::Read()", "B1Snap0004", JustWarning, msg);
+      return 0;
+   }
+
+   // ------------------------------------------------------------------------
+   // Materials, reusing those already defined under the same name
+   for(const auto& m : materials) {
+      G4Material * mat = 0;
+      if( m.nist ) {
+         mat = nist->FindOrBuildMaterial(m.name);
+      } else {
+         mat = G4Material::GetMaterial(m.name, false);
+         if( !mat ) {
+            mat = new G4Material(m.name, m.density, G4int(m.elements.size()), G4State(m.state),
+                                 m.temperature, m.pressure);
+            for(const auto& e : m.elements) {
+               G4Element * el = 0;
+               if( e.nist ) el = nist->FindOrBuildElement(G4int(e.Z));
+               if( !el )    el = G4Element::GetElement(e.name, false);
+               if( !el )    el = new G4Element(e.name, e.symbol, e.Z, e.A);
+               mat->AddElement(el, e.fraction);
+            }
+         }
+      }
+
+      if( m.hasMPT && !mat->GetMaterialPropertiesTable() ) {
+         G4MaterialPropertiesTable * mpt = new G4MaterialPropertiesTable();
+         for(const auto& p : m.properties) {
+            std::vector<G4double> energies(p.energies), values(p.values);
+            mpt->AddProperty(p.key.c_str(), energies.data(), values.data(), G4int(energies.size()));
+         }
+         for(const auto& p : m.constProperties) mpt->AddConstProperty(p.first.c_str(), p.second);
+         mat->SetMaterialPropertiesTable(mpt);
+      }
+      fMaterials.push_back(mat);
+   }
+
+   // ------------------------------------------------------------------------
+   // Solids
+   for(const auto& r : solids) {
+      G4VSolid * solid = 0;
+      const std::vector<G4double>& x = r.params;
+      if( r.type == kBox ) {
+         solid = new G4Box(r.name, x[0], x[1], x[2]);
+      } else if( r.type == kTubs ) {
+         solid = new G4Tubs(r.name, x[0], x[1], x[2], x[3], x[4]);
+      } else if( r.type == kGenericTrap ) {
+         std::vector<G4TwoVector> vertices(8);
+         for(int i = 0; i < 8; i++) vertices[i].set(x[1+2*i], x[2+2*i]);
+         solid = new G4GenericTrap(r.name, x[0], vertices);
+      } else if( r.type == kTessellated ) {
+         G4TessellatedSolid * tess = new G4TessellatedSolid(r.name);
+         for(const auto& f : r.facets) {
+            if( f.size() == 3 ) tess->AddFacet(new G4TriangularFacet(f[0], f[1], f[2], ABSOLUTE));
+            else                tess->AddFacet(new G4QuadrangularFacet(f[0], f[1], f[2], f[3], ABSOLUTE));
+         }
+         tess->SetSolidClosed(true);
+         solid = tess;
+      } else {
+         G4Transform3D transform(r.rot, r.trans);
+         if( r.type == kUnion )       solid = new G4UnionSolid(r.name, fSolids[r.a], fSolids[r.b], transform);
+         if( r.type == kSubtraction ) solid = new G4SubtractionSolid(r.name, fSolids[r.a], fSolids[r.b], transform);
+         if( r.type == kIntersection) solid = new G4IntersectionSolid(r.name, fSolids[r.a], fSolids[r.b], transform);
+      }
+      fSolids.push_back(solid);
+   }
+
+   // ------------------------------------------------------------------------
+   // Logical volumes
+   for(const auto& r : logicals) {
+      G4LogicalVolume * lv = new G4LogicalVolume(fSolids[r.solid], fMaterials[r.material], r.name);
+      if( r.hasVis ) {
+         G4VisAttributes * vis = new G4VisAttributes(G4Colour(r.r, r.g, r.b, r.alpha));
+         vis->SetForceWireframe(r.wireframe);
+         vis->SetVisibility(r.visible);
+         lv->SetVisAttributes(vis);
+      }
+      fLogicals.push_back(lv);
+   }
+
+   // ------------------------------------------------------------------------
+   // Physical volumes
+   // consecutive placements with the same rotation share one matrix, as they
+   // do when built from code
+   G4RotationMatrix * last_rot = 0;
+   for(const auto& r : physicals) {
+      G4LogicalVolume   * mother = (r.mother >= 0) ? fLogicals[r.mother] : 0;
+      G4VPhysicalVolume * pv     = 0;
+
+      if( r.kind == kWireParameterised ) {
+         B1WireParameterisation * param = new B1WireParameterisation(r.nwires, r.spacing, r.angle,
+                                                                     r.length0, r.y0, r.z);
+         pv = new G4PVParameterised(r.name, fLogicals[r.logical], mother, kUndefined, r.nwires, param, false);
+      } else {
+         G4RotationMatrix * rot = 0;
+         if( r.hasRot ) {
+            if( last_rot && *last_rot == r.rot ) {
+               rot = last_rot;
+            } else {
+               rot = last_rot = new G4RotationMatrix(r.rot);
+            }
+         }
+         pv = new G4PVPlacement(rot, r.trans, fLogicals[r.logical], r.name, mother, false, r.copyNo, false);
+      }
+      fPhysicals.push_back(pv);
+   }
+   return fPhysicals[0];
+}
+//______________________________________________________________________________
+
+G4VPhysicalVolume * B1GeometrySnapshot::FindPhysical(const G4String& name) const
+{
+   for(auto pv : fPhysicals) if( pv->GetName() == name ) return pv;
+   return 0;
+}
+//______________________________________________________________________________
+
+G4LogicalVolume * B1GeometrySnapshot::FindLogical(const G4String& name) const
+{
+   for(auto lv : fLogicals) if( lv->GetName() == name ) return lv;
+   return 0;
+}
+//______________________________________________________________________________
+
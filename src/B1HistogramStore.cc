@@ -0,0 +1,198 @@
+#include "B1HistogramStore.hh"
+#include "B1Analysis.hh"
+
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <iomanip>
+
+namespace {
+   using bench_clock = std::chrono::steady_clock;
+
+   // Store bin (0 underflow, n+1 overflow) to tools bin index
+   inline int ToolsBin(G4int i, G4int n)
+   {
+      if( i == 0 )     return tools::histo::axis_UNDERFLOW_BIN;
+      if( i == n + 1 ) return tools::histo::axis_OVERFLOW_BIN;
+      return i - 1;
+   }
+}
+
+G4ThreadLocal B1HistogramStore * B1HistogramStore::fgInstance = 0;
+
+//______________________________________________________________________________
+
+B1HistogramStore * B1HistogramStore::Instance()
+{
+   if( !fgInstance ) fgInstance = new B1HistogramStore();
+   return fgInstance;
+}
+//______________________________________________________________________________
+
+B1HistogramStore::B1HistogramStore()
+{ }
+//______________________________________________________________________________
+
+void B1HistogramStore::AddDefinition(Definition& d)
+{
+   Bin zero = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+   d.offset = fBins.size();
+   fBins.resize(fBins.size() + d.nbins, zero);
+   fDefinitions.push_back(d);
+}
+//______________________________________________________________________________
+
+G4int B1HistogramStore::CreateH1(const G4String& name, const G4String& title,
+                                 G4int nbins, G4double xmin, G4double xmax)
+{
+   return AddH1(G4AnalysisManager::Instance()->CreateH1(name, title, nbins, xmin, xmax),
+                nbins, xmin, xmax);
+}
+//______________________________________________________________________________
+
+G4int B1HistogramStore::CreateH2(const G4String& name, const G4String& title,
+                                 G4int nxbins, G4double xmin, G4double xmax,
+                                 G4int nybins, G4double ymin, G4double ymax)
+{
+   return AddH2(G4AnalysisManager::Instance()->CreateH2(name, title, nxbins, xmin, xmax, nybins, ymin, ymax),
+                nxbins, xmin, xmax, nybins, ymin, ymax);
+}
+//______________________________________________________________________________
+
+G4int B1HistogramStore::AddH1(G4int amId, G4int nbins, G4double xmin, G4double xmax)
+{
+   Definition d;
+   d.dimension = 1;
+   d.amId      = amId;
+   d.nx        = nbins;
+   d.ny        = 1;
+   d.xmin      = xmin;
+   d.xmax      = xmax;
+   d.ymin      = 0.0;
+   d.ymax      = 0.0;
+   d.xinv      = nbins/(xmax - xmin);
+   d.yinv      = 0.0;
+   d.nbins     = nbins + 2;
+   AddDefinition(d);
+   return fDefinitions.size() - 1;
+}
+//______________________________________________________________________________
+
+G4int B1HistogramStore::AddH2(G4int amId, G4int nxbins, G4double xmin, G4double xmax,
+                              G4int nybins, G4double ymin, G4double ymax)
+{
+   Definition d;
+   d.dimension = 2;
+   d.amId      = amId;
+   d.nx        = nxbins;
+   d.ny        = nybins;
+   d.xmin      = xmin;
+   d.xmax      = xmax;
+   d.ymin      = ymin;
+   d.ymax      = ymax;
+   d.xinv      = nxbins/(xmax - xmin);
+   d.yinv      = nybins/(ymax - ymin);
+   d.nbins     = (nxbins + 2)*(nybins + 2);
+   AddDefinition(d);
+   return fDefinitions.size() - 1;
+}
+//______________________________________________________________________________
+
+void B1HistogramStore::Reset()
+{
+   Bin zero = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+   std::fill(fBins.begin(), fBins.end(), zero);
+}
+//______________________________________________________________________________
+
+void B1HistogramStore::Merge()
+{
+   // Only this thread's analysis manager is touched, so no lock is needed.
+   G4AnalysisManager * analysisManager = G4AnalysisManager::Instance();
+
+   for(const Definition& d : fDefinitions) {
+      if( d.amId < 0 ) continue;
+      if( d.dimension == 1 ) {
+         tools::histo::h1d * h = analysisManager->GetH1(d.amId, false);
+         if( !h ) continue;
+         for(G4int ix = 0; ix < d.nx + 2; ix++) {
+            const Bin& b = fBins[d.offset + ix];
+            if( b.n == 0.0 ) continue;
+            // the under/overflow bins are added like the others
+            int          bx = ToolsBin(ix, d.nx);
+            unsigned int n;
+            G4double sw, sw2, sxw, sx2w;
+            h->get_bin_content(bx, n, sw, sw2, sxw, sx2w);
+            h->set_bin_content(bx, n + (unsigned int)(b.n), sw + b.sw, sw2 + b.sw2,
+                               sxw + b.sxw, sx2w + b.sx2w);
+         }
+      } else {
+         tools::histo::h2d * h = analysisManager->GetH2(d.amId, false);
+         if( !h ) continue;
+         for(G4int iy = 0; iy < d.ny + 2; iy++) {
+            for(G4int ix = 0; ix < d.nx + 2; ix++) {
+               const Bin& b = fBins[d.offset + iy*(d.nx + 2) + ix];
+               if( b.n == 0.0 ) continue;
+               int          bx = ToolsBin(ix, d.nx);
+               int          by = ToolsBin(iy, d.ny);
+               unsigned int n;
+               G4double sw, sw2, sxw, sx2w, syw, sy2w;
+               h->get_bin_content(bx, by, n, sw, sw2, sxw, sx2w, syw, sy2w);
+               h->set_bin_content(bx, by, n + (unsigned int)(b.n), sw + b.sw, sw2 + b.sw2,
+                                  sxw + b.sxw, sx2w + b.sx2w, syw + b.syw, sy2w + b.sy2w);
+            }
+         }
+      }
+   }
+   Reset();
+}
+//______________________________________________________________________________
+
+void B1HistogramStore::Benchmark(G4long nfills)
+{
+   // A private store and tools histograms of the same binning: nothing is
+   // booked in the analysis manager, so nothing reaches the output file
+   // and the histogram ids of the threads stay aligned
+   B1HistogramStore store;
+   const G4int      h1 = store.AddH1(-1, 100, 0, 8);
+   const G4int      h2 = store.AddH2(-1, 100, -10, 10, 100, -10, 10);
+   tools::histo::h1d toolsH1("bench/h1", 100, 0, 8);
+   tools::histo::h2d toolsH2("bench/h2", 100, -10, 10, 100, -10, 10);
+
+   // the same values for both paths, generated up front
+   const std::size_t nvalues = 1 << 16;
+   std::vector<G4double> values(nvalues);
+   std::mt19937_64 gen(12345);
+   std::normal_distribution<double> gaus(0.0, 4.0);
+   for(auto& v : values) v = gaus(gen);
+
+   auto run = [&](bool useStore) {
+      bench_clock::time_point t0 = bench_clock::now();
+      for(G4long i = 0; i < nfills; i++) {
+         G4double x = values[i & (nvalues - 1)];
+         G4double y = values[(i + 7) & (nvalues - 1)];
+         if( useStore ) {
+            store.FillH1(h1, std::abs(x));
+            store.FillH2(h2, x, y);
+         } else {
+            toolsH1.fill(std::abs(x));
+            toolsH2.fill(x, y);
+         }
+      }
+      std::chrono::duration<G4double> dt = bench_clock::now() - t0;
+      return dt.count();
+   };
+
+   G4double tTools = run(false);
+   G4double tStore = run(true);
+
+   G4double nall = 2.0*nfills;
+   G4cout << "------------------------------------------------------------------------\n";
+   G4cout << " Histogram fill benchmark (" << nfills << " H1 + " << nfills << " H2 fills)\n"
+      << "        tools histograms : " << std::setw(12) << ((tTools > 0.0) ? nall/tTools : 0.0) << " fills/s\n"
+      << "         histogram store : " << std::setw(12) << ((tStore > 0.0) ? nall/tStore : 0.0) << " fills/s\n"
+      << "                 speedup : " << ((tStore > 0.0) ? tTools/tStore : 0.0) << G4endl;
+}
+//______________________________________________________________________________
+
@@ -0,0 +1,191 @@
+#include "B1HitReader.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//______________________________________________________________________________
+
+B1HitReader::Hits B1HitReader::Hits::Sub(std::size_t first, std::size_t count) const
+{
+   Hits h = *this;
+   h.n     = count;
+   h.event = event + first;
+   h.plane = plane + first;
+   h.pdg   = pdg   + first;
+   h.x     = x     + first;
+   h.y     = y     + first;
+   h.px    = px    + first;
+   h.py    = py    + first;
+   h.pz    = pz    + first;
+   h.ekin  = ekin  + first;
+   h.edep  = edep  + first;
+   return h;
+}
+//______________________________________________________________________________
+
+B1HitReader::B1HitReader() :
+   fFd(-1), fData(0), fSize(0), fBlocks(0), fEvents(0)
+{
+   std::memset(&fTrailer, 0, sizeof(fTrailer));
+}
+//______________________________________________________________________________
+
+B1HitReader::~B1HitReader()
+{
+   Close();
+}
+//______________________________________________________________________________
+
+bool B1HitReader::Fail(const std::string& msg)
+{
+   Close();
+   fError = msg;
+   return false;
+}
+//______________________________________________________________________________
+
+bool B1HitReader::Open(const std::string& path)
+{
+   Close();
+   fError.clear();
+
+   fFd = ::open(path.c_str(), O_RDONLY);
+   if( fFd < 0 ) return Fail("cannot open " + path);
+
+   struct stat st;
+   if( ::fstat(fFd, &st) != 0 ) return Fail("cannot stat " + path);
+   fSize = st.st_size;
+   if( fSize < sizeof(B1HitFormat::FileHeader) + sizeof(B1HitFormat::Trailer) ) {
+      return Fail(path + " is too short to be a hit file");
+   }
+
+   void * p = ::mmap(0, fSize, PROT_READ, MAP_SHARED, fFd, 0);
+   if( p == MAP_FAILED ) return Fail("cannot map " + path);
+   fData = static_cast<const char*>(p);
+
+   B1HitFormat::FileHeader header;
+   std::memcpy(&header, fData, sizeof(header));
+   if( std::memcmp(header.magic, B1HitFormat::kMagic, sizeof(header.magic)) != 0 ) {
+      return Fail(path + " is not a hit file");
+   }
+   if( header.version != B1HitFormat::kVersion || header.ncolumns != B1HitFormat::kNColumns ) {
+      return Fail(path + " has an unsupported format version");
+   }
+
+   std::memcpy(&fTrailer, fData + fSize - sizeof(fTrailer), sizeof(fTrailer));
+   if( std::memcmp(fTrailer.magic, B1HitFormat::kTrailerMagic, sizeof(fTrailer.magic)) != 0 ) {
+      return Fail(path + " has no index (incomplete file?)");
+   }
+
+   // The counts are bounded by the file size first, so that the sizes
+   // below cannot overflow whatever the trailer holds
+   const std::uint64_t limit = fSize - sizeof(fTrailer);
+   if( fTrailer.nblocks > limit/sizeof(B1HitFormat::BlockIndex) ||
+       fTrailer.nevents > limit/sizeof(B1HitFormat::EventEntry) ) {
+      return Fail(path + " has a corrupt index");
+   }
+   std::uint64_t indexSize = fTrailer.nblocks*sizeof(B1HitFormat::BlockIndex)
+                           + fTrailer.nevents*sizeof(B1HitFormat::EventEntry);
+   if( fTrailer.indexOffset % 8 != 0 || fTrailer.indexOffset > limit ||
+       indexSize > limit - fTrailer.indexOffset ) {
+      return Fail(path + " has a corrupt index");
+   }
+   // the writer aligns the index, so it can be used in place
+   fBlocks = reinterpret_cast<const B1HitFormat::BlockIndex*>(fData + fTrailer.indexOffset);
+   fEvents = reinterpret_cast<const B1HitFormat::EventEntry*>(fBlocks + fTrailer.nblocks);
+
+   // Every column of every block lies before the index, and every event
+   // within its block, so that GetBlock and GetEvent need no checks
+   for(std::uint64_t i = 0; i < fTrailer.nblocks; i++) {
+      const B1HitFormat::BlockIndex& b = fBlocks[i];
+      for(int c = 0; c < B1HitFormat::kNColumns; c++) {
+         std::uint64_t offset = b.columnOffset[c];
+         std::uint64_t size   = std::uint64_t(b.nhits)*B1HitFormat::ColumnSize(c);
+         if( offset % 4 != 0 || offset > fTrailer.indexOffset || size > fTrailer.indexOffset - offset ) {
+            return Fail(path + " has a corrupt block index");
+         }
+      }
+   }
+   // and the event table is sorted, for the binary search of GetEvent
+   for(std::uint64_t i = 0; i < fTrailer.nevents; i++) {
+      const B1HitFormat::EventEntry& e = fEvents[i];
+      if( (i > 0 && e.event <= fEvents[i-1].event) || e.block >= fTrailer.nblocks ||
+          std::uint64_t(e.firstHit) + e.nhits > fBlocks[e.block].nhits ) {
+         return Fail(path + " has a corrupt event index");
+      }
+   }
+   if( fTrailer.nevents > 0 && fTrailer.firstEvent != fEvents[0].event ) {
+      return Fail(path + " has a corrupt event index");
+   }
+   return true;
+}
+//______________________________________________________________________________
+
+void B1HitReader::Close()
+{
+   if( fData ) ::munmap(const_cast<char*>(fData), fSize);
+   if( fFd >= 0 ) ::close(fFd);
+   fFd     = -1;
+   fData   = 0;
+   fSize   = 0;
+   fBlocks = 0;
+   fEvents = 0;
+   std::memset(&fTrailer, 0, sizeof(fTrailer));
+}
+//______________________________________________________________________________
+
+void B1HitReader::AdviseSequential(bool sequential)
+{
+   if( !fData ) return;
+   ::madvise(const_cast<char*>(fData), fSize, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+}
+//______________________________________________________________________________
+
+B1HitReader::Hits B1HitReader::GetBlock(std::size_t iblock) const
+{
+   const B1HitFormat::BlockIndex& b = fBlocks[iblock];
+   Hits h;
+   h.n     = b.nhits;
+   h.event = reinterpret_cast<const std::int32_t*>(fData + b.columnOffset[B1HitFormat::kEvent]);
+   h.plane = reinterpret_cast<const std::int32_t*>(fData + b.columnOffset[B1HitFormat::kPlane]);
+   h.pdg   = reinterpret_cast<const std::int32_t*>(fData + b.columnOffset[B1HitFormat::kPdg]);
+   h.x     = reinterpret_cast<const float*>(fData + b.columnOffset[B1HitFormat::kX]);
+   h.y     = reinterpret_cast<const float*>(fData + b.columnOffset[B1HitFormat::kY]);
+   h.px    = reinterpret_cast<const float*>(fData + b.columnOffset[B1HitFormat::kPx]);
+   h.py    = reinterpret_cast<const float*>(fData + b.columnOffset[B1HitFormat::kPy]);
+   h.pz    = reinterpret_cast<const float*>(fData + b.columnOffset[B1HitFormat::kPz]);
+   h.ekin  = reinterpret_cast<const float*>(fData + b.columnOffset[B1HitFormat::kEkin]);
+   h.edep  = reinterpret_cast<const float*>(fData + b.columnOffset[B1HitFormat::kEdep]);
+   return h;
+}
+//______________________________________________________________________________
+
+B1HitReader::Hits B1HitReader::GetEvent(std::int64_t event) const
+{
+   Hits none;
+   std::memset(&none, 0, sizeof(none));
+
+   if( !fData || event < fTrailer.firstEvent || event > GetLastEvent() ) return none;
+
+   const B1HitFormat::EventEntry * last = fEvents + fTrailer.nevents;
+   const B1HitFormat::EventEntry * e    = std::lower_bound(fEvents, last, event,
+      [](const B1HitFormat::EventEntry& x, std::int64_t id) { return x.event < id; });
+   if( e == last || e->event != event || e->nhits == 0 ) return none;
+   return GetBlock(e->block).Sub(e->firstHit, e->nhits);
+}
+//______________________________________________________________________________
+
+B1HitReader::Hits B1HitReader::GetEvent(std::int64_t event, std::int32_t plane) const
+{
+   Hits ev = GetEvent(event);
+   if( ev.n == 0 ) return ev;
+   const std::int32_t * first = std::lower_bound(ev.plane, ev.plane + ev.n, plane);
+   const std::int32_t * last  = std::upper_bound(first, ev.plane + ev.n, plane);
+   return ev.Sub(first - ev.plane, last - first);
+}
+//______________________________________________________________________________
+
@@ -0,0 +1,134 @@
+#include "B1HitStream.hh"
+
+#include "G4Threading.hh"
+#include <sstream>
+#include <algorithm>
+
+G4bool                      B1HitStream::fgEnabled   = false;
+G4int                       B1HitStream::fgBlockSize = 1 << 16;
+G4ThreadLocal B1HitStream * B1HitStream::fgInstance  = 0;
+
+//______________________________________________________________________________
+
+B1HitStream * B1HitStream::Instance()
+{
+   if( !fgInstance ) fgInstance = new B1HitStream();
+   return fgInstance;
+}
+//______________________________________________________________________________
+
+B1HitStream::B1HitStream() :
+   fEventID(0), fEventStart(0)
+{ }
+//______________________________________________________________________________
+
+void B1HitStream::BeginOfRun(G4int runNumber)
+{
+   fWriter.Close();
+
+   std::stringstream name;
+   name << "EBL_hits_" << runNumber;
+   if( G4Threading::G4GetThreadId() >= 0 ) name << "_t" << G4Threading::G4GetThreadId();
+   name << ".bin";
+   fPath = name.str();
+
+   std::size_t n = fgBlockSize + fgBlockSize/4;
+   fEvent.reserve(n);
+   fPlane.reserve(n);
+   fPdg.reserve(n);
+   fX.reserve(n);
+   fY.reserve(n);
+   fPx.reserve(n);
+   fPy.reserve(n);
+   fPz.reserve(n);
+   fEkin.reserve(n);
+   fEdep.reserve(n);
+   fEventStart = fEvent.size();
+}
+//______________________________________________________________________________
+
+void B1HitStream::EndOfRun()
+{
+   Flush();
+   if( fWriter.IsOpen() ) {
+      G4cout << " hits : " << fWriter.GetHitsWritten() << " written to " << fPath
+         << " (" << fWriter.GetBytesWritten()/1048576.0 << " MB)" << G4endl;
+   }
+   fWriter.Close();
+}
+//______________________________________________________________________________
+
+void B1HitStream::BeginOfEvent(G4int eventID)
+{
+   fEventID    = eventID;
+   fEventStart = fEvent.size();
+}
+//______________________________________________________________________________
+
+void B1HitStream::EndOfEvent()
+{
+   if( fEvent.size() == fEventStart ) return;
+   SortEventByPlane();
+   if( G4int(fEvent.size()) >= fgBlockSize ) Flush();
+   fEventStart = fEvent.size();
+}
+//______________________________________________________________________________
+
+template<class T>
+void B1HitStream::Permute(std::vector<T>& v, std::size_t first, const std::vector<std::size_t>& order)
+{
+   std::vector<T> tmp(v.begin() + first, v.end());
+   for(std::size_t i = 0; i < order.size(); i++) v[first + i] = tmp[order[i]];
+}
+//______________________________________________________________________________
+
+void B1HitStream::SortEventByPlane()
+{
+   // planes are usually crossed in order, in which case nothing moves
+   if( std::is_sorted(fPlane.begin() + fEventStart, fPlane.end()) ) return;
+
+   std::size_t n = fEvent.size() - fEventStart;
+   fOrder.resize(n);
+   for(std::size_t i = 0; i < n; i++) fOrder[i] = i;
+   const G4int * plane = fPlane.data() + fEventStart;
+   std::stable_sort(fOrder.begin(), fOrder.end(),
+                    [plane](std::size_t a, std::size_t b) { return plane[a] < plane[b]; });
+
+   Permute(fPlane, fEventStart, fOrder);
+   Permute(fPdg,   fEventStart, fOrder);
+   Permute(fX,     fEventStart, fOrder);
+   Permute(fY,     fEventStart, fOrder);
+   Permute(fPx,    fEventStart, fOrder);
+   Permute(fPy,    fEventStart, fOrder);
+   Permute(fPz,    fEventStart, fOrder);
+   Permute(fEkin,  fEventStart, fOrder);
+   Permute(fEdep,  fEventStart, fOrder);
+}
+//______________________________________________________________________________
+
+void B1HitStream::Flush()
+{
+   if( fEvent.empty() ) return;
+
+   if( !fWriter.IsOpen() && !fPath.empty() ) fWriter.Open(fPath);
+
+   const void * columns[B1HitFormat::kNColumns] = {
+      fEvent.data(), fPlane.data(), fPdg.data(),
+      fX.data(), fY.data(), fPx.data(), fPy.data(), fPz.data(),
+      fEkin.data(), fEdep.data() };
+   fWriter.WriteBlock(fEvent.size(), columns);
+
+   fEvent.clear();
+   fPlane.clear();
+   fPdg.clear();
+   fX.clear();
+   fY.clear();
+   fPx.clear();
+   fPy.clear();
+   fPz.clear();
+   fEkin.clear();
+   fEdep.clear();
+   fEventStart = 0;
+}
+//______________________________________________________________________________
+
@@ -0,0 +1,159 @@
+#include "B1HitWriter.hh"
+
+#include <cstring>
+
+//______________________________________________________________________________
+
+B1HitWriter::B1HitWriter() :
+   fFile(0), fBytes(0), fHits(0), fError(false)
+{ }
+//______________________________________________________________________________
+
+B1HitWriter::~B1HitWriter()
+{
+   Close();
+}
+//______________________________________________________________________________
+
+G4bool B1HitWriter::Open(const G4String& path, std::size_t bufferSize)
+{
+   Close();
+   fPath  = path;
+   fBytes = 0;
+   fHits  = 0;
+   fError = false;
+   fBlocks.clear();
+   fEvents.clear();
+
+   G4String tmp = fPath + ".tmp";
+   fFile = std::fopen(tmp.c_str(), "wb");
+   if( !fFile ) {
+      G4ExceptionDescription msg;
+      msg << "cannot open " << tmp;
+      G4Exception("B1HitWriter::Open()", "B1Hits0001", JustWarning, msg);
+      return false;
+   }
+   fBuffer.resize(bufferSize);
+   std::setvbuf(fFile, fBuffer.data(), _IOFBF, fBuffer.size());
+
+   B1HitFormat::FileHeader header;
+   std::memcpy(header.magic, B1HitFormat::kMagic, sizeof(header.magic));
+   header.version  = B1HitFormat::kVersion;
+   header.ncolumns = B1HitFormat::kNColumns;
+   Write(&header, sizeof(header));
+   return !fError;
+}
+//______________________________________________________________________________
+
+void B1HitWriter::Write(const void * data, std::size_t size)
+{
+   if( fError || size == 0 ) return;
+   if( std::fwrite(data, 1, size, fFile) != size ) {
+      fError = true;
+      G4ExceptionDescription msg;
+      msg << "write error on " << fPath << ".tmp, the hit file is dropped";
+      G4Exception("B1HitWriter::Write()", "B1Hits0002", JustWarning, msg);
+      return;
+   }
+   fBytes += size;
+}
+//______________________________________________________________________________
+
+void B1HitWriter::WriteBlock(std::uint32_t nhits, const void * const * columns)
+{
+   if( !fFile || nhits == 0 ) return;
+
+   const std::int32_t * event = static_cast<const std::int32_t*>(columns[B1HitFormat::kEvent]);
+   const std::int32_t * plane = static_cast<const std::int32_t*>(columns[B1HitFormat::kPlane]);
+
+   B1HitFormat::BlockIndex index;
+   index.offset     = fBytes;
+   index.nhits      = nhits;
+   index.firstEvent = event[0];
+   index.lastEvent  = event[nhits - 1];
+   index.nevents    = 0;
+   index.planeMin   = plane[0];
+   index.planeMax   = plane[0];
+
+   // event ranges of the block
+   std::uint32_t iblock = fBlocks.size();
+   for(std::uint32_t i = 0; i < nhits; i++) {
+      if( i == 0 || event[i] != event[i-1] ) {
+         B1HitFormat::EventEntry r = {event[i], iblock, i, 0};
+         fEvents.push_back(r);
+         index.nevents++;
+      }
+      fEvents.back().nhits++;
+      if( plane[i] < index.planeMin ) index.planeMin = plane[i];
+      if( plane[i] > index.planeMax ) index.planeMax = plane[i];
+   }
+
+   B1HitFormat::BlockHeader header;
+   header.nhits      = nhits;
+   header.firstEvent = index.firstEvent;
+   header.lastEvent  = index.lastEvent;
+   header.nevents    = index.nevents;
+   Write(&header, sizeof(header));
+
+   for(int c = 0; c < B1HitFormat::kNColumns; c++) {
+      index.columnOffset[c] = fBytes;
+      Write(columns[c], std::size_t(nhits)*B1HitFormat::ColumnSize(c));
+   }
+   fBlocks.push_back(index);
+   fHits += nhits;
+}
+//______________________________________________________________________________
+
+void B1HitWriter::Pad(std::size_t alignment)
+{
+   static const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+   std::size_t n = (alignment - fBytes % alignment) % alignment;
+   Write(zeros, n);
+}
+//______________________________________________________________________________
+
+void B1HitWriter::WriteIndex()
+{
+   Pad(8);
+
+   B1HitFormat::Trailer trailer;
+   trailer.indexOffset = fBytes;
+   trailer.nblocks     = fBlocks.size();
+   trailer.firstEvent  = fEvents.empty() ? 0 : fEvents.front().event;
+   trailer.nevents     = fEvents.size();
+   trailer.nhits       = fHits;
+   std::memcpy(trailer.magic, B1HitFormat::kTrailerMagic, sizeof(trailer.magic));
+
+   if( !fBlocks.empty() ) Write(fBlocks.data(), fBlocks.size()*sizeof(B1HitFormat::BlockIndex));
+
+   // the events of this file only, already sorted since they come in
+   // increasing order
+   if( !fEvents.empty() ) Write(fEvents.data(), fEvents.size()*sizeof(B1HitFormat::EventEntry));
+   Pad(8);
+   Write(&trailer, sizeof(trailer));
+}
+//______________________________________________________________________________
+
+void B1HitWriter::Close()
+{
+   if( !fFile ) return;
+
+   WriteIndex();
+   fBlocks.clear();
+   fEvents.clear();
+
+   G4String tmp = fPath + ".tmp";
+   if( std::fclose(fFile) != 0 ) fError = true;
+   fFile = 0;
+   fBuffer.clear();
+   fBuffer.shrink_to_fit();
+
+   if( fError || std::rename(tmp.c_str(), fPath.c_str()) != 0 ) {
+      std::remove(tmp.c_str());
+      G4ExceptionDescription msg;
+      msg << "could not write " << fPath;
+      G4Exception("B1HitWriter::Close()", "B1Hits0003", JustWarning, msg);
+   }
+}
+//______________________________________________________________________________
+
@@ -0,0 +1,165 @@
+#include "B1MaterialRegistry.hh"
+
+#include "G4Material.hh"
+#include "G4Element.hh"
+#include "G4NistManager.hh"
+#include "G4MaterialPropertiesTable.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+//______________________________________________________________________________
+
+B1MaterialRegistry * B1MaterialRegistry::Instance()
+{
+   static B1MaterialRegistry instance;
+   return &instance;
+}
+//______________________________________________________________________________
+
+B1MaterialRegistry::B1MaterialRegistry() :
+   fNBuilt(0), fNMPTs(0), fNRequests(0)
+{ }
+//______________________________________________________________________________
+
+B1MaterialRegistry::~B1MaterialRegistry()
+{
+   // materials and elements are owned by their global tables
+}
+//______________________________________________________________________________
+
+std::size_t B1MaterialRegistry::GetTableSize()
+{
+   return G4Material::GetNumberOfMaterials();
+}
+//______________________________________________________________________________
+
+G4Element * B1MaterialRegistry::GetElement(const G4String& name)
+{
+   auto it = fElements.find(name);
+   if( it != fElements.end() ) return it->second;
+
+   G4Element * el = G4Element::GetElement(name, false);
+   if( !el ) {
+      if(      name == "Hydrogen" ) el = new G4Element("Hydrogen", "H",  1.0, 1.01*g/mole);
+      else if( name == "Carbon"   ) el = new G4Element("Carbon"  , "C",  6.0, 12.01*g/mole);
+      else if( name == "Argon"    ) el = new G4Element("Argon"   , "Ar", 18.0, 39.95*g/mole);
+      else {
+         G4ExceptionDescription msg;
+         msg << "Unknown element " << name;
+         G4Exception("B1MaterialRegistry::GetElement()", "B1Mat0001", JustWarning, msg);
+         return 0;
+      }
+   }
+   fElements[name] = el;
+   return el;
+}
+//______________________________________________________________________________
+
+G4Material * B1MaterialRegistry::GetMaterial(const G4String& name)
+{
+   fNRequests++;
+   auto it = fMaterials.find(name);
+   if( it != fMaterials.end() ) return it->second;
+
+   G4Material * mat = G4Material::GetMaterial(name, false);
+   if( !mat ) {
+      if( name.compare(0, 3, "G4_") == 0 ) {
+         mat = G4NistManager::Instance()->FindOrBuildMaterial(name);
+      } else {
+         mat = BuildMaterial(name);
+      }
+   }
+   if( !mat ) {
+      G4ExceptionDescription msg;
+      msg << "Unknown material " << name;
+      G4Exception("B1MaterialRegistry::GetMaterial()", "B1Mat0002", JustWarning, msg);
+      return 0;
+   }
+
+   fMaterials[name] = mat;
+   return mat;
+}
+//______________________________________________________________________________
+
+G4Material * B1MaterialRegistry::BuildMaterial(const G4String& name)
+{
+   G4Material * mat = 0;
+
+   if( name == "beampipe_mat" ) {
+      // beam vacuum
+      G4double density     = universe_mean_density;
+      G4double pressure    = 1.e-7*bar;
+      G4double temperature = 0.1*kelvin;
+      mat = new G4Material("beampipe_mat", /*z=*/1.0, /*a=*/1.01*g/mole, density, kStateGas,temperature,pressure);
+
+   } else if( name == "Scintillator" ) {
+      // radiator
+      mat = new G4Material("Scintillator", 1.032*g/cm3, 2);
+      mat->AddElement(GetElement("Carbon"), 9);
+      mat->AddElement(GetElement("Hydrogen"), 10);
+      mat->SetMaterialPropertiesTable(BuildScintillatorMPT());
+
+   } else if( name == "DC_gas" ) {
+      // Drift chamber gas
+      mat = new G4Material("DC_gas", /* density = */ 1.8*mg/cm3, /*nel = */ 3);
+      mat->AddElement(GetElement("Argon"), 90*perCent);
+      mat->AddMaterial(GetMaterial("G4_O"),  6.6*perCent);
+      mat->AddMaterial(GetMaterial("G4_C"),  3.4*perCent);
+   }
+
+   if(mat) fNBuilt++;
+   return mat;
+}
+//______________________________________________________________________________
+
+G4MaterialPropertiesTable * B1MaterialRegistry::BuildScintillatorMPT()
+{
+   const G4int NUMENTRIES = 9;
+   G4double Scnt_PP[NUMENTRIES] = { 1.6*eV, 6.7*eV, 6.8*eV, 6.9*eV,
+      7.0*eV, 7.1*eV, 7.2*eV, 7.3*eV, 7.4*eV };
+
+   G4double Scnt_FAST[NUMENTRIES] = { 0.000134, 0.004432, 0.053991, 0.241971,
+      0.398942, 0.000134, 0.004432, 0.053991,
+      0.241971 };
+   G4double Scnt_SLOW[NUMENTRIES] = { 0.000010, 0.000020, 0.000030, 0.004000,
+      0.008000, 0.005000, 0.020000, 0.001000,
+      0.000010 };
+   G4double rindex[NUMENTRIES]     = { 1.58, 1.58, 1.58, 1.58, 1.58, 1.58, 1.58, 1.58, 1.58 };
+
+   G4MaterialPropertiesTable* Scnt_MPT = new G4MaterialPropertiesTable();
+
+   Scnt_MPT->AddProperty("FASTCOMPONENT", Scnt_PP, Scnt_FAST, NUMENTRIES);
+   Scnt_MPT->AddProperty("SLOWCOMPONENT", Scnt_PP, Scnt_SLOW, NUMENTRIES);
+   Scnt_MPT->AddProperty(     "RINDEX"  , Scnt_PP, rindex,    NUMENTRIES);
+   Scnt_MPT->AddConstProperty("SCINTILLATIONYIELD", 1./MeV);
+   Scnt_MPT->AddConstProperty("RESOLUTIONSCALE", 2.0);
+   Scnt_MPT->AddConstProperty("FASTTIMECONSTANT",  1.*ns);
+   Scnt_MPT->AddConstProperty("SLOWTIMECONSTANT", 10.*ns);
+   Scnt_MPT->AddConstProperty("YIELDRATIO", 0.8);
+
+   fNMPTs++;
+   return Scnt_MPT;
+}
+//______________________________________________________________________________
+
+void B1MaterialRegistry::Print() const
+{
+   G4int nmpt = 0;
+   for(auto mat : *G4Material::GetMaterialTable()) {
+      if( mat->GetMaterialPropertiesTable() ) nmpt++;
+   }
+   G4cout << "------------------------------------------------------------------------\n";
+   G4cout << " Material registry\n"
+      << "        cached materials : " << fMaterials.size() << "\n"
+      << "        built (non-NIST) : " << fNBuilt << "\n"
+      << "         property tables : " << fNMPTs << " built, " << nmpt << " in use\n"
+      << "                requests : " << fNRequests << "\n"
+      << "       G4 material table : " << G4Material::GetNumberOfMaterials() << " materials\n"
+      << "        G4 element table : " << G4Element::GetNumberOfElements() << " elements\n";
+   for(const auto& m : fMaterials) {
+      G4cout << "   " << m.first << " (" << m.second->GetDensity()/(g/cm3) << " g/cm3)\n";
+   }
+   G4cout << G4endl;
+}
+//______________________________________________________________________________
+
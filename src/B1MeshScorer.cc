@@ -0,0 +1,238 @@
+#include "B1MeshScorer.hh"
+#include "B1MeshFormat.hh"
+
+#include "G4RegionStore.hh"
+#include "G4Region.hh"
+#include "G4TransportationManager.hh"
+#include "G4Navigator.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4VSolid.hh"
+#include "G4VisExtent.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4AutoLock.hh"
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+namespace {
+   G4Mutex meshMutex = G4MUTEX_INITIALIZER;
+}
+
+G4bool                       B1MeshScorer::fgEnabled     = false;
+G4double                     B1MeshScorer::fgBinSize     = 1.0*mm;
+G4String                     B1MeshScorer::fgRegionNames = "Radiator Chamber";
+B1VoxelHash                * B1MeshScorer::fgMerged      = 0;
+std::size_t                  B1MeshScorer::fgPeakMemory  = 0;
+G4ThreadLocal B1MeshScorer * B1MeshScorer::fgInstance    = 0;
+
+//______________________________________________________________________________
+
+B1MeshScorer * B1MeshScorer::Instance()
+{
+   if( !fgInstance ) fgInstance = new B1MeshScorer();
+   return fgInstance;
+}
+//______________________________________________________________________________
+
+B1MeshScorer::B1MeshScorer() :
+   fInv(1.0/fgBinSize), fOutside(0)
+{ }
+//______________________________________________________________________________
+
+void B1MeshScorer::BeginOfRun()
+{
+   fInv     = 1.0/fgBinSize;
+   fOutside = 0;
+   fTable.Clear();
+
+   fRegions.clear();
+   std::istringstream is(fgRegionNames);
+   G4String name;
+   while( is >> name ) {
+      G4Region * region = G4RegionStore::GetInstance()->GetRegion(name, false);
+      if( !region ) {
+         G4ExceptionDescription msg;
+         msg << "no region " << name << ", it is not scored in the mesh";
+         G4Exception("B1MeshScorer::BeginOfRun()", "B1Mesh0001", JustWarning, msg);
+         continue;
+      }
+      fRegions.push_back(region);
+   }
+}
+//______________________________________________________________________________
+
+G4bool B1MeshScorer::Select(std::vector<const G4LogicalVolume*>& volumes,
+                            std::vector<const G4ParticleDefinition*>&)
+{
+   if( !fgEnabled || fRegions.empty() ) return false;
+   for(const G4LogicalVolume * lv : *G4LogicalVolumeStore::GetInstance()) {
+      if( std::find(fRegions.begin(), fRegions.end(), lv->GetRegion()) != fRegions.end() ) volumes.push_back(lv);
+   }
+   return !volumes.empty();
+}
+//______________________________________________________________________________
+
+void B1MeshScorer::Deposit(const G4ThreeVector& p1, const G4ThreeVector& p2, G4double edep, G4double length)
+{
+   // in units of the bin size
+   G4double a[3] = { p1.x()*fInv, p1.y()*fInv, p1.z()*fInv };
+   G4double b[3] = { p2.x()*fInv, p2.y()*fInv, p2.z()*fInv };
+   G4int    i[3], last[3];
+   for(G4int k = 0; k < 3; k++) {
+      i[k]    = G4int(std::floor(a[k]));
+      last[k] = G4int(std::floor(b[k]));
+   }
+   if( i[0] == last[0] && i[1] == last[1] && i[2] == last[2] ) {
+      Add(i, edep, length);
+      return;
+   }
+
+   // walk the voxels along the chord (Amanatides & Woo), t from 0 to 1,
+   // sharing the step in proportion to the chord length in each voxel
+   const G4double kInfinity = std::numeric_limits<G4double>::max();
+   G4int    dir[3];
+   G4double tMax[3], tDelta[3];
+   G4int    nvoxels = 1;
+   for(G4int k = 0; k < 3; k++) {
+      G4double d = b[k] - a[k];
+      if( d > 0.0 ) {
+         dir[k]    = 1;
+         tDelta[k] = 1.0/d;
+         tMax[k]   = (i[k] + 1 - a[k])/d;
+      } else if( d < 0.0 ) {
+         dir[k]    = -1;
+         tDelta[k] = -1.0/d;
+         tMax[k]   = (i[k] - a[k])/d;
+      } else {
+         dir[k]    = 0;
+         tDelta[k] = kInfinity;
+         tMax[k]   = kInfinity;
+      }
+      nvoxels += std::abs(last[k] - i[k]);
+   }
+
+   G4double t = 0.0;
+   for(G4int n = 0; n < nvoxels; n++) {
+      G4int k = (tMax[0] < tMax[1]) ? ((tMax[0] < tMax[2]) ? 0 : 2) : ((tMax[1] < tMax[2]) ? 1 : 2);
+      G4double tNext = (n == nvoxels - 1) ? 1.0 : std::min(tMax[k], 1.0);
+      Add(i, (tNext - t)*edep, (tNext - t)*length);
+      if( tNext >= 1.0 ) break;
+      t        = tNext;
+      i[k]    += dir[k];
+      tMax[k] += tDelta[k];
+   }
+}
+//______________________________________________________________________________
+
+void B1MeshScorer::EndOfRun()
+{
+   if( fOutside > 0 ) {
+      G4ExceptionDescription msg;
+      msg << fOutside << " deposits fell outside the mesh index range and were dropped;"
+         << " increase /B1/run/meshBinSize";
+      G4Exception("B1MeshScorer::EndOfRun()", "B1Mesh0002", JustWarning, msg);
+   }
+
+   G4AutoLock lock(&meshMutex);
+   if( !fgMerged ) fgMerged = new B1VoxelHash(2*fTable.GetSize());
+   fgMerged->Merge(fTable);
+   fgPeakMemory = std::max(fgPeakMemory, fTable.GetMemory());
+   fTable.Clear();
+}
+//______________________________________________________________________________
+
+void B1MeshScorer::Write(G4int runNumber, G4int nevents)
+{
+   G4AutoLock lock(&meshMutex);
+   if( !fgMerged || fgMerged->GetSize() == 0 ) return;
+
+   // sorted by key, i.e. by iz, iy, ix
+   std::vector<B1VoxelHash::Entry> entries;
+   entries.reserve(fgMerged->GetSize());
+   for(const B1VoxelHash::Entry& e : fgMerged->GetEntries()) {
+      if( e.key != B1VoxelHash::kEmpty ) entries.push_back(e);
+   }
+   std::sort(entries.begin(), entries.end(),
+             [](const B1VoxelHash::Entry& a, const B1VoxelHash::Entry& b) { return a.key < b.key; });
+
+   std::stringstream name;
+   name << "EBL_mesh_" << runNumber << ".bin";
+   G4String path = name.str();
+   G4String tmp  = path + ".tmp";
+
+   B1MeshFormat::FileHeader header;
+   std::memcpy(header.magic, B1MeshFormat::kMagic, sizeof(header.magic));
+   header.version    = B1MeshFormat::kVersion;
+   header.reserved   = 0;
+   header.binSize[0] = fgBinSize/mm;
+   header.binSize[1] = fgBinSize/mm;
+   header.binSize[2] = fgBinSize/mm;
+   header.nvoxels    = entries.size();
+   header.nevents    = nevents;
+
+   G4int lo[3] = {  std::numeric_limits<G4int>::max(),  std::numeric_limits<G4int>::max(),  std::numeric_limits<G4int>::max() };
+   G4int hi[3] = { -std::numeric_limits<G4int>::max(), -std::numeric_limits<G4int>::max(), -std::numeric_limits<G4int>::max() };
+
+   std::FILE * file = std::fopen(tmp.c_str(), "wb");
+   G4bool      ok   = (file != 0);
+   if( ok ) ok = (std::fwrite(&header, sizeof(header), 1, file) == 1);
+   for(std::size_t n = 0; ok && n < entries.size(); n++) {
+      B1MeshFormat::Voxel v;
+      B1VoxelHash::Index(entries[n].key, v.ix, v.iy, v.iz);
+      v.reserved = 0;
+      v.edep     = entries[n].edep/MeV;
+      v.length   = entries[n].length/mm;
+      ok = (std::fwrite(&v, sizeof(v), 1, file) == 1);
+
+      G4int idx[3] = { v.ix, v.iy, v.iz };
+      for(G4int k = 0; k < 3; k++) {
+         lo[k] = std::min(lo[k], idx[k]);
+         hi[k] = std::max(hi[k], idx[k]);
+      }
+   }
+   if( file && std::fclose(file) != 0 ) ok = false;
+   if( !ok || std::rename(tmp.c_str(), path.c_str()) != 0 ) {
+      std::remove(tmp.c_str());
+      G4ExceptionDescription msg;
+      msg << "cannot write " << path << ", the mesh is dropped";
+      G4Exception("B1MeshScorer::Write()", "B1Mesh0003", JustWarning, msg);
+   }
+
+   // memory against dense meshes at 1 mm, with the same two sums per voxel
+   const G4double kMB      = 1048576.0;
+   const G4double voxelMem = sizeof(B1MeshFormat::Voxel::edep) + sizeof(B1MeshFormat::Voxel::length);
+   G4double scale   = fgBinSize/mm;
+   G4double boxMem  = voxelMem;
+   for(G4int k = 0; k < 3; k++) boxMem *= (hi[k] - lo[k] + 1)*scale;
+
+   G4double worldMem = 0.0;
+   G4VPhysicalVolume * world = G4TransportationManager::GetTransportationManager()
+      ->GetNavigatorForTracking()->GetWorldVolume();
+   if( world ) {
+      G4VisExtent extent = world->GetLogicalVolume()->GetSolid()->GetExtent();
+      worldMem = voxelMem
+         * std::ceil((extent.GetXmax() - extent.GetXmin())/mm)
+         * std::ceil((extent.GetYmax() - extent.GetYmin())/mm)
+         * std::ceil((extent.GetZmax() - extent.GetZmin())/mm);
+   }
+
+   G4cout << G4endl
+      << std::setw(24) << "mesh" << " : " << entries.size() << " voxels of " << scale << " mm written to " << path
+      << " (" << (sizeof(header) + entries.size()*sizeof(B1MeshFormat::Voxel))/kMB << " MB)" << G4endl
+      << std::setw(24) << "hash table" << " : " << fgMerged->GetMemory()/kMB << " MB merged, "
+      << fgPeakMemory/kMB << " MB per thread at most" << G4endl
+      << std::setw(24) << "dense 1 mm, scored box" << " : " << boxMem/kMB << " MB" << G4endl
+      << std::setw(24) << "dense 1 mm, world" << " : " << worldMem/kMB << " MB" << G4endl;
+
+   fgMerged->Clear();
+   fgPeakMemory = 0;
+}
+//______________________________________________________________________________
+
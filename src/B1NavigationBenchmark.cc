@@ -0,0 +1,214 @@
+#include "B1NavigationBenchmark.hh"
+
+#include "G4Navigator.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+   using bench_clock = std::chrono::steady_clock;
+
+   inline G4double Seconds(const bench_clock::time_point& a, const bench_clock::time_point& b)
+   {
+      return std::chrono::duration<G4double>(b - a).count();
+   }
+}
+//______________________________________________________________________________
+
+B1NavigationBenchmark::B1NavigationBenchmark(G4VPhysicalVolume * massWorld, G4VPhysicalVolume * parallelWorld) :
+   fMassNavigator(new G4Navigator()),
+   fParallelNavigator(0),
+   fPattern(kCone),
+   fNTracks(10000),
+   fOrigin(0.0, 0.0, -20.0*cm),
+   fSpot(1.0*mm),
+   fConeAngle(30.0*degree),
+   fMaxSteps(100000),
+   fSeed(12345)
+{
+   fMassNavigator->SetWorldVolume(massWorld);
+   if(parallelWorld) {
+      fParallelNavigator = new G4Navigator();
+      fParallelNavigator->SetWorldVolume(parallelWorld);
+   }
+}
+//______________________________________________________________________________
+
+B1NavigationBenchmark::~B1NavigationBenchmark()
+{
+   delete fMassNavigator;
+   delete fParallelNavigator;
+}
+//______________________________________________________________________________
+
+G4int B1NavigationBenchmark::PatternFromName(const G4String& name)
+{
+   if( name == "pencil" ) return kPencil;
+   if( name == "cone"   ) return kCone;
+   if( name == "iso"    ) return kIsotropic;
+   if( name == "grid"   ) return kGrid;
+   return -1;
+}
+//______________________________________________________________________________
+
+void B1NavigationBenchmark::GenerateTracks(std::vector<G4ThreeVector>& pos, std::vector<G4ThreeVector>& dir) const
+{
+   std::mt19937_64 gen(fSeed);
+   std::uniform_real_distribution<double> flat(0.0, 1.0);
+
+   pos.clear();
+   dir.clear();
+   pos.reserve(fNTracks);
+   dir.reserve(fNTracks);
+
+   G4int ngrid = std::max(1, int(std::sqrt(double(fNTracks))));
+
+   for(int i = 0; i < fNTracks; i++) {
+      G4ThreeVector p = fOrigin;
+      G4ThreeVector v(0.0, 0.0, 1.0);
+
+      if( fPattern == kGrid ) {
+         G4int    ix   = i%ngrid;
+         G4int    iy   = (i/ngrid)%ngrid;
+         G4double step = (ngrid > 1) ? 2.0*fSpot/(ngrid-1) : 0.0;
+         p += G4ThreeVector(-fSpot + ix*step, -fSpot + iy*step, 0.0);
+      } else {
+         p += G4ThreeVector(fSpot*(2.0*flat(gen)-1.0), fSpot*(2.0*flat(gen)-1.0), 0.0);
+      }
+
+      if( fPattern == kCone || fPattern == kIsotropic ) {
+         G4double cosmin = (fPattern == kCone) ? std::cos(fConeAngle) : -1.0;
+         G4double cost   = 1.0 - (1.0 - cosmin)*flat(gen);
+         G4double sint   = std::sqrt((1.0-cost)*(1.0+cost));
+         G4double phi    = twopi*flat(gen);
+         v = G4ThreeVector(sint*std::cos(phi), sint*std::sin(phi), cost);
+      }
+      pos.push_back(p);
+      dir.push_back(v);
+   }
+}
+//______________________________________________________________________________
+
+B1NavigationBenchmark::Result B1NavigationBenchmark::Run()
+{
+   Result r;
+   r.tracks       = 0;
+   r.steps        = 0;
+   r.totalTime    = 0.0;
+   r.massTime     = 0.0;
+   r.parallelTime = 0.0;
+
+   std::vector<G4ThreeVector> start;
+   std::vector<G4ThreeVector> direction;
+   GenerateTracks(start, direction);
+
+   bench_clock::time_point t_begin = bench_clock::now();
+
+   for(int itrack = 0; itrack < fNTracks; itrack++) {
+      G4ThreeVector pos = start[itrack];
+      G4ThreeVector dir = direction[itrack];
+
+      G4VPhysicalVolume * pv = fMassNavigator->LocateGlobalPointAndSetup(pos, &dir, false, false);
+      if(fParallelNavigator) fParallelNavigator->LocateGlobalPointAndSetup(pos, &dir, false, false);
+      r.tracks++;
+
+      for(int istep = 0; pv && istep < fMaxSteps; istep++) {
+         G4double safety     = 0.0;
+         G4double psafety    = 0.0;
+         G4double para_step  = kInfinity;
+
+         bench_clock::time_point t0 = bench_clock::now();
+         G4double mass_step = fMassNavigator->ComputeStep(pos, dir, kInfinity, safety);
+         bench_clock::time_point t1 = bench_clock::now();
+         if(fParallelNavigator) para_step = fParallelNavigator->ComputeStep(pos, dir, kInfinity, psafety);
+         bench_clock::time_point t2 = bench_clock::now();
+
+         G4double step = std::min(mass_step, para_step);
+         if( step == kInfinity ) break;
+         pos += step*dir;
+
+         // Only the navigators that limited the step cross a boundary, the
+         // others are just relocated within their current volume.
+         bench_clock::time_point t3 = bench_clock::now();
+         G4VPhysicalVolume * next = 0;
+         if( mass_step <= step ) {
+            fMassNavigator->SetGeometricallyLimitedStep();
+            next = fMassNavigator->LocateGlobalPointAndSetup(pos, &dir, true, false);
+         } else {
+            fMassNavigator->LocateGlobalPointWithinVolume(pos);
+            next = pv;
+         }
+         bench_clock::time_point t4 = bench_clock::now();
+         if(fParallelNavigator) {
+            if( para_step <= step ) {
+               fParallelNavigator->SetGeometricallyLimitedStep();
+               fParallelNavigator->LocateGlobalPointAndSetup(pos, &dir, true, false);
+            } else {
+               fParallelNavigator->LocateGlobalPointWithinVolume(pos);
+            }
+         }
+         bench_clock::time_point t5 = bench_clock::now();
+
+         G4double mass_time = Seconds(t0, t1) + Seconds(t3, t4);
+         r.massTime     += mass_time;
+         r.parallelTime += Seconds(t1, t2) + Seconds(t4, t5);
+         r.steps++;
+
+         VolumeStat& vs = r.volumes[pv->GetLogicalVolume()];
+         vs.steps++;
+         vs.time += mass_time;
+
+         pv = next;
+      }
+   }
+
+   r.totalTime = Seconds(t_begin, bench_clock::now());
+   return r;
+}
+//______________________________________________________________________________
+
+void B1NavigationBenchmark::Print(const Result& r)
+{
+   G4cout << "------------------------------------------------------------------------\n";
+   G4cout << " Navigation benchmark\n"
+      << "                  tracks : " << r.tracks << "\n"
+      << "                   steps : " << r.steps << "\n"
+      << "              total time : " << r.totalTime << " s\n"
+      << "                 steps/s : " << ((r.totalTime > 0.0) ? r.steps/r.totalTime : 0.0) << "\n"
+      << "   mass navigator time   : " << r.massTime << " s\n"
+      << "   parallel navigator    : " << r.parallelTime << " s";
+   if( r.massTime + r.parallelTime > 0.0 ) {
+      G4cout << " (" << 100.0*r.parallelTime/(r.massTime + r.parallelTime) << " % of navigation)";
+   }
+   G4cout << "\n";
+
+   // sort volumes by time spent
+   std::vector< std::pair<const G4LogicalVolume*, VolumeStat> > vols(r.volumes.begin(), r.volumes.end());
+   std::sort(vols.begin(), vols.end(),
+             [](const std::pair<const G4LogicalVolume*, VolumeStat>& a,
+                const std::pair<const G4LogicalVolume*, VolumeStat>& b) { return a.second.time > b.second.time; });
+
+   G4cout << std::setw(24) << "volume"
+      << std::setw(22) << "solid"
+      << std::setw(12) << "steps"
+      << std::setw(14) << "time (s)"
+      << std::setw(14) << "ns/step" << "\n";
+   for(const auto& v : vols) {
+      G4cout << std::setw(24) << v.first->GetName()
+         << std::setw(22) << v.first->GetSolid()->GetEntityType()
+         << std::setw(12) << v.second.steps
+         << std::setw(14) << v.second.time
+         << std::setw(14) << ((v.second.steps > 0) ? 1.0e9*v.second.time/v.second.steps : 0.0) << "\n";
+   }
+   G4cout << G4endl;
+}
+//______________________________________________________________________________
+
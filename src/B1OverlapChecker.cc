@@ -0,0 +1,321 @@
+#include "B1OverlapChecker.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VPVParameterisation.hh"
+#include "G4VSolid.hh"
+#include "G4Box.hh"
+#include "G4VisExtent.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <map>
+#include <algorithm>
+#include <iomanip>
+
+namespace {
+   using check_clock = std::chrono::steady_clock;
+
+   G4ThreeVector PointOnBox(const G4Box * box, std::mt19937_64& gen)
+   {
+      // faces are picked with a probability proportional to their area
+      std::uniform_real_distribution<double> flat(-1.0, 1.0);
+      G4double dx = box->GetXHalfLength();
+      G4double dy = box->GetYHalfLength();
+      G4double dz = box->GetZHalfLength();
+      G4double sxy = dx*dy, sxz = dx*dz, syz = dy*dz;
+      G4double u    = 0.5*(flat(gen) + 1.0)*(sxy + sxz + syz);
+      G4double sign = (flat(gen) < 0.0) ? -1.0 : 1.0;
+      if( u < sxy )       return G4ThreeVector(dx*flat(gen), dy*flat(gen), sign*dz);
+      if( u < sxy + sxz ) return G4ThreeVector(dx*flat(gen), sign*dy, dz*flat(gen));
+      return G4ThreeVector(sign*dx, dy*flat(gen), dz*flat(gen));
+   }
+
+   G4ThreeVector PointOnSurface(const G4VSolid * solid, std::mt19937_64& gen)
+   {
+      if( solid->GetEntityType() == "G4Box" ) {
+         return PointOnBox(static_cast<const G4Box*>(solid), gen);
+      }
+      return solid->GetPointOnSurface();
+   }
+
+   void Extent(const G4VSolid * solid, const G4AffineTransform& t, G4ThreeVector& bmin, G4ThreeVector& bmax)
+   {
+      G4VisExtent ext = solid->GetExtent();
+      bmin = G4ThreeVector( kInfinity,  kInfinity,  kInfinity);
+      bmax = G4ThreeVector(-kInfinity, -kInfinity, -kInfinity);
+      for(int i = 0; i < 8; i++) {
+         G4ThreeVector c( (i&1) ? ext.GetXmax() : ext.GetXmin(),
+                          (i&2) ? ext.GetYmax() : ext.GetYmin(),
+                          (i&4) ? ext.GetZmax() : ext.GetZmin() );
+         c = t.TransformPoint(c);
+         bmin.set(std::min(bmin.x(), c.x()), std::min(bmin.y(), c.y()), std::min(bmin.z(), c.z()));
+         bmax.set(std::max(bmax.x(), c.x()), std::max(bmax.y(), c.y()), std::max(bmax.z(), c.z()));
+      }
+   }
+}
+//______________________________________________________________________________
+
+B1OverlapChecker::B1OverlapChecker() :
+   fNThreads(std::max(1u, std::thread::hardware_concurrency())),
+   fNPoints(1000),
+   fTimeBudget(60.0),
+   fPointBudget(0),
+   fTolerance(0.0),
+   fSeed(12345)
+{ }
+//______________________________________________________________________________
+
+B1OverlapChecker::~B1OverlapChecker()
+{
+   ClearInstances();
+}
+//______________________________________________________________________________
+
+void B1OverlapChecker::ClearInstances()
+{
+   for(auto& inst : fInstances) delete inst.owned;
+   fInstances.clear();
+   fMothers.clear();
+}
+//______________________________________________________________________________
+
+G4bool B1OverlapChecker::BuildInstances(const std::vector<G4LogicalVolume*>& mothers)
+{
+   check_clock::time_point t_begin = check_clock::now();
+   ClearInstances();
+   fMothers = mothers;
+
+   for(std::size_t imother = 0; imother < mothers.size(); imother++) {
+      G4LogicalVolume * mother = mothers[imother];
+      std::size_t       first  = fInstances.size();
+
+      for(int i = 0; i < mother->GetNoDaughters(); i++) {
+         G4VPhysicalVolume * pv = mother->GetDaughter(i);
+
+         if( pv->IsParameterised() ) {
+            // Each copy is computed once here, so that the threads only
+            // ever see constant solids and transforms.
+            G4VPVParameterisation * param = pv->GetParameterisation();
+            for(int copy = 0; copy < pv->GetMultiplicity(); copy++) {
+               G4VSolid * solid = param->ComputeSolid(copy, pv);
+               solid->ComputeDimensions(param, copy, pv);
+               param->ComputeTransformation(copy, pv);
+
+               Instance inst;
+               inst.name     = pv->GetName();
+               inst.copyNo   = copy;
+               inst.mother   = imother;
+               inst.owned    = solid->Clone();
+               inst.solid    = inst.owned;
+               inst.toMother = G4AffineTransform(pv->GetRotation(), pv->GetTranslation());
+               fInstances.push_back(inst);
+            }
+            continue;
+         }
+         if( pv->IsReplicated() ) {
+            G4ExceptionDescription msg;
+            msg << "replica " << pv->GetName() << " is not checked";
+            G4Exception("B1OverlapChecker::Check()", "B1Overlap0001", JustWarning, msg);
+            continue;
+         }
+
+         Instance inst;
+         inst.name     = pv->GetName();
+         inst.copyNo   = pv->GetCopyNo();
+         inst.mother   = imother;
+         inst.owned    = 0;
+         inst.solid    = pv->GetLogicalVolume()->GetSolid();
+         inst.toMother = G4AffineTransform(pv->GetRotation(), pv->GetTranslation());
+         fInstances.push_back(inst);
+      }
+
+      for(std::size_t i = first; i < fInstances.size(); i++) {
+         Instance& inst  = fInstances[i];
+         inst.fromMother = inst.toMother.Inverse();
+         Extent(inst.solid, inst.toMother, inst.bmin, inst.bmax);
+      }
+
+      // Siblings whose bounding boxes intersect: sorted by their lower
+      // edge along the axis where the boxes are most spread out, each box
+      // is only compared with the following ones up to its upper edge
+      std::size_t n = fInstances.size() - first;
+      if( n < 2 ) continue;
+      G4int    axis   = 0;
+      G4double spread = -1.0;
+      for(G4int k = 0; k < 3; k++) {
+         G4double lo = kInfinity, hi = -kInfinity;
+         for(std::size_t i = first; i < fInstances.size(); i++) {
+            lo = std::min(lo, fInstances[i].bmin[k]);
+            hi = std::max(hi, fInstances[i].bmin[k]);
+         }
+         if( hi - lo > spread ) { spread = hi - lo; axis = k; }
+      }
+
+      std::vector<G4int> order(n);
+      for(std::size_t k = 0; k < n; k++) order[k] = first + k;
+      std::sort(order.begin(), order.end(),
+                [&](G4int a, G4int b) { return fInstances[a].bmin[axis] < fInstances[b].bmin[axis]; });
+
+      for(std::size_t k = 0; k < n; k++) {
+         Instance& a = fInstances[order[k]];
+         for(std::size_t l = k + 1; l < n; l++) {
+            Instance& b = fInstances[order[l]];
+            if( b.bmin[axis] > a.bmax[axis] + fTolerance ) break;
+            if( a.bmin.x() > b.bmax.x() + fTolerance || b.bmin.x() > a.bmax.x() + fTolerance ) continue;
+            if( a.bmin.y() > b.bmax.y() + fTolerance || b.bmin.y() > a.bmax.y() + fTolerance ) continue;
+            if( a.bmin.z() > b.bmax.z() + fTolerance || b.bmin.z() > a.bmax.z() + fTolerance ) continue;
+            a.neighbours.push_back(order[l]);
+            b.neighbours.push_back(order[k]);
+         }
+         if( (k & 255) == 255 && fTimeBudget > 0.0 ) {
+            std::chrono::duration<G4double> dt = check_clock::now() - t_begin;
+            if( dt.count() > fTimeBudget ) return false;
+         }
+      }
+   }
+   return true;
+}
+//______________________________________________________________________________
+
+B1OverlapChecker::Result B1OverlapChecker::Check(const std::vector<G4LogicalVolume*>& mothers)
+{
+   check_clock::time_point t_begin = check_clock::now();
+
+   // the pair search counts against the time budget
+   G4bool               complete = BuildInstances(mothers);
+   const G4int          ninst    = fInstances.size();
+   std::atomic<G4int>   next(0);
+   std::atomic<G4int>   checked(0);
+   std::atomic<G4long>  points(0);
+   std::atomic<bool>    stop(!complete);
+
+#ifdef G4MULTITHREADED
+   const G4int nthreads = fNThreads;
+#else
+   // one Geant4 engine for all threads: GetPointOnSurface on one thread
+   const G4int nthreads = 1;
+#endif
+
+   // worst overlap per pair of volumes (other = -1 for the mother)
+   typedef std::map<std::pair<G4int,G4int>, Overlap> OverlapMap;
+   std::vector<OverlapMap> found(nthreads);
+
+   auto worker = [&](G4int ithread) {
+      std::mt19937_64 gen(fSeed + ithread);
+      OverlapMap&     worst = found[ithread];
+#ifdef G4MULTITHREADED
+      // the engine of this thread, for GetPointOnSurface
+      G4Random::setTheSeed(fSeed + ithread);
+#endif
+
+      auto record = [&](G4int i, G4int j, G4double depth, const G4ThreeVector& mp) {
+         std::pair<G4int,G4int> key = (j < 0) ? std::make_pair(i, j) : std::make_pair(std::min(i,j), std::max(i,j));
+         auto it = worst.find(key);
+         if( it != worst.end() && it->second.depth >= depth ) return;
+         const Instance& a = fInstances[i];
+         Overlap o;
+         o.volume      = a.name;
+         o.copyNo      = a.copyNo;
+         o.other       = (j < 0) ? fMothers[a.mother]->GetName() : fInstances[j].name;
+         o.otherCopyNo = (j < 0) ? -1 : fInstances[j].copyNo;
+         o.depth       = depth;
+         o.point       = mp;
+         worst[key]    = o;
+      };
+
+      while( !stop ) {
+         G4int i = next++;
+         if( i >= ninst ) break;
+         const Instance  & inst   = fInstances[i];
+         const G4VSolid  * mother = fMothers[inst.mother]->GetSolid();
+
+         G4int ipoint = 0;
+         for( ; ipoint < fNPoints && !stop; ipoint++) {
+            G4ThreeVector mp = inst.toMother.TransformPoint(PointOnSurface(inst.solid, gen));
+
+            if( mother->Inside(mp) == kOutside ) {
+               G4double depth = mother->DistanceToIn(mp);
+               if( depth > fTolerance ) record(i, -1, depth, mp);
+            }
+            for(G4int j : inst.neighbours) {
+               const Instance& other = fInstances[j];
+               if( mp.x() < other.bmin.x() || mp.x() > other.bmax.x() ) continue;
+               if( mp.y() < other.bmin.y() || mp.y() > other.bmax.y() ) continue;
+               if( mp.z() < other.bmin.z() || mp.z() > other.bmax.z() ) continue;
+               G4ThreeVector lp = other.fromMother.TransformPoint(mp);
+               if( other.solid->Inside(lp) != kInside ) continue;
+               G4double depth = other.solid->DistanceToOut(lp);
+               if( depth > fTolerance ) record(i, j, depth, mp);
+            }
+
+            G4long n = ++points;
+            if( fPointBudget > 0 && n >= fPointBudget ) stop = true;
+            if( (ipoint & 63) == 63 && fTimeBudget > 0.0 ) {
+               std::chrono::duration<G4double> dt = check_clock::now() - t_begin;
+               if( dt.count() > fTimeBudget ) stop = true;
+            }
+         }
+         if( ipoint == fNPoints ) checked++;
+      }
+   };
+
+   std::vector<std::thread> threads;
+   for(int ithread = 0; ithread < nthreads; ithread++) threads.push_back(std::thread(worker, ithread));
+   for(auto& t : threads) t.join();
+
+   // merge the per-thread maps, keeping the deepest point of each pair
+   OverlapMap merged;
+   for(const auto& m : found) {
+      for(const auto& o : m) {
+         auto it = merged.find(o.first);
+         if( it == merged.end() || it->second.depth < o.second.depth ) merged[o.first] = o.second;
+      }
+   }
+
+   Result r;
+   r.volumes   = ninst;
+   r.checked   = checked;
+   r.points    = points;
+   r.truncated = (r.checked < ninst);
+   for(const auto& o : merged) r.overlaps.push_back(o.second);
+   std::sort(r.overlaps.begin(), r.overlaps.end(),
+             [](const Overlap& a, const Overlap& b) { return a.depth > b.depth; });
+   r.time = std::chrono::duration<G4double>(check_clock::now() - t_begin).count();
+
+   ClearInstances();
+   return r;
+}
+//______________________________________________________________________________
+
+void B1OverlapChecker::Print(const Result& r, G4int nmax)
+{
+   G4cout << "------------------------------------------------------------------------\n";
+   G4cout << " Overlap check\n"
+      << "                 volumes : " << r.checked << " of " << r.volumes << " checked"
+      << (r.truncated ? " (budget exhausted)" : "") << "\n"
+      << "                  points : " << r.points << "\n"
+      << "                    time : " << r.time << " s\n"
+      << "                overlaps : " << r.overlaps.size() << "\n";
+
+   if( !r.overlaps.empty() ) {
+      G4cout << std::setw(22) << "volume" << std::setw(7) << "copy"
+         << std::setw(22) << "overlaps" << std::setw(7) << "copy"
+         << std::setw(14) << "depth (mm)" << "   point (mm)\n";
+   }
+   for(std::size_t i = 0; i < r.overlaps.size() && G4int(i) < nmax; i++) {
+      const Overlap& o = r.overlaps[i];
+      G4cout << std::setw(22) << o.volume << std::setw(7) << o.copyNo
+         << std::setw(22) << o.other;
+      if( o.otherCopyNo < 0 ) G4cout << std::setw(7) << "mother";
+      else                    G4cout << std::setw(7) << o.otherCopyNo;
+      G4cout << std::setw(14) << o.depth/mm << "   " << o.point/mm << "\n";
+   }
+   G4cout << G4endl;
+}
+//______________________________________________________________________________
+
@@ -1,4 +1,6 @@
 #include "B1ParallelWorldConstruction.hh"
+#include "B1PlaneParameterisation.hh"
+#include "B1ParallelWorldMessenger.hh"
 
 #include "G4Box.hh"
 #include "G4Tubs.hh"
@@ -11,8 +13,15 @@
 #include "G4Colour.hh"    
 #include "G4VisAttributes.hh"    
 #include <string>
+#include <algorithm>
 #include "FakeSD.hh"    
 
+namespace {
+   // one sensitive detector per thread, shared by all the planes
+   G4ThreadLocal FakeSD * planeSD = 0;
+}
+//______________________________________________________________________________
+
 B1ParallelWorldConstruction ::B1ParallelWorldConstruction(G4String& parallelWorldName) :
    G4VUserParallelWorld(parallelWorldName),
    fConstructed(false),
@@ -20,21 +29,52 @@ B1ParallelWorldConstruction ::B1ParallelWorldConstruction(G4String& parallelWorl
    fSpanDistance(5.0*cm),
    fDirection(0,0,1.0),
    fStartingPoint(0,0,0),
-   fDet_size(50.0*cm)
+   fDet_size(50.0*cm),
+   fNplanes(10),
+   fDet_solid(nullptr),
+   fDet_log(nullptr),
+   fDet_phys(nullptr),
+   fDet_param(nullptr),
+   fDet_vis(nullptr)
 {
-   for(int i = 0; i < fNplanes; i++) {
-      fDet_solid[i]  = nullptr;
-      fDet_log[i]    = nullptr;
-      fDet_phys[i]   = nullptr;
-      fDet_det[i]    = nullptr;
-      fDet_vis[i]    = nullptr;
-   }
+   fMessenger = new B1ParallelWorldMessenger(this);
    std::cout << "Parallel world ctor" <<std::endl;
 }
 //______________________________________________________________________________
 
 B1ParallelWorldConstruction::~B1ParallelWorldConstruction()
-{ }
+{
+   delete fMessenger;
+}
+//______________________________________________________________________________
+
+void B1ParallelWorldConstruction::SetNumberOfPlanes(G4int n)
+{
+   if( n < 1 ) return;
+   fNeedsRebuilt = true;
+   fNplanes      = n;
+}
+//______________________________________________________________________________
+
+std::vector<G4int> B1ParallelWorldConstruction::GetHistogramPlanes() const
+{
+   if( !fHistogramPlanes.empty() ) return fHistogramPlanes;
+
+   std::vector<G4int> planes;
+   G4int n = std::min(fNplanes, fMaxDefaultHistogramPlanes);
+   for(G4int i = 0; i < n; i++) {
+      planes.push_back( (n > 1) ? (i*(fNplanes-1))/(n-1) : 0 );
+   }
+   return planes;
+}
+//______________________________________________________________________________
+
+G4ThreeVector B1ParallelWorldConstruction::GetPlaneStep() const
+{
+   G4ThreeVector step = fDirection;
+   step.setMag( (fNplanes > 1) ? fSpanDistance/double(fNplanes-1) : 0.0 );
+   return step;
+}
 //______________________________________________________________________________
 
 void B1ParallelWorldConstruction::Construct()
@@ -45,26 +85,10 @@ void B1ParallelWorldConstruction::Construct()
    std::cout << "constriing Parallel world " <<std::endl;
 
    bool    checkOverlaps    = false;
-   int     natoms           = 0;
-   int     ncomponents      = 0;
-   double  A                = 0.0;
-   double  Z                = 0.0;
-   double  thickness        = 0.0;
-   double  surface_z        = 0.0;
-   double  red              = 0.0;
-   double  green            = 0.0;
-   double  blue             = 0.0;
-   double  alpha            = 0.0;
-   double  density          = 0.0;
-   double  pressure         = 0.0;
-   double  temperature      = 0.0;
-
-   G4VSolid          * scoring_solid  = nullptr;
-   G4LogicalVolume   * scoring_log    = nullptr;
-   G4VPhysicalVolume * scoring_phys   = nullptr;
-   FakeSD            * scoring_det    = nullptr;
-   G4VisAttributes   * scoring_vis    = nullptr;
-
+   double  red              = 177.0/256.0;
+   double  green            = 104.0/256.0;
+   double  blue             = 177.0/256.0;
+   double  alpha            = 0.4;
 
    // --------------------------------------------------------------
    // World
@@ -73,62 +97,35 @@ void B1ParallelWorldConstruction::Construct()
    G4LogicalVolume   * worldLogical = ghostWorld->GetLogicalVolume();
 
    // --------------------------------------------------------------
-   // 
+   // Scoring planes: one solid, one logical volume and one parameterised
+   // placement whatever the number of planes
 
    double        scoring_length = 0.1*um;
-   double        step_size   = fSpanDistance/double(fNplanes-1);
-   G4ThreeVector scoring_pos = fStartingPoint;
-   G4ThreeVector step        = fDirection;
-   step.setMag(step_size);
-
-   for(int i = 0; i < fNplanes; i++) {
-
-      red       = 177.0/256.0;
-      green     = 104.0/256.0;
-      blue      = 177.0/256.0;
-      alpha     = 0.4;
-
-      scoring_solid  = fDet_solid[i];
-      scoring_log    = fDet_log[i];
-      scoring_phys   = fDet_phys[i];
-      scoring_det    = fDet_det[i];
-      scoring_vis    = fDet_vis[i];
-
-      if(scoring_phys)  delete scoring_phys;
-      if(scoring_log)   delete scoring_log;
-      if(scoring_solid) delete scoring_solid;
-      //if(scoring_det)   delete scoring_det;
-
-      std::string detname_solid = "scoring_solid_" + std::to_string(i);
-      std::string detname_log   = "scoring_log_"   + std::to_string(i);
-      std::string detname_phys  = "scoring_phys_"  + std::to_string(i);
-
-      scoring_solid = new G4Tubs(detname_solid, 0.0, fDet_size/2.0, scoring_length/2.0, 0.0, 360.*deg );
-      scoring_log   = new G4LogicalVolume(scoring_solid, 0, detname_log);
-      scoring_phys  = new G4PVPlacement(0,scoring_pos, scoring_log, detname_phys, worldLogical,false,0,checkOverlaps);                                  
-
-      G4Colour            scoring_color {red, green, blue, alpha };   // Gray 
-      if(!scoring_vis) {
-         scoring_vis   = new G4VisAttributes(scoring_color);
-      } else {
-         scoring_vis->SetColour(scoring_color);
-      }
-      scoring_log->SetVisAttributes(scoring_vis);
-
-      //G4UserLimits * scoring_limits = new G4UserLimits(0.004*um);
-      //scoring_log->SetUserLimits(scoring_limits);
-
-      if(!scoring_det){
-         std::string sdname = "/p" + std::to_string(i);
-         scoring_det = new FakeSD(sdname);
-      }
-
-      //SetSensitiveDetector("scoring_log",scoring_det);
-      G4SDManager::GetSDMpointer()->AddNewDetector(scoring_det);
-      scoring_log->SetSensitiveDetector(scoring_det);
-
-      scoring_pos += step;
+   G4ThreeVector step        = GetPlaneStep();
+
+   if(fDet_phys)  delete fDet_phys;
+   if(fDet_param) delete fDet_param;
+   if(fDet_log)   delete fDet_log;
+   if(fDet_solid) delete fDet_solid;
+
+   fDet_solid = new G4Tubs("scoring_solid", 0.0, fDet_size/2.0, scoring_length/2.0, 0.0, 360.*deg );
+   fDet_log   = new G4LogicalVolume(fDet_solid, 0, "scoring_log");
+   fDet_param = new B1PlaneParameterisation(fNplanes, fStartingPoint, step);
+
+   // planes along z are voxelised along z only
+   EAxis axis = (fDirection.unit() == G4ThreeVector(0,0,1)) ? kZAxis : kUndefined;
+   fDet_phys  = new G4PVParameterised("scoring_phys", fDet_log, worldLogical, axis, fNplanes, fDet_param, checkOverlaps);
+
+   G4Colour            scoring_color {red, green, blue, alpha };   // Gray 
+   if(!fDet_vis) {
+      fDet_vis   = new G4VisAttributes(scoring_color);
+   } else {
+      fDet_vis->SetColour(scoring_color);
    }
+   fDet_log->SetVisAttributes(fDet_vis);
+
+   //G4UserLimits * scoring_limits = new G4UserLimits(0.004*um);
+   //scoring_log->SetUserLimits(scoring_limits);
 
    //
    // material defined in the mass world
@@ -166,3 +163,20 @@ void B1ParallelWorldConstruction::Construct()
 }
 //______________________________________________________________________________
 
+
+void B1ParallelWorldConstruction::ConstructSD()
+{
+   if( planeSD && planeSD->GetNumberOfPlanes() != fNplanes ) {
+      G4ExceptionDescription msg;
+      msg << "the scoring planes were rebuilt with " << fNplanes << " planes but the sensitive detector"
+         << " was booked for " << planeSD->GetNumberOfPlanes() << "; set the number of planes before"
+         << " /run/initialize";
+      G4Exception("B1ParallelWorldConstruction::ConstructSD()", "B1Planes0001", JustWarning, msg);
+   }
+   if( !planeSD ) {
+      planeSD = new FakeSD("/planes", fNplanes);
+      G4SDManager::GetSDMpointer()->AddNewDetector(planeSD);
+   }
+   SetSensitiveDetector(fDet_log, planeSD);
+}
+//______________________________________________________________________________
@@ -0,0 +1,72 @@
+#include "B1ParallelWorldMessenger.hh"
+#include "B1ParallelWorldConstruction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+#include <sstream>
+#include <vector>
+
+//______________________________________________________________________________
+
+B1ParallelWorldMessenger::B1ParallelWorldMessenger(B1ParallelWorldConstruction* parallelWorld) :
+   G4UImessenger(), fParallelWorld(parallelWorld)
+{
+  fPlanesDirectory = new G4UIdirectory("/B1/planes/");
+  fPlanesDirectory->SetGuidance("Parallel world scoring planes");
+
+  fNumberOfPlanesCmd = new G4UIcmdWithAnInteger("/B1/planes/setNumberOfPlanes",this);
+  fNumberOfPlanesCmd->SetGuidance("Set the number of scoring planes.");
+  fNumberOfPlanesCmd->SetGuidance("All planes are copies of one parameterised volume scored by a");
+  fNumberOfPlanesCmd->SetGuidance("single sensitive detector, so thousands of planes are cheap.");
+  fNumberOfPlanesCmd->SetParameterName("n",false);
+  fNumberOfPlanesCmd->SetRange("n>0");
+  fNumberOfPlanesCmd->AvailableForStates(G4State_PreInit);
+
+  fHistogramPlanesCmd = new G4UIcmdWithAString("/B1/planes/setHistogramPlanes",this);
+  fHistogramPlanesCmd->SetGuidance("List of the planes that get the full set of histograms (/p<i>/...).");
+  fHistogramPlanesCmd->SetGuidance("Default: all planes up to 10, otherwise 10 evenly spaced planes.");
+  fHistogramPlanesCmd->SetGuidance("All planes are counted in /planes/crossings and /planes/ekin_vs_plane.");
+  fHistogramPlanesCmd->SetParameterName("planes",false);
+  fHistogramPlanesCmd->AvailableForStates(G4State_PreInit);
+
+  fSpanDistanceCmd = new G4UIcmdWithADoubleAndUnit("/B1/planes/setSpanDistance",this);
+  fSpanDistanceCmd->SetGuidance("Set the distance between the first and the last plane.");
+  fSpanDistanceCmd->SetGuidance("In Idle state, follow with /run/reinitializeGeometry.");
+  fSpanDistanceCmd->SetParameterName("L",false);
+  fSpanDistanceCmd->SetRange("L>=0.");
+  fSpanDistanceCmd->SetUnitCategory("Length");
+  fSpanDistanceCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+}
+//______________________________________________________________________________
+
+B1ParallelWorldMessenger::~B1ParallelWorldMessenger()
+{
+  delete fNumberOfPlanesCmd;
+  delete fHistogramPlanesCmd;
+  delete fSpanDistanceCmd;
+  delete fPlanesDirectory;
+}
+//______________________________________________________________________________
+
+void B1ParallelWorldMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
+{
+   if( command == fNumberOfPlanesCmd ) {
+      fParallelWorld->SetNumberOfPlanes( G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+   }
+
+   if( command == fHistogramPlanesCmd ) {
+      std::istringstream is(newValue);
+      std::vector<G4int> planes;
+      G4int plane;
+      while( is >> plane ) planes.push_back(plane);
+      fParallelWorld->SetHistogramPlanes(planes);
+   }
+
+   if( command == fSpanDistanceCmd ) {
+      fParallelWorld->SetSpanDistance( G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+   }
+}
+//______________________________________________________________________________
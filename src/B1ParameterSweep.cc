@@ -0,0 +1,128 @@
+#include "B1ParameterSweep.hh"
+
+#include "G4UImanager.hh"
+#include "G4Timer.hh"
+#include "G4UIcommandStatus.hh"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+B1ParameterSweep::B1ParameterSweep(G4int firstRunNumber) :
+   fFirstRunNumber(firstRunNumber)
+{ }
+//______________________________________________________________________________
+
+B1ParameterSweep::~B1ParameterSweep()
+{ }
+//______________________________________________________________________________
+
+G4bool B1ParameterSweep::Read(const G4String& fileName)
+{
+   fPoints.clear();
+
+   std::ifstream input(fileName.c_str());
+   if( !input ) {
+      G4ExceptionDescription msg;
+      msg << "Cannot open scan file " << fileName;
+      G4Exception("B1ParameterSweep::Read()", "B1Sweep0001", JustWarning, msg);
+      return false;
+   }
+
+   Point       point;
+   std::string line;
+   G4int       line_number = 0;
+   point.events = 0;
+
+   while( std::getline(input, line) ) {
+      line_number++;
+      std::size_t first = line.find_first_not_of(" \t\r");
+      if( first == std::string::npos || line[first] == '#' ) continue;
+      line = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+
+      if( line.compare(0, 6, "beamOn") == 0 ) {
+         std::istringstream is(line.substr(6));
+         if( !(is >> point.events) || point.events < 0 ) {
+            G4ExceptionDescription msg;
+            msg << fileName << ":" << line_number << " : bad event count '" << line << "'";
+            G4Exception("B1ParameterSweep::Read()", "B1Sweep0002", JustWarning, msg);
+            return false;
+         }
+         fPoints.push_back(point);
+         point.commands.clear();
+         point.events = 0;
+      } else {
+         point.commands.push_back(line);
+      }
+   }
+
+   if( !point.commands.empty() ) {
+      G4ExceptionDescription msg;
+      msg << fileName << " : commands after the last beamOn are ignored";
+      G4Exception("B1ParameterSweep::Read()", "B1Sweep0003", JustWarning, msg);
+   }
+   return true;
+}
+//______________________________________________________________________________
+
+G4bool B1ParameterSweep::Execute(const G4String& fileName)
+{
+   if( !Read(fileName) ) return false;
+
+   G4UImanager * UImanager = G4UImanager::GetUIpointer();
+
+   std::vector<G4double> times(fPoints.size(), 0.0);
+   std::vector<G4bool>   ok(fPoints.size(), true);
+
+   for(std::size_t ipoint = 0; ipoint < fPoints.size(); ipoint++) {
+      const Point& point = fPoints[ipoint];
+      G4int        rn    = fFirstRunNumber + ipoint;
+
+      G4cout << "=== sweep point " << ipoint << " (run number " << rn << ", "
+         << point.events << " events)" << G4endl;
+
+      G4Timer timer;
+      timer.Start();
+
+      for(const auto& cmd : point.commands) {
+         if( UImanager->ApplyCommand(cmd) != fCommandSucceeded ) {
+            G4ExceptionDescription msg;
+            msg << "sweep point " << ipoint << " : command failed : " << cmd;
+            G4Exception("B1ParameterSweep::Execute()", "B1Sweep0004", JustWarning, msg);
+            ok[ipoint] = false;
+         }
+      }
+      if( !ok[ipoint] ) continue;
+
+      std::ostringstream rn_cmd;
+      rn_cmd << "/B1/run/setRunNumber " << rn;
+      UImanager->ApplyCommand(rn_cmd.str());
+
+      std::ostringstream beam_cmd;
+      beam_cmd << "/run/beamOn " << point.events;
+      UImanager->ApplyCommand(beam_cmd.str());
+
+      timer.Stop();
+      times[ipoint] = timer.GetRealElapsed();
+   }
+
+   // restore the run number that was set before the sweep
+   std::ostringstream rn_cmd;
+   rn_cmd << "/B1/run/setRunNumber " << fFirstRunNumber;
+   UImanager->ApplyCommand(rn_cmd.str());
+
+   G4cout << "------------------------------------------------------------------------\n";
+   G4cout << " Sweep summary : " << fileName << "\n";
+   G4cout << std::setw(8) << "point" << std::setw(8) << "run"
+      << std::setw(12) << "events" << std::setw(14) << "time (s)" << "\n";
+   for(std::size_t ipoint = 0; ipoint < fPoints.size(); ipoint++) {
+      G4cout << std::setw(8) << ipoint << std::setw(8) << fFirstRunNumber + ipoint
+         << std::setw(12) << fPoints[ipoint].events;
+      if( ok[ipoint] ) G4cout << std::setw(14) << times[ipoint] << "\n";
+      else             G4cout << std::setw(14) << "failed" << "\n";
+   }
+   G4cout << G4endl;
+   return true;
+}
+//______________________________________________________________________________
+
@@ -0,0 +1,135 @@
+#include "B1PlaneCrossingScorer.hh"
+#include "B1PlaneHistograms.hh"
+#include "B1ParallelWorldConstruction.hh"
+#include "B1HitStream.hh"
+#include "B1Run.hh"
+#include "FakeSD.hh"
+
+#include "G4SDManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ParticleDefinition.hh"
+#include <cmath>
+#include <utility>
+
+G4bool                                B1PlaneCrossingScorer::fgEnabled    = false;
+G4bool                                B1PlaneCrossingScorer::fgValidation = false;
+G4ThreadLocal B1PlaneCrossingScorer * B1PlaneCrossingScorer::fgInstance   = 0;
+
+//______________________________________________________________________________
+
+B1PlaneCrossingScorer * B1PlaneCrossingScorer::Instance()
+{
+   if( !fgInstance ) fgInstance = new B1PlaneCrossingScorer();
+   return fgInstance;
+}
+//______________________________________________________________________________
+
+B1PlaneCrossingScorer::B1PlaneCrossingScorer() :
+   fActive(false), fX0(0.0), fY0(0.0), fR2(0.0), fHistograms(0)
+{ }
+//______________________________________________________________________________
+
+void B1PlaneCrossingScorer::Book(const B1ParallelWorldConstruction * planes)
+{
+   if( fHistograms || !planes ) return;
+   // same names as the parallel world planes unless both are scored
+   // and the statistics come from the parallel world planes then
+   G4int n = planes->GetNumberOfPlanes();
+   fHistograms = fgValidation ? new B1PlaneHistograms("/zplanes", "/zp", n, planes->GetHistogramPlanes(), false)
+                              : new B1PlaneHistograms("/planes",  "/p",  n, planes->GetHistogramPlanes(), true);
+}
+//______________________________________________________________________________
+
+void B1PlaneCrossingScorer::BeginOfRun(const B1ParallelWorldConstruction * planes)
+{
+   fActive = false;
+   if( !planes || !fHistograms ) {
+      G4Exception("B1PlaneCrossingScorer::BeginOfRun()", "B1Planes0002", JustWarning,
+                  "no scoring plane layout was given to the detector construction; analytic scoring is off");
+      return;
+   }
+   if( planes->GetDirection().unit() != G4ThreeVector(0,0,1) ) {
+      G4Exception("B1PlaneCrossingScorer::BeginOfRun()", "B1Planes0002", JustWarning,
+                  "the scoring planes are not normal to z; analytic scoring is off");
+      return;
+   }
+
+   fHistograms->ResetCrossings();
+
+   // the span can change between runs, the number of planes cannot
+   G4ThreeVector start = planes->GetStartingPoint();
+   G4ThreeVector step  = planes->GetPlaneStep();
+   std::vector< std::pair<G4double,G4int> > z;
+   for(G4int i = 0; i < fHistograms->GetNumberOfPlanes(); i++) z.push_back(std::make_pair(start.z() + i*step.z(), i));
+   std::sort(z.begin(), z.end());
+
+   fZ.clear();
+   fPlane.clear();
+   for(const auto& p : z) {
+      fZ.push_back(p.first);
+      fPlane.push_back(p.second);
+   }
+   fX0     = start.x();
+   fY0     = start.y();
+   fR2     = planes->GetPlaneRadius()*planes->GetPlaneRadius();
+   fActive = !fZ.empty();
+}
+//______________________________________________________________________________
+
+void B1PlaneCrossingScorer::EndOfRun(B1Run * run)
+{
+   if( !fHistograms ) return;
+   if( fgValidation ) {
+      FakeSD * sd = dynamic_cast<FakeSD*>(G4SDManager::GetSDMpointer()->FindSensitiveDetector("/planes", false));
+      if( sd ) {
+         run->AddPlaneCrossings(sd->GetHistograms()->GetCrossings(), fHistograms->GetCrossings());
+         sd->GetHistograms()->ResetCrossings();
+      }
+   }
+   fHistograms->ResetCrossings();
+}
+//______________________________________________________________________________
+
+void B1PlaneCrossingScorer::EndOfEvent()
+{
+   if( fHistograms ) fHistograms->EndOfEvent();
+}
+//______________________________________________________________________________
+
+void B1PlaneCrossingScorer::Cross(std::size_t i, const G4Step * step)
+{
+   const G4StepPoint * pre  = step->GetPreStepPoint();
+   const G4StepPoint * post = step->GetPostStepPoint();
+
+   // crossing point on the step chord
+   G4ThreeVector p1  = pre->GetPosition();
+   G4ThreeVector d   = post->GetPosition() - p1;
+   G4double      t   = (fZ[i] - p1.z())/d.z();
+   G4ThreeVector pos = p1 + t*d;
+
+   G4double dx = pos.x() - fX0;
+   G4double dy = pos.y() - fY0;
+   if( dx*dx + dy*dy > fR2 ) return;
+
+   // the continuous loss is spread along the step; a discrete interaction
+   // happens at its end, beyond the plane
+   G4double e1     = pre->GetKineticEnergy();
+   G4double loss   = (post->GetStepStatus() == fPostStepDoItProc) ? 0.0 : e1 - post->GetKineticEnergy();
+   G4double energy = (e1 - t*loss)/MeV;
+
+   G4ThreeVector dir   = d.unit();
+   G4int         pdg   = step->GetTrack()->GetDefinition()->GetPDGEncoding();
+   G4int         plane = fPlane[i];
+
+   // in validation mode the parallel world planes write the hits
+   if( B1HitStream::IsEnabled() && !fgValidation ) {
+      G4double mass = pre->GetMass()/MeV;
+      G4double p    = std::sqrt(energy*(energy + 2.0*mass));
+      B1HitStream::Instance()->Add(plane, pdg, pos.x()/cm, pos.y()/cm,
+                                   p*dir.x(), p*dir.y(), p*dir.z(), energy, 0.0);
+   }
+
+   fHistograms->Fill(plane, pdg, pos.x()/cm, pos.y()/cm, dir.z(), energy);
+}
+//______________________________________________________________________________
+
@@ -0,0 +1,171 @@
+#include "B1PlaneHistograms.hh"
+#include "B1HistogramStore.hh"
+#include "B1ConvergenceMonitor.hh"
+
+#include <string>
+#include <algorithm>
+
+B1PlaneHistograms::B1PlaneHistograms(const G4String& dir, const G4String& prefix,
+                                     G4int nplanes, const std::vector<G4int>& histogramPlanes,
+                                     G4bool statistics) :
+   fStore(B1HistogramStore::Instance()),
+   fMonitor(0),
+   fNplanes(nplanes),
+   fSetOfPlane(nplanes, -1),
+   fCrossings(nplanes, 0),
+   fEventSums(nplanes)
+{
+   EventSums zero = {};
+   std::fill(fEventSums.begin(), fEventSums.end(), zero);
+
+   double hist_Emax = 8;
+
+   // Every plane: crossings and energy vs plane number
+   fhCrossings    = fStore->CreateH1(dir+"/crossings","Boundary crossings per plane", nplanes,-0.5,nplanes-0.5);
+   fhEkinVsPlane  = fStore->CreateH2(dir+"/ekin_vs_plane","E vs plane", nplanes,-0.5,nplanes-0.5,100,0,hist_Emax);
+   fhEvents       = fStore->CreateH1(dir+"/events","Events crossing each plane", nplanes,-0.5,nplanes-0.5);
+
+   // Full set of histograms, only for the selected planes so that the
+   // memory does not grow with the number of planes
+   for(G4int plane : histogramPlanes) {
+      if( plane < 0 || plane >= nplanes || fSetOfPlane[plane] >= 0 ) continue;
+      fSetOfPlane[plane] = fPlaneSets.size();
+      fPlaneSets.push_back(BookPlane(plane, prefix + std::to_string(plane), hist_Emax));
+   }
+
+   if( statistics ) {
+      std::vector<G4int> planes;
+      for(const PlaneSet& h : fPlaneSets) planes.push_back(h.fPlane);
+      fMonitor = B1ConvergenceMonitor::Instance();
+      fMonitor->Configure(nplanes, planes);
+   }
+}
+//______________________________________________________________________________
+
+B1PlaneHistograms::PlaneSet B1PlaneHistograms::BookPlane(G4int plane, const G4String& name, G4double hist_Emax)
+{
+   PlaneSet h;
+   h.fPlane = plane;
+   // Creating histograms (booked in the analysis manager as well, but filled
+   // through the flat per-thread store)
+   h.fhBackward_0            = fStore->CreateH1(name+"/back0","Backward scattered energies", 100,0,hist_Emax);
+   h.fhForward_0             = fStore->CreateH1(name+"/forw0","Forward scattered energies",  100,0,hist_Emax);
+
+   h.fhXvsE_all    = fStore->CreateH2(name+"/fhXvsE_all","E vs X all",     100,-10,10,100,0,hist_Emax);
+   h.fhXvsE_gamma  = fStore->CreateH2(name+"/fhXvsE_gamma","E vs X gamma", 100,-10,10,100,0,hist_Emax);
+   h.fhXvsE_not_gamma  = fStore->CreateH2(name+"/fhXvsE_not_gamma","E vs X not gamma", 100,-10,10,100,0,hist_Emax);
+   h.fhXvsE_n      = fStore->CreateH2(name+"/fhXvsE_n","E vs X n",         100,-10,10,100,0,hist_Emax);
+
+   h.fhXY0_all    = fStore->CreateH2(name+"/fhXY0_all","E vs X all",     100,-10,10,100,-10,10);
+   h.fhXY1_all    = fStore->CreateH2(name+"/fhXY1_all","E vs X all",     100,-5,5,100,-5,5);
+   h.fhXY2_all    = fStore->CreateH2(name+"/fhXY2_all","E vs X all",     100,-2,2,100,-2,2);
+
+   h.fhXY0_gamma    = fStore->CreateH2(name+"/fhXY0_gamma","E vs X gamma",     100,-10,10,100,-10,10);
+   h.fhXY1_gamma    = fStore->CreateH2(name+"/fhXY1_gamma","E vs X gamma",     100,-5,5,100,-5,5);
+   h.fhXY2_gamma    = fStore->CreateH2(name+"/fhXY2_gamma","E vs X gamma",     100,-2,2,100,-2,2);
+
+   // per-event observables, filled from the event sums
+   for(G4int s = 0; s < kNSpecies; s++) {
+      G4String species = GetSpeciesName(s);
+      h.fhN[s]    = fStore->CreateH1(name+"/n_"+species,    "Crossings per event, "+species,   100,-0.5,99.5);
+      h.fhEsum[s] = fStore->CreateH1(name+"/esum_"+species, "Energy per event, "+species,      100,0,hist_Emax);
+   }
+   return h;
+}
+//______________________________________________________________________________
+
+const char * B1PlaneHistograms::GetSpeciesName(G4int species)
+{
+   static const char * names[kNSpecies] = { "gamma", "electron", "positron", "neutron", "other" };
+   return (species >= 0 && species < kNSpecies) ? names[species] : "";
+}
+//______________________________________________________________________________
+
+void B1PlaneHistograms::ResetCrossings()
+{
+   std::fill(fCrossings.begin(), fCrossings.end(), 0);
+}
+//______________________________________________________________________________
+
+void B1PlaneHistograms::Fill(G4int plane, G4int pdgcode, G4double x, G4double y, G4double pz, G4double energy)
+{
+   fStore->FillH2( fhEkinVsPlane, plane, energy);
+
+   if( plane < 0 || plane >= fNplanes ) return;
+   fCrossings[plane]++;
+
+   // the crossings histograms are filled from the sums at the end of the event
+   EventSums& e = fEventSums[plane];
+   if( e.total++ == 0 ) fTouched.push_back(plane);
+   G4int s = GetSpecies(pdgcode);
+   e.n[s]++;
+   e.esum[s] += energy;
+   if( pz >= 0.0 ) e.forward++;
+   if( fMonitor ) fMonitor->AddCrossing(plane, s, energy);
+
+   G4int iset = fSetOfPlane[plane];
+   if( iset < 0 ) return;
+   const PlaneSet& h = fPlaneSets[iset];
+
+   fStore->FillH2( h.fhXvsE_all, x, energy);
+   fStore->FillH2( h.fhXY0_all, x, y);
+   fStore->FillH2( h.fhXY1_all, x, y);
+   fStore->FillH2( h.fhXY2_all, x, y);
+
+   if( pdgcode == 22 ) {
+      //photon
+      fStore->FillH2( h.fhXvsE_gamma, x, energy);
+      fStore->FillH2( h.fhXY0_gamma, x, y);
+      fStore->FillH2( h.fhXY1_gamma, x, y);
+      fStore->FillH2( h.fhXY2_gamma, x, y);
+   } else {
+      fStore->FillH2( h.fhXvsE_not_gamma, x, energy);
+   }
+
+   if( pdgcode == 2112 ) {
+      //neutron
+      fStore->FillH2( h.fhXvsE_n, x, energy);
+   }
+
+   if( pz < 0.0 ) {
+      fStore->FillH1( h.fhBackward_0, energy);
+   } else {
+      fStore->FillH1( h.fhForward_0, energy);
+   }
+}
+//______________________________________________________________________________
+
+void B1PlaneHistograms::EndOfEvent()
+{
+   for(G4int plane : fTouched) {
+      fStore->AddH1( fhCrossings, plane, fEventSums[plane].total);
+      fStore->FillH1( fhEvents, plane);
+      if( fMonitor ) fMonitor->AddEventCounts(plane, fEventSums[plane].n);
+   }
+
+   if( fMonitor ) {
+      G4int num = B1ConvergenceMonitor::GetNumeratorPlane();
+      G4int den = B1ConvergenceMonitor::GetDenominatorPlane();
+      fMonitor->EndOfEvent( (num >= 0 && num < fNplanes) ? fEventSums[num].forward : 0,
+                            (den >= 0 && den < fNplanes) ? fEventSums[den].forward : 0 );
+   }
+
+   // every event counts in the multiplicities, crossed or not
+   for(const PlaneSet& h : fPlaneSets) {
+      const EventSums& e = fEventSums[h.fPlane];
+      for(G4int s = 0; s < kNSpecies; s++) {
+         fStore->FillH1( h.fhN[s], e.n[s]);
+         if( e.n[s] > 0 ) fStore->FillH1( h.fhEsum[s], e.esum[s]);
+      }
+   }
+   ClearEvent();
+}
+//______________________________________________________________________________
+
+void B1PlaneHistograms::ClearEvent()
+{
+   EventSums zero = {};
+   for(G4int plane : fTouched) fEventSums[plane] = zero;
+   fTouched.clear();
+}
+//______________________________________________________________________________
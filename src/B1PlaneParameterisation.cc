@@ -0,0 +1,22 @@
+#include "B1PlaneParameterisation.hh"
+
+#include "G4VPhysicalVolume.hh"
+
+B1PlaneParameterisation::B1PlaneParameterisation(G4int nplanes, const G4ThreeVector& start,
+                                                 const G4ThreeVector& step) :
+   G4VPVParameterisation(),
+   fNPlanes(nplanes), fStart(start), fStep(step)
+{ }
+//______________________________________________________________________________
+
+B1PlaneParameterisation::~B1PlaneParameterisation()
+{ }
+//______________________________________________________________________________
+
+void B1PlaneParameterisation::ComputeTransformation(const G4int copyNo, G4VPhysicalVolume* physVol) const
+{
+   physVol->SetTranslation( GetPlanePosition(copyNo) );
+   physVol->SetRotation( 0 );
+}
+//______________________________________________________________________________
+
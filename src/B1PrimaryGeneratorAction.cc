@@ -9,6 +9,7 @@
 #include "G4ParticleDefinition.hh"
 #include "G4SystemOfUnits.hh"
 #include "Randomize.hh"
+#include "B1EventSeeds.hh"
 
 
 
@@ -42,6 +43,9 @@ void B1PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
    //this function is called at the begining of ecah event
    //
 
+   // the random numbers of the event only depend on its seed
+   B1EventSeeds::Reseed(anEvent->GetEventID());
+
    // In order to avoid dependence of PrimaryGeneratorAction
    // on DetectorConstruction class we get Envelope volume
    // from G4LogicalVolumeStore.
@@ -53,7 +57,6 @@ void B1PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 
    G4double M  = fParticleMass;
    G4double KE = sqrt(P_rand*P_rand + M*M) - M;
-   std::cout << " KE = " << KE << std::endl;
 
    fParticleGun->SetParticleEnergy( KE*MeV ); // kinetic energy (not total)
 
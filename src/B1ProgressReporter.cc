@@ -0,0 +1,133 @@
+#include "B1ProgressReporter.hh"
+
+#include "G4Run.hh"
+#include "G4Threading.hh"
+#include "G4SystemOfUnits.hh"
+
+#ifdef G4MULTITHREADED
+#include "G4MTRunManager.hh"
+#endif
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+
+G4double                                   B1ProgressReporter::fgInterval      = 10.0*s;
+G4long                                     B1ProgressReporter::fgToBeProcessed = 0;
+G4int                                      B1ProgressReporter::fgNcounters     = 0;
+std::unique_ptr<B1ProgressReporter::Counter[]> B1ProgressReporter::fgCounters;
+std::thread                                B1ProgressReporter::fgThread;
+std::mutex                                 B1ProgressReporter::fgMutex;
+std::condition_variable                    B1ProgressReporter::fgWake;
+G4bool                                     B1ProgressReporter::fgStop          = false;
+G4ThreadLocal B1ProgressReporter::Counter * B1ProgressReporter::fgCounter      = 0;
+
+//______________________________________________________________________________
+
+void B1ProgressReporter::BeginOfRun(const G4Run * run)
+{
+   G4int nthreads = 0;    // threads processing events other than this one
+#ifdef G4MULTITHREADED
+   if( G4MTRunManager::GetMasterRunManager() ) {
+      nthreads = G4MTRunManager::GetMasterRunManager()->GetNumberOfThreads();
+   }
+#endif
+
+   if( G4Threading::IsMasterThread() ) {
+      EndOfRun();
+
+      // the master runs before the workers start their event loop
+      G4int n = (nthreads > 0) ? nthreads : 1;
+      if( n > fgNcounters ) {
+         fgCounters.reset(new Counter[n]);
+         fgNcounters = n;
+      }
+      for(G4int i = 0; i < fgNcounters; i++) fgCounters[i].n.store(0, std::memory_order_relaxed);
+      fgToBeProcessed = run->GetNumberOfEventToBeProcessed();
+
+      // sequential: the master counts its own events
+      fgCounter = (nthreads > 0) ? 0 : &fgCounters[0];
+
+      if( fgInterval > 0.0 ) {
+         fgStop   = false;
+         fgThread = std::thread(&B1ProgressReporter::Report);
+      }
+   } else {
+      G4int id  = G4Threading::G4GetThreadId();
+      fgCounter = (id >= 0 && id < fgNcounters) ? &fgCounters[id] : 0;
+   }
+}
+//______________________________________________________________________________
+
+void B1ProgressReporter::EndOfRun()
+{
+   if( !fgThread.joinable() ) return;
+   {
+      std::lock_guard<std::mutex> lock(fgMutex);
+      fgStop = true;
+   }
+   fgWake.notify_all();
+   fgThread.join();
+}
+//______________________________________________________________________________
+
+void B1ProgressReporter::Report()
+{
+   typedef std::chrono::steady_clock clock;
+
+   clock::time_point start = clock::now();
+   clock::time_point prev  = start;
+   G4long            last  = 0;
+   std::chrono::duration<double> interval(fgInterval/s);
+
+   std::unique_lock<std::mutex> lock(fgMutex);
+   while( !fgWake.wait_for(lock, interval, []{ return fgStop; }) ) {
+      clock::time_point now = clock::now();
+      std::chrono::duration<double> elapsed = now - start;
+      std::chrono::duration<double> dt      = now - prev;
+      last = Print(elapsed.count(), dt.count(), last);
+      prev = now;
+   }
+}
+//______________________________________________________________________________
+
+G4long B1ProgressReporter::Print(G4double elapsed, G4double interval, G4long last)
+{
+   G4long total   = 0;
+   G4long nmin    = -1;
+   G4long nmax    = 0;
+   G4int  slowest = 0;
+   for(G4int i = 0; i < fgNcounters; i++) {
+      G4long n = fgCounters[i].n.load(std::memory_order_relaxed);
+      total += n;
+      if( nmin < 0 || n < nmin ) { nmin = n; slowest = i; }
+      if( n > nmax ) nmax = n;
+   }
+   G4double rate    = (interval > 0.0) ? (total - last)/interval : 0.0;
+   G4double average = (elapsed > 0.0) ? total/elapsed : 0.0;
+   G4double mean    = G4double(total)/fgNcounters;
+
+   // one write, this is not a G4 thread and G4cout is per thread
+   std::ostringstream os;
+   os << " progress : " << total;
+   if( fgToBeProcessed > 0 ) {
+      os << " / " << fgToBeProcessed << " events ("
+         << std::fixed << std::setprecision(1) << 100.0*total/fgToBeProcessed << " %)";
+   } else {
+      os << " events";
+   }
+   os << std::fixed << std::setprecision(0) << ", " << rate << " events/s";
+   if( fgToBeProcessed > total && average > 0.0 ) {
+      os << ", ETA " << (fgToBeProcessed - total)/average << " s";
+   }
+   if( fgNcounters > 1 && mean > 0.0 ) {
+      os << ", imbalance " << std::setprecision(1) << 100.0*(nmax - nmin)/mean
+         << " % (slowest thread " << slowest << ")";
+   }
+   os << "\n";
+   std::cout << os.str() << std::flush;
+   return total;
+}
+//______________________________________________________________________________
+
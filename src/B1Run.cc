@@ -1,11 +1,41 @@
 #include "B1Run.hh"
+#include "B1ProgressReporter.hh"
 
 #include "G4HCofThisEvent.hh"
 #include "G4Event.hh"
+#include "G4RegionStore.hh"
+#include "G4Region.hh"
+#include "G4Threading.hh"
+#include "G4AutoLock.hh"
+#include <map>
+#include <utility>
+
+#ifdef G4MULTITHREADED
+#include "G4MTRunManager.hh"
+#endif
+
+namespace {
+   G4Mutex reduceMutex = G4MUTEX_INITIALIZER;
+
+   // accumulators waiting in the reduction tree, by (level, node)
+   std::map< std::pair<G4int,G4int>, B1Accumulators* > reduceSlots;
+}
 
 B1Run::B1Run(G4int rn) : G4Run(),
-  fRunNumber(rn), fEdep(0.), fEdep2(0.)
+  fRunNumber(rn)
 {
+   // the same layout on every thread
+   fEdep              = fAccumulators.AddSum("edep");
+   fEventsWithEdep    = fAccumulators.AddCounter("events with edep");
+   fSecondaries       = fAccumulators.AddArray("secondaries");
+   fParallelCrossings = fAccumulators.AddArray("crossings/parallel");
+   fAnalyticCrossings = fAccumulators.AddArray("crossings/analytic");
+   fOpticalPhotons    = fAccumulators.AddCounter("optical photons stacked");
+   fOpticalDropped    = fAccumulators.AddCounter("optical photons dropped");
+   fEventsOverBudget  = fAccumulators.AddCounter("events over photon budget");
+
+   G4RegionStore * store = G4RegionStore::GetInstance();
+   for(std::size_t i = 0; i < store->size(); i++) fRegions.push_back((*store)[i]);
 } 
 //______________________________________________________________________________
 
@@ -15,10 +45,7 @@ B1Run::~B1Run()
  
 void B1Run::Merge(const G4Run* run)
 {
-  //const B1Run* localRun = static_cast<const B1Run*>(run);
-  //fEdep  += localRun->fEdep;
-  //fEdep2 += localRun->fEdep2;
-
+  // the accumulators are merged by the reduction tree (Reduce/Collect)
   G4Run::Merge(run); 
 } 
 //______________________________________________________________________________
@@ -27,17 +54,88 @@ void B1Run::RecordEvent(const G4Event * evt)
 {
    G4HCofThisEvent* HCE = evt->GetHCofThisEvent();
 
-   if( numberOfEvent%50000 == 0 ) std::cout << numberOfEvent << std::endl;
+   B1ProgressReporter::Count();
 
    G4Run::RecordEvent(evt); // increments run number
 }
 //______________________________________________________________________________
 
+G4double B1Run::GetSecondaries(G4int i) const
+{
+   const std::vector<G4double>& n = fAccumulators.GetArray(fSecondaries);
+   return (std::size_t(i) < n.size()) ? n[i] : 0.0;
+}
+//______________________________________________________________________________
+
+void B1Run::AddPlaneCrossings(const std::vector<G4long>& parallel, const std::vector<G4long>& analytic)
+{
+   for(std::size_t i = 0; i < parallel.size(); i++) fAccumulators.Add(fParallelCrossings, i, parallel[i]);
+   for(std::size_t i = 0; i < analytic.size(); i++) fAccumulators.Add(fAnalyticCrossings, i, analytic[i]);
+}
+//______________________________________________________________________________
+
 void B1Run::AddEdep (G4double edep)
 {
-  //fEdep  += edep;
-  //fEdep2 += edep*edep;
+   fAccumulators.Fill(fEdep, edep);
+   if( edep > 0.0 ) fAccumulators.Count(fEventsWithEdep);
+}
+//______________________________________________________________________________
+
+void B1Run::Reduce() const
+{
+   G4int nranks = 1;
+#ifdef G4MULTITHREADED
+   nranks = G4MTRunManager::GetMasterRunManager()->GetNumberOfThreads();
+#endif
+   G4int node = G4Threading::G4GetThreadId();
+   if( node < 0 ) return;
+
+   B1Accumulators * acc = new B1Accumulators(fAccumulators);
+   if( node >= nranks ) {
+      // not part of the tree (thread count changed): left for the master
+      G4AutoLock lock(&reduceMutex);
+      reduceSlots[std::make_pair(-1, node)] = acc;
+      return;
+   }
+
+   for(G4int level = 0; ; level++, node >>= 1) {
+      G4int nnodes = ((nranks - 1) >> level) + 1;
+      if( nnodes == 1 ) break;
+
+      G4int            sibling = node ^ 1;
+      B1Accumulators * other   = 0;
+      if( sibling < nnodes ) {
+         G4AutoLock lock(&reduceMutex);
+         auto it = reduceSlots.find(std::make_pair(level, sibling));
+         if( it == reduceSlots.end() ) {
+            // first of the two: the sibling merges this one
+            reduceSlots[std::make_pair(level, node)] = acc;
+            return;
+         }
+         other = it->second;
+         reduceSlots.erase(it);
+      }
+      if( other ) {
+         acc->Merge(*other);
+         delete other;
+      }
+   }
+
+   // root
+   G4AutoLock lock(&reduceMutex);
+   reduceSlots[std::make_pair(0x7fff, 0)] = acc;
 }
 //______________________________________________________________________________
 
+void B1Run::Collect()
+{
+   // the root and whatever did not reach it (threads without events)
+   G4AutoLock lock(&reduceMutex);
+   for(auto& slot : reduceSlots) {
+      fAccumulators.Merge(*slot.second);
+      delete slot.second;
+   }
+   reduceSlots.clear();
+}
+//______________________________________________________________________________
 
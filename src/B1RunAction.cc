@@ -3,6 +3,21 @@
 #include "B1DetectorConstruction.hh"
 #include "B1Run.hh"
 #include "B1Analysis.hh"
+#include "B1RunMessenger.hh"
+#include "B1StackingMessenger.hh"
+#include "B1HistogramStore.hh"
+#include "B1PlaneHistograms.hh"
+#include "B1ParallelWorldConstruction.hh"
+#include "FakeSD.hh"
+#include "B1HitStream.hh"
+#include "B1PlaneCrossingScorer.hh"
+#include "B1MeshScorer.hh"
+#include "B1ConvergenceMonitor.hh"
+#include "B1ProgressReporter.hh"
+#include "B1EventProfiler.hh"
+#include "B1StepProfiler.hh"
+#include "B1EventSeeds.hh"
+#include "B1SteppingAction.hh"
 
 #include "G4RunManager.hh"
 #include "G4LogicalVolumeStore.hh"
@@ -10,14 +25,21 @@
 #include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4SDManager.hh"
+#include "G4Region.hh"
+#include <iomanip>
 #include <string>
 #include <sstream>
+#include <cmath>
 
 using ss = std::stringstream;
 
 B1RunAction::B1RunAction(G4int rn) : G4UserRunAction(),
-   fRunNumber(rn)
+   fRunNumber(rn), fSteppingAction(0), fPlaneHistograms(0)
 { 
+   fMessenger = new B1RunMessenger(this);
+   // here so that the /B1/stack/ commands exist on the master, which has
+   // no stacking action
+   fStackingMessenger = new B1StackingMessenger();
 
    // Create analysis manager
    G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
@@ -29,7 +51,11 @@ B1RunAction::B1RunAction(G4int rn) : G4UserRunAction(),
 //______________________________________________________________________________
 
 B1RunAction::~B1RunAction()
-{ }
+{
+   delete fMessenger;
+   delete fStackingMessenger;
+   delete fPlaneHistograms;
+}
 //______________________________________________________________________________
 
 G4Run* B1RunAction::GenerateRun()
@@ -48,28 +74,102 @@ G4Run* B1RunAction::GenerateRun()
 }
 //______________________________________________________________________________
 
-void B1RunAction::BeginOfRunAction(const G4Run*)
+void B1RunAction::BeginOfRunAction(const G4Run* run)
 { 
-   //inform the runManager to save random number seed
+   // no engine status files: the events are reproduced from their seeds
+   // (B1EventSeeds, ebl1 --replay)
    G4RunManager::GetRunManager()->SetRandomNumberStore(false);
 
+   fTimer.Start();
+   B1ProgressReporter::BeginOfRun(run);
+   B1EventSeeds::BeginOfRun(fRunNumber, run->GetRunID());
+
    // Get analysis manager
    G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
 
+   BookHistograms();
+
+   if( B1PlaneCrossingScorer::IsEnabled() ) {
+      const B1DetectorConstruction* detector
+         = static_cast<const B1DetectorConstruction*>
+         (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+      B1PlaneCrossingScorer::Instance()->BeginOfRun(detector->GetScoringPlanes());
+   }
+   B1ConvergenceMonitor::Instance()->BeginOfRun();
+   if( B1EventProfiler::IsEnabled() ) B1EventProfiler::Instance()->BeginOfRun();
+   if( B1StepProfiler::IsEnabled() ) B1StepProfiler::Instance()->BeginOfRun();
+
    // Open an output file
    ss file_name;
-   file_name << "EBL_sim_output_" << fRunNumber;
+   file_name << (B1EventSeeds::IsReplay() ? "EBL_replay_" : "EBL_sim_output_") << fRunNumber;
    analysisManager->OpenFile(file_name.str().c_str());
+
+   if( B1HitStream::IsEnabled() ) B1HitStream::Instance()->BeginOfRun(fRunNumber);
+   if( B1MeshScorer::IsEnabled() ) B1MeshScorer::Instance()->BeginOfRun();
+
+   // after the scorers: they select their volumes from their settings
+   if( fSteppingAction ) fSteppingAction->BeginOfRun();
+}
+//______________________________________________________________________________
+
+void B1RunAction::BookHistograms()
+{
+   const B1DetectorConstruction* detector
+      = static_cast<const B1DetectorConstruction*>
+      (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+   const B1ParallelWorldConstruction * planes = detector->GetScoringPlanes();
+
+   // Parallel world planes. The workers hand them to their sensitive
+   // detector; the master has none and only merges them.
+   if( !fPlaneHistograms && planes && detector->GetNumberOfParallelWorld() > 0 ) {
+      FakeSD * sd = dynamic_cast<FakeSD*>(G4SDManager::GetSDMpointer()->FindSensitiveDetector("/planes", false));
+      G4int    n  = sd ? sd->GetNumberOfPlanes() : planes->GetNumberOfPlanes();
+      fPlaneHistograms = new B1PlaneHistograms("/planes", "/p", n, planes->GetHistogramPlanes(), sd != 0);
+      if( sd ) sd->SetHistograms(fPlaneHistograms);
+   }
+
+   // Analytic planes: /zplanes after /planes with --scoring=both
+   if( B1PlaneCrossingScorer::IsEnabled() ) B1PlaneCrossingScorer::Instance()->Book(planes);
+
+   // Event timing, last
+   if( B1EventProfiler::IsEnabled() ) B1EventProfiler::Instance()->Book();
 }
 //______________________________________________________________________________
 
 void B1RunAction::EndOfRunAction(const G4Run* run)
 {
-   G4int nofEvents = run->GetNumberOfEvent();
-   if (nofEvents == 0) return;
+   if (IsMaster()) B1ProgressReporter::EndOfRun();
 
+   G4int nofEvents = run->GetNumberOfEvent();
    const B1Run* b1Run = static_cast<const B1Run*>(run);
 
+   // a worker without events still completes its branch of the reduction,
+   // the master clears the tree
+   if (nofEvents == 0) {
+      if (IsMaster()) const_cast<B1Run*>(b1Run)->Collect();
+      else            b1Run->Reduce();
+      return;
+   }
+
+   // The plane crossings of the worker go into its run before anything
+   // else, so that they are in the accumulators when they are reduced
+   if( B1PlaneCrossingScorer::IsEnabled() ) {
+      B1PlaneCrossingScorer::Instance()->EndOfRun(const_cast<B1Run*>(b1Run));
+   }
+
+   // Move this thread's histogram bins into its analysis manager before
+   // the histograms are written and merged
+   B1HistogramStore::Instance()->Merge();
+
+   if( B1HitStream::IsEnabled() ) B1HitStream::Instance()->EndOfRun();
+   if( B1MeshScorer::IsEnabled() ) B1MeshScorer::Instance()->EndOfRun();
+   B1ConvergenceMonitor::Instance()->EndOfRun();
+   if( B1EventProfiler::IsEnabled() ) B1EventProfiler::Instance()->EndOfRun();
+   if( B1StepProfiler::IsEnabled() ) B1StepProfiler::Instance()->EndOfRun();
+
+   // the worker accumulators are complete: into the reduction tree
+   if (!IsMaster()) b1Run->Reduce();
+
    // Run conditions
    //  note: There is no primary generator action object for "master"
    //        run manager for multi-threaded mode.
@@ -89,6 +189,9 @@ void B1RunAction::EndOfRunAction(const G4Run* run)
    // Print
    //  
    if (IsMaster()) {
+      // the workers are done with their runs: take the reduced accumulators
+      const_cast<B1Run*>(b1Run)->Collect();
+
       G4cout
          << G4endl
          << "--------------------End of Global Run-----------------------";
@@ -98,6 +201,28 @@ void B1RunAction::EndOfRunAction(const G4Run* run)
       G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
       analysisManager->Write();
       analysisManager->CloseFile();
+
+      fTimer.Stop();
+      G4double time = fTimer.GetRealElapsed();
+      G4cout << G4endl
+         << " events : " << nofEvents << " in " << time << " s, "
+         << ((time > 0.0) ? nofEvents/time : 0.0) << " events/s" << G4endl;
+      G4cout << std::setw(28) << "region"
+         << std::setw(16) << "secondaries"
+         << std::setw(16) << "per event" << G4endl;
+      for(G4int i = 0; i < b1Run->GetNumberOfRegions(); i++) {
+         G4double n = b1Run->GetSecondaries(i);
+         if( n == 0.0 ) continue;
+         G4cout << std::setw(28) << b1Run->GetRegion(i)->GetName()
+            << std::setw(16) << G4long(n)
+            << std::setw(16) << n/nofEvents << G4endl;
+      }
+      b1Run->GetAccumulators().Print();
+      if( B1PlaneCrossingScorer::IsValidation() ) PrintPlaneValidation(b1Run);
+      if( B1MeshScorer::IsEnabled() ) B1MeshScorer::Write(fRunNumber, nofEvents);
+      B1ConvergenceMonitor::Print();
+      if( B1EventProfiler::IsEnabled() ) B1EventProfiler::Print(fRunNumber);
+      if( B1StepProfiler::IsEnabled() ) B1StepProfiler::Print(fRunNumber);
    }
    else {
       G4cout
@@ -120,3 +245,40 @@ void B1RunAction::EndOfRunAction(const G4Run* run)
 }
 //______________________________________________________________________________
 
+void B1RunAction::PrintPlaneValidation(const B1Run * run) const
+{
+   const std::vector<G4double>& parallel = run->GetParallelCrossings();
+   const std::vector<G4double>& analytic = run->GetAnalyticCrossings();
+   if( parallel.empty() || parallel.size() != analytic.size() ) return;
+
+   // per plane only for a few planes, the totals and the worst plane always
+   G4bool   rows   = (parallel.size() <= 20);
+   G4double npar   = 0.0;
+   G4double nana   = 0.0;
+   G4int    worst  = -1;
+   G4double dworst = 0.0;
+   G4cout << std::setw(8) << "plane"
+      << std::setw(16) << "parallel"
+      << std::setw(16) << "analytic"
+      << std::setw(16) << "difference (%)" << G4endl;
+   for(std::size_t i = 0; i < parallel.size(); i++) {
+      G4double d = (parallel[i] > 0) ? 100.0*(analytic[i] - parallel[i])/parallel[i] : 0.0;
+      if( std::fabs(d) > std::fabs(dworst) ) { dworst = d; worst = i; }
+      npar += parallel[i];
+      nana += analytic[i];
+      if( rows ) {
+         G4cout << std::setw(8) << i
+            << std::setw(16) << G4long(parallel[i])
+            << std::setw(16) << G4long(analytic[i])
+            << std::setw(16) << d << G4endl;
+      }
+   }
+   G4cout << std::setw(8) << "all"
+      << std::setw(16) << G4long(npar)
+      << std::setw(16) << G4long(nana)
+      << std::setw(16) << ((npar > 0) ? 100.0*(nana - npar)/npar : 0.0) << G4endl;
+   if( worst >= 0 ) {
+      G4cout << " largest difference : " << dworst << " % on plane " << worst << G4endl;
+   }
+}
+//______________________________________________________________________________
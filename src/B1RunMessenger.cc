@@ -0,0 +1,226 @@
+#include "B1RunMessenger.hh"
+#include "B1RunAction.hh"
+#include "B1ParameterSweep.hh"
+#include "B1HistogramStore.hh"
+#include "B1HitStream.hh"
+#include "B1MeshScorer.hh"
+#include "B1ConvergenceMonitor.hh"
+#include "B1ProgressReporter.hh"
+#include "B1EventProfiler.hh"
+#include "B1StepProfiler.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithADouble.hh"
+
+#include <sstream>
+
+//______________________________________________________________________________
+
+B1RunMessenger::B1RunMessenger(B1RunAction* runAction) :
+   G4UImessenger(), fRunAction(runAction)
+{
+  fRunDirectory = new G4UIdirectory("/B1/run/");
+  fRunDirectory->SetGuidance("Run control");
+
+  fRunNumberCmd = new G4UIcmdWithAnInteger("/B1/run/setRunNumber",this);
+  fRunNumberCmd->SetGuidance("Set the run number used to tag the output file.");
+  fRunNumberCmd->SetParameterName("rn",false);
+  fRunNumberCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fSweepCmd = new G4UIcmdWithAString("/B1/run/sweep",this);
+  fSweepCmd->SetGuidance("Run a parameter sweep described by a scan file.");
+  fSweepCmd->SetGuidance("Each point is a list of UI commands (e.g. /B1/det/...)");
+  fSweepCmd->SetGuidance("terminated by a line 'beamOn N'. Every point is run in this");
+  fSweepCmd->SetGuidance("process with its own run number, starting at the current one.");
+  fSweepCmd->SetParameterName("file",false);
+  fSweepCmd->AvailableForStates(G4State_Idle);
+  fSweepCmd->SetToBeBroadcasted(false);
+
+  fHistBenchCmd = new G4UIcmdWithAnInteger("/B1/run/benchmarkHistograms",this);
+  fHistBenchCmd->SetGuidance("Time histogram fills through a private flat histogram store");
+  fHistBenchCmd->SetGuidance("against the tools histograms of G4AnalysisManager and print fills/s.");
+  fHistBenchCmd->SetParameterName("nfills",true);
+  fHistBenchCmd->SetDefaultValue(10000000);
+  fHistBenchCmd->SetRange("nfills>0");
+  fHistBenchCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fHistBenchCmd->SetToBeBroadcasted(false);
+
+  fWriteHitsCmd = new G4UIcmdWithABool("/B1/run/writeHits",this);
+  fWriteHitsCmd->SetGuidance("Write every scoring plane crossing to EBL_hits_<run>[_t<thread>].bin");
+  fWriteHitsCmd->SetGuidance("(event, plane, pdg, x, y, px, py, pz, Ekin, edep) for offline re-binning.");
+  fWriteHitsCmd->SetParameterName("write",true);
+  fWriteHitsCmd->SetDefaultValue(true);
+  fWriteHitsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fHitBlockSizeCmd = new G4UIcmdWithAnInteger("/B1/run/hitBlockSize",this);
+  fHitBlockSizeCmd->SetGuidance("Number of hits buffered per thread before a block is written.");
+  fHitBlockSizeCmd->SetGuidance("Blocks only hold whole events, so they can be slightly larger.");
+  fHitBlockSizeCmd->SetParameterName("nhits",false);
+  fHitBlockSizeCmd->SetRange("nhits>0");
+  fHitBlockSizeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fScoreMeshCmd = new G4UIcmdWithABool("/B1/run/scoreMesh",this);
+  fScoreMeshCmd->SetGuidance("Score the energy deposit and track length in a sparse 3D mesh over the");
+  fScoreMeshCmd->SetGuidance("mesh regions, written to EBL_mesh_<run>.bin at the end of the run.");
+  fScoreMeshCmd->SetParameterName("score",true);
+  fScoreMeshCmd->SetDefaultValue(true);
+  fScoreMeshCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fMeshBinSizeCmd = new G4UIcmdWithADoubleAndUnit("/B1/run/meshBinSize",this);
+  fMeshBinSizeCmd->SetGuidance("Edge of the (cubic) mesh voxels. Default 1 mm.");
+  fMeshBinSizeCmd->SetParameterName("l",false);
+  fMeshBinSizeCmd->SetRange("l>0.");
+  fMeshBinSizeCmd->SetUnitCategory("Length");
+  fMeshBinSizeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fMeshRegionsCmd = new G4UIcmdWithAString("/B1/run/meshRegions",this);
+  fMeshRegionsCmd->SetGuidance("Regions scored in the mesh. Default \"Radiator Chamber\".");
+  fMeshRegionsCmd->SetParameterName("regions",false);
+  fMeshRegionsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fTargetPrecisionCmd = new G4UIcmdWithADouble("/B1/run/targetPrecision",this);
+  fTargetPrecisionCmd->SetGuidance("Stop the run once the relative uncertainty of the transmission ratio");
+  fTargetPrecisionCmd->SetGuidance("(see /B1/run/ratioPlanes) is below rel, e.g. 0.01; 0 runs all events.");
+  fTargetPrecisionCmd->SetGuidance("Checked every /B1/run/checkInterval events of each thread.");
+  fTargetPrecisionCmd->SetParameterName("rel",false);
+  fTargetPrecisionCmd->SetRange("rel>=0.");
+  fTargetPrecisionCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fCheckIntervalCmd = new G4UIcmdWithAnInteger("/B1/run/checkInterval",this);
+  fCheckIntervalCmd->SetGuidance("Events of a thread between two precision checks. Default 1000.");
+  fCheckIntervalCmd->SetParameterName("nevents",false);
+  fCheckIntervalCmd->SetRange("nevents>0");
+  fCheckIntervalCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fRatioPlanesCmd = new G4UIcmdWithAString("/B1/run/ratioPlanes",this);
+  fRatioPlanesCmd->SetGuidance("Planes of the transmission ratio num/den of forward crossings (forw0).");
+  fRatioPlanesCmd->SetGuidance("Default \"2 1\".");
+  fRatioPlanesCmd->SetParameterName("planes",false);
+  fRatioPlanesCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fProgressIntervalCmd = new G4UIcmdWithADoubleAndUnit("/B1/run/progressInterval",this);
+  fProgressIntervalCmd->SetGuidance("Wall-clock time between two progress reports (events/s, ETA and");
+  fProgressIntervalCmd->SetGuidance("imbalance between the threads). Default 10 s, 0 for none.");
+  fProgressIntervalCmd->SetParameterName("t",false);
+  fProgressIntervalCmd->SetRange("t>=0.");
+  fProgressIntervalCmd->SetUnitCategory("Time");
+  fProgressIntervalCmd->SetDefaultUnit("s");
+  fProgressIntervalCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fProgressIntervalCmd->SetToBeBroadcasted(false);
+
+  fProfileEventsCmd = new G4UIcmdWithABool("/B1/run/profileEvents",this);
+  fProfileEventsCmd->SetGuidance("Time every event (wall and CPU) and count its steps and tracks into");
+  fProfileEventsCmd->SetGuidance("/timing/... histograms; print the slowest events at the end of the run");
+  fProfileEventsCmd->SetGuidance("with their event seeds and the ebl1 --replay command that re-simulates them.");
+  fProfileEventsCmd->SetParameterName("profile",true);
+  fProfileEventsCmd->SetDefaultValue(true);
+  fProfileEventsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fSlowEventsCmd = new G4UIcmdWithAnInteger("/B1/run/slowEvents",this);
+  fSlowEventsCmd->SetGuidance("Number of slowest events kept by /B1/run/profileEvents. Default 10.");
+  fSlowEventsCmd->SetParameterName("n",false);
+  fSlowEventsCmd->SetRange("n>=0");
+  fSlowEventsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fProfileStepsCmd = new G4UIcmdWithABool("/B1/run/profileSteps",this);
+  fProfileStepsCmd->SetGuidance("Attribute the steps and their time to (logical volume, particle, process)");
+  fProfileStepsCmd->SetGuidance("and print the most expensive at the end of the run; all of them are");
+  fProfileStepsCmd->SetGuidance("written to EBL_steps_<run>.csv.");
+  fProfileStepsCmd->SetParameterName("profile",true);
+  fProfileStepsCmd->SetDefaultValue(true);
+  fProfileStepsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+}
+//______________________________________________________________________________
+
+B1RunMessenger::~B1RunMessenger()
+{
+  delete fRunNumberCmd;
+  delete fSweepCmd;
+  delete fHistBenchCmd;
+  delete fWriteHitsCmd;
+  delete fHitBlockSizeCmd;
+  delete fScoreMeshCmd;
+  delete fMeshBinSizeCmd;
+  delete fMeshRegionsCmd;
+  delete fTargetPrecisionCmd;
+  delete fCheckIntervalCmd;
+  delete fRatioPlanesCmd;
+  delete fProgressIntervalCmd;
+  delete fProfileEventsCmd;
+  delete fSlowEventsCmd;
+  delete fProfileStepsCmd;
+  delete fRunDirectory;
+}
+//______________________________________________________________________________
+
+void B1RunMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
+{
+   if( command == fRunNumberCmd ) {
+      fRunAction->SetRunNumber( G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+   }
+
+   if( command == fSweepCmd ) {
+      B1ParameterSweep sweep(fRunAction->GetRunNumber());
+      sweep.Execute(newValue);
+   }
+
+   if( command == fHistBenchCmd ) {
+      B1HistogramStore::Benchmark( G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+   }
+
+   if( command == fWriteHitsCmd ) {
+      B1HitStream::SetEnabled( G4UIcmdWithABool::GetNewBoolValue(newValue));
+   }
+
+   if( command == fHitBlockSizeCmd ) {
+      B1HitStream::SetBlockSize( G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+   }
+
+   if( command == fScoreMeshCmd ) {
+      B1MeshScorer::SetEnabled( G4UIcmdWithABool::GetNewBoolValue(newValue));
+   }
+
+   if( command == fMeshBinSizeCmd ) {
+      B1MeshScorer::SetBinSize( G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+   }
+
+   if( command == fMeshRegionsCmd ) {
+      B1MeshScorer::SetRegions(newValue);
+   }
+
+   if( command == fTargetPrecisionCmd ) {
+      B1ConvergenceMonitor::SetTarget( G4UIcmdWithADouble::GetNewDoubleValue(newValue));
+   }
+
+   if( command == fCheckIntervalCmd ) {
+      B1ConvergenceMonitor::SetCheckInterval( G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+   }
+
+   if( command == fRatioPlanesCmd ) {
+      std::istringstream is(newValue);
+      G4int num, den;
+      if( is >> num >> den ) B1ConvergenceMonitor::SetRatioPlanes(num, den);
+   }
+
+   if( command == fProgressIntervalCmd ) {
+      B1ProgressReporter::SetInterval( G4UIcmdWithADoubleAndUnit::GetNewDoubleValue(newValue));
+   }
+
+   if( command == fProfileEventsCmd ) {
+      B1EventProfiler::SetEnabled( G4UIcmdWithABool::GetNewBoolValue(newValue));
+   }
+
+   if( command == fSlowEventsCmd ) {
+      B1EventProfiler::SetNumberOfSlowEvents( G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+   }
+
+   if( command == fProfileStepsCmd ) {
+      B1StepProfiler::SetEnabled( G4UIcmdWithABool::GetNewBoolValue(newValue));
+   }
+}
+//______________________________________________________________________________
+
@@ -0,0 +1,145 @@
+#include "B1SolidBenchmark.hh"
+
+#include "G4VSolid.hh"
+#include "G4VisExtent.hh"
+#include "G4Timer.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <random>
+#include <vector>
+
+namespace {
+
+   struct Samples {
+      std::vector<G4ThreeVector> inside_p;
+      std::vector<G4ThreeVector> inside_v;
+      std::vector<G4ThreeVector> outside_p;
+      std::vector<G4ThreeVector> outside_v;
+      std::vector<G4ThreeVector> all_p;
+   };
+
+   G4ThreeVector RandomDirection(std::mt19937_64& gen)
+   {
+      std::uniform_real_distribution<double> flat(0.0, 1.0);
+      G4double cost = 2.0*flat(gen) - 1.0;
+      G4double sint = std::sqrt((1.0-cost)*(1.0+cost));
+      G4double phi  = twopi*flat(gen);
+      return G4ThreeVector(sint*std::cos(phi), sint*std::sin(phi), cost);
+   }
+
+   Samples Sample(const G4VSolid * solid, G4int n, G4long seed)
+   {
+      Samples s;
+      std::mt19937_64 gen(seed);
+      G4VisExtent ext = solid->GetExtent();
+      G4double mx = 0.05*(ext.GetXmax() - ext.GetXmin());
+      G4double my = 0.05*(ext.GetYmax() - ext.GetYmin());
+      G4double mz = 0.05*(ext.GetZmax() - ext.GetZmin());
+      std::uniform_real_distribution<double> fx(ext.GetXmin()-mx, ext.GetXmax()+mx);
+      std::uniform_real_distribution<double> fy(ext.GetYmin()-my, ext.GetYmax()+my);
+      std::uniform_real_distribution<double> fz(ext.GetZmin()-mz, ext.GetZmax()+mz);
+
+      for(int i = 0; i < n; i++) {
+         G4ThreeVector p(fx(gen), fy(gen), fz(gen));
+         G4ThreeVector v = RandomDirection(gen);
+         s.all_p.push_back(p);
+         EInside in = solid->Inside(p);
+         if( in == kInside ) {
+            s.inside_p.push_back(p);
+            s.inside_v.push_back(v);
+         } else if( in == kOutside ) {
+            s.outside_p.push_back(p);
+            s.outside_v.push_back(v);
+         }
+      }
+      return s;
+   }
+
+   G4double Rate(std::size_t n, const G4Timer& timer)
+   {
+      G4double t = timer.GetRealElapsed();
+      return (t > 0.0) ? n/t : 0.0;
+   }
+}
+//______________________________________________________________________________
+
+B1SolidBenchmark::B1SolidBenchmark(G4int npoints, G4long seed) :
+   fNPoints(npoints), fSeed(seed)
+{ }
+//______________________________________________________________________________
+
+B1SolidBenchmark::~B1SolidBenchmark()
+{ }
+//______________________________________________________________________________
+
+B1SolidBenchmark::Rates B1SolidBenchmark::Benchmark(const G4VSolid * solid) const
+{
+   Rates   rates = {0.0, 0.0, 0.0};
+   Samples s     = Sample(solid, fNPoints, fSeed);
+   G4Timer timer;
+
+   // The sums keep the compiler from dropping the calls.
+   G4double sum = 0.0;
+
+   timer.Start();
+   for(const auto& p : s.all_p) {
+      sum += solid->Inside(p);
+   }
+   timer.Stop();
+   rates.inside = Rate(s.all_p.size(), timer);
+
+   timer.Start();
+   for(std::size_t i = 0; i < s.outside_p.size(); i++) {
+      G4double d = solid->DistanceToIn(s.outside_p[i], s.outside_v[i]);
+      if( d < kInfinity ) sum += d;
+   }
+   timer.Stop();
+   rates.distToIn = Rate(s.outside_p.size(), timer);
+
+   timer.Start();
+   for(std::size_t i = 0; i < s.inside_p.size(); i++) {
+      sum += solid->DistanceToOut(s.inside_p[i], s.inside_v[i]);
+   }
+   timer.Stop();
+   rates.distToOut = Rate(s.inside_p.size(), timer);
+
+   if( sum == -1.0 ) G4cout << sum << G4endl;
+   return rates;
+}
+//______________________________________________________________________________
+
+B1SolidBenchmark::Comparison B1SolidBenchmark::Compare(const G4VSolid * ref, const G4VSolid * test,
+                                                       const G4ThreeVector& offset, G4double tolerance) const
+{
+   Comparison c = {0, 0, 0, 0.0};
+   Samples    s = Sample(ref, fNPoints, fSeed);
+
+   c.nPoints = s.all_p.size();
+   for(const auto& p : s.all_p) {
+      EInside a = ref->Inside(p);
+      EInside b = test->Inside(p - offset);
+      // Points within tolerance of a surface may legitimately differ.
+      if( a != b && a != kSurface && b != kSurface ) c.nInsideMismatch++;
+   }
+
+   for(std::size_t i = 0; i < s.outside_p.size(); i++) {
+      G4double a = ref->DistanceToIn(s.outside_p[i], s.outside_v[i]);
+      G4double b = test->DistanceToIn(s.outside_p[i] - offset, s.outside_v[i]);
+      if( a == kInfinity && b == kInfinity ) continue;
+      G4double diff = std::fabs(a - b);
+      if( diff > c.maxDistDiff ) c.maxDistDiff = diff;
+      if( diff > tolerance ) c.nDistMismatch++;
+   }
+
+   for(std::size_t i = 0; i < s.inside_p.size(); i++) {
+      G4double a = ref->DistanceToOut(s.inside_p[i], s.inside_v[i]);
+      G4double b = test->DistanceToOut(s.inside_p[i] - offset, s.inside_v[i]);
+      G4double diff = std::fabs(a - b);
+      if( diff > c.maxDistDiff ) c.maxDistDiff = diff;
+      if( diff > tolerance ) c.nDistMismatch++;
+   }
+   return c;
+}
+//______________________________________________________________________________
+
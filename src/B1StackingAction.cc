@@ -0,0 +1,185 @@
+#include "B1StackingAction.hh"
+#include "B1Run.hh"
+
+#include "G4Track.hh"
+#include "G4RunManager.hh"
+#include "G4ParticleTable.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Region.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4Navigator.hh"
+#include "G4TransportationManager.hh"
+#include "G4AutoLock.hh"
+#include <iomanip>
+
+namespace {
+   G4Mutex stackingMutex = G4MUTEX_INITIALIZER;
+
+   const char * kClassNames[] = { "kill", "urgent", "waiting", "postpone" };
+   const G4ClassificationOfNewTrack kClassification[] = { fKill, fUrgent, fWaiting, fPostpone };
+}
+
+std::vector<B1StackingAction::Rule>  B1StackingAction::fgRules;
+std::atomic<G4int>                   B1StackingAction::fgVersion(0);
+std::atomic<G4long>                  B1StackingAction::fgOpticalBudget(-1);
+
+//______________________________________________________________________________
+
+B1StackingAction::B1StackingAction() : G4UserStackingAction(),
+   fVersion(-1), fVolumeRules(false), fOpticalPhoton(0), fOpticalBudget(-1), fOpticalPhotons(0),
+   fRun(0), fNavigator(0)
+{ }
+//______________________________________________________________________________
+
+B1StackingAction::~B1StackingAction()
+{
+   delete fNavigator;
+}
+//______________________________________________________________________________
+
+G4bool B1StackingAction::AddRule(const G4String& particle, const G4String& volume, const G4String& cls)
+{
+   for(G4int i = 0; i < 4; i++) {
+      if( cls != kClassNames[i] ) continue;
+      Rule r;
+      r.particle = particle;
+      r.volume   = volume;
+      r.cls      = i;
+      G4AutoLock lock(&stackingMutex);
+      fgRules.push_back(r);
+      fgVersion++;
+      return true;
+   }
+   return false;
+}
+//______________________________________________________________________________
+
+void B1StackingAction::ClearRules()
+{
+   G4AutoLock lock(&stackingMutex);
+   fgRules.clear();
+   fgVersion++;
+}
+//______________________________________________________________________________
+
+void B1StackingAction::PrintRules()
+{
+   G4AutoLock lock(&stackingMutex);
+   for(const auto& r : fgRules) {
+      G4cout << std::setw(24) << r.particle << std::setw(24) << r.volume
+         << " : " << kClassNames[r.cls] << G4endl;
+   }
+   G4long budget = fgOpticalBudget;
+   G4cout << std::setw(24) << "optical photon budget" << " : ";
+   if( budget < 0 ) G4cout << "none" << G4endl;
+   else             G4cout << budget << " per event" << G4endl;
+}
+//______________________________________________________________________________
+
+void B1StackingAction::Resolve()
+{
+   std::vector<Rule> rules;
+   {
+      G4AutoLock lock(&stackingMutex);
+      rules    = fgRules;
+      fVersion = fgVersion;
+   }
+
+   fRules.clear();
+   fVolumeRules = false;
+   for(const auto& r : rules) {
+      Resolved x;
+      x.particle = 0;
+      x.volume   = 0;
+      x.cls      = kClassification[r.cls];
+      if( r.particle != "all" ) {
+         x.particle = G4ParticleTable::GetParticleTable()->FindParticle(r.particle);
+         if( !x.particle ) {
+            G4ExceptionDescription msg;
+            msg << "no particle " << r.particle << ", the stacking rule is ignored";
+            G4Exception("B1StackingAction::Resolve()", "B1Stack0001", JustWarning, msg);
+            continue;
+         }
+      }
+      if( r.volume != "all" ) {
+         x.volume = G4LogicalVolumeStore::GetInstance()->GetVolume(r.volume, false);
+         if( !x.volume ) {
+            G4ExceptionDescription msg;
+            msg << "no logical volume " << r.volume << ", the stacking rule is ignored";
+            G4Exception("B1StackingAction::Resolve()", "B1Stack0001", JustWarning, msg);
+            continue;
+         }
+         fVolumeRules = true;
+      }
+      fRules.push_back(x);
+   }
+}
+//______________________________________________________________________________
+
+void B1StackingAction::PrepareNewEvent()
+{
+   if( fVersion != fgVersion ) Resolve();
+   if( !fOpticalPhoton ) fOpticalPhoton = G4OpticalPhoton::Definition();
+   fOpticalBudget  = fgOpticalBudget;
+   fOpticalPhotons = 0;
+   fRun = static_cast<B1Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+}
+//______________________________________________________________________________
+
+const G4LogicalVolume * B1StackingAction::OriginVolume(const G4Track* track)
+{
+   // the scintillation and Cerenkov photons carry the touchable of their
+   // step; otherwise locate the vertex with a navigator of our own, so the
+   // tracking navigator is left alone
+   const G4VPhysicalVolume * pv = track->GetVolume();
+   if( !pv ) {
+      if( !fNavigator ) {
+         fNavigator = new G4Navigator();
+         fNavigator->SetWorldVolume(G4TransportationManager::GetTransportationManager()
+                                    ->GetNavigatorForTracking()->GetWorldVolume());
+      }
+      pv = fNavigator->LocateGlobalPointAndSetup(track->GetPosition(), 0, false, true);
+   }
+   return pv ? pv->GetLogicalVolume() : 0;
+}
+//______________________________________________________________________________
+
+G4ClassificationOfNewTrack B1StackingAction::ClassifyNewTrack(const G4Track* track)
+{
+   // tracks postponed from the previous event come back with parent id -1:
+   // they were classified and counted then
+   if( track->GetParentID() < 0 ) return fUrgent;
+
+   const G4ParticleDefinition * particle = track->GetDefinition();
+
+   // secondaries per region of their vertex
+   const G4LogicalVolume * volume = 0;
+   if( track->GetParentID() > 0 ) {
+      volume = OriginVolume(track);
+      if( volume && fRun ) fRun->AddSecondaries(volume->GetRegion(), 1);
+   }
+
+   G4ClassificationOfNewTrack cls = fUrgent;
+   if( !fRules.empty() ) {
+      if( fVolumeRules && !volume ) volume = OriginVolume(track);
+      for(const auto& r : fRules) {
+         if( r.particle && r.particle != particle ) continue;
+         if( r.volume && r.volume != volume ) continue;
+         cls = r.cls;
+      }
+   }
+
+   // the budget is on the photons that would be tracked in this event
+   if( particle == fOpticalPhoton && fOpticalBudget >= 0 && (cls == fUrgent || cls == fWaiting) ) {
+      G4bool dropped = (fOpticalPhotons >= fOpticalBudget);
+      fOpticalPhotons++;
+      if( fRun ) fRun->AddOpticalPhoton(dropped, fOpticalPhotons == fOpticalBudget + 1);
+      if( dropped ) cls = fKill;
+   }
+   return cls;
+}
+//______________________________________________________________________________
+
@@ -0,0 +1,89 @@
+#include "B1StackingMessenger.hh"
+#include "B1StackingAction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+//______________________________________________________________________________
+
+B1StackingMessenger::B1StackingMessenger() :
+   G4UImessenger()
+{
+  fStackDirectory = new G4UIdirectory("/B1/stack/");
+  fStackDirectory->SetGuidance("Classification of the new tracks");
+
+  fSetClassCmd = new G4UIcommand("/B1/stack/setClass",this);
+  fSetClassCmd->SetGuidance("Class of the new tracks of a particle created in a logical volume:");
+  fSetClassCmd->SetGuidance("kill, urgent, waiting (after the urgent stack) or postpone (next event).");
+  fSetClassCmd->SetGuidance("'all' matches any particle or volume; the last matching rule wins.");
+  G4UIparameter* particle = new G4UIparameter("particle",'s',false);
+  fSetClassCmd->SetParameter(particle);
+  G4UIparameter* volume = new G4UIparameter("volume",'s',false);
+  fSetClassCmd->SetParameter(volume);
+  G4UIparameter* cls = new G4UIparameter("class",'s',false);
+  cls->SetParameterCandidates("kill urgent waiting postpone");
+  fSetClassCmd->SetParameter(cls);
+  fSetClassCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fSetClassCmd->SetToBeBroadcasted(false);
+
+  fClearClassesCmd = new G4UIcmdWithoutParameter("/B1/stack/clearClasses",this);
+  fClearClassesCmd->SetGuidance("Remove all the rules of /B1/stack/setClass.");
+  fClearClassesCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fClearClassesCmd->SetToBeBroadcasted(false);
+
+  fOpticalBudgetCmd = new G4UIcmdWithAnInteger("/B1/stack/opticalPhotonBudget",this);
+  fOpticalBudgetCmd->SetGuidance("Optical photons tracked per event; the rest are killed when they are");
+  fOpticalBudgetCmd->SetGuidance("stacked and counted in the run summary. -1 (default) for no budget.");
+  fOpticalBudgetCmd->SetParameterName("n",false);
+  fOpticalBudgetCmd->SetRange("n>=-1");
+  fOpticalBudgetCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fOpticalBudgetCmd->SetToBeBroadcasted(false);
+
+  fPrintCmd = new G4UIcmdWithoutParameter("/B1/stack/print",this);
+  fPrintCmd->SetGuidance("Print the stacking rules and the optical photon budget.");
+  fPrintCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fPrintCmd->SetToBeBroadcasted(false);
+}
+//______________________________________________________________________________
+
+B1StackingMessenger::~B1StackingMessenger()
+{
+  delete fSetClassCmd;
+  delete fClearClassesCmd;
+  delete fOpticalBudgetCmd;
+  delete fPrintCmd;
+  delete fStackDirectory;
+}
+//______________________________________________________________________________
+
+void B1StackingMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
+{
+   if( command == fSetClassCmd ) {
+      std::istringstream is(newValue);
+      G4String particle, volume, cls;
+      is >> particle >> volume >> cls;
+      if( !B1StackingAction::AddRule(particle, volume, cls) ) {
+         G4ExceptionDescription msg;
+         msg << "unknown class " << cls << " (kill, urgent, waiting or postpone)";
+         G4Exception("B1StackingMessenger::SetNewValue()", "B1Stack0002", JustWarning, msg);
+      }
+   }
+
+   if( command == fClearClassesCmd ) {
+      B1StackingAction::ClearRules();
+   }
+
+   if( command == fOpticalBudgetCmd ) {
+      B1StackingAction::SetOpticalPhotonBudget( G4UIcmdWithAnInteger::GetNewIntValue(newValue));
+   }
+
+   if( command == fPrintCmd ) {
+      B1StackingAction::PrintRules();
+   }
+}
+//______________________________________________________________________________
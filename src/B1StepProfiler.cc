@@ -0,0 +1,132 @@
+#include "B1StepProfiler.hh"
+
+#include "G4Threading.hh"
+#include "G4AutoLock.hh"
+
+#include <algorithm>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+namespace {
+   G4Mutex stepProfilerMutex = G4MUTEX_INITIALIZER;
+
+   // rows of the printed table, the dump has them all
+   const std::size_t kPrintRows = 30;
+}
+
+G4bool                               B1StepProfiler::fgEnabled  = false;
+std::map<B1StepProfiler::Names, B1StepProfiler::Total> B1StepProfiler::fgTotals;
+G4ThreadLocal B1StepProfiler       * B1StepProfiler::fgInstance = 0;
+
+//______________________________________________________________________________
+
+B1StepProfiler * B1StepProfiler::Instance()
+{
+   if( !fgInstance ) fgInstance = new B1StepProfiler();
+   return fgInstance;
+}
+//______________________________________________________________________________
+
+B1StepProfiler::B1StepProfiler() :
+   fLast(0), fTicks0(0), fSeconds0(0.0)
+{ }
+//______________________________________________________________________________
+
+G4double B1StepProfiler::Seconds()
+{
+   std::chrono::duration<double> t = std::chrono::steady_clock::now().time_since_epoch();
+   return t.count();
+}
+//______________________________________________________________________________
+
+void B1StepProfiler::BeginOfRun()
+{
+   fCells.clear();
+   fCells.reserve(1024);
+   if( G4Threading::IsMasterThread() ) {
+      G4AutoLock lock(&stepProfilerMutex);
+      fgTotals.clear();
+   }
+   fSeconds0 = Seconds();
+   fTicks0   = Ticks();
+   fLast     = fTicks0;
+}
+//______________________________________________________________________________
+
+void B1StepProfiler::EndOfRun()
+{
+   if( fCells.empty() ) return;
+
+   // this thread's ticks per second over the run
+   G4double      dt     = Seconds() - fSeconds0;
+   std::uint64_t dticks = Ticks() - fTicks0;
+   G4double      scale  = (dticks > 0) ? dt/dticks : 0.0;
+
+   G4AutoLock lock(&stepProfilerMutex);
+   for(const auto& cell : fCells) {
+      const Key& k = cell.first;
+      Names names(k.volume->GetName(), k.particle->GetParticleName(),
+                  k.process ? std::string(k.process->GetProcessName()) : std::string("none"));
+      Total& t = fgTotals[names];
+      t.steps   += cell.second.steps;
+      t.seconds += scale*cell.second.ticks;
+   }
+   fCells.clear();
+}
+//______________________________________________________________________________
+
+void B1StepProfiler::Print(G4int runNumber)
+{
+   G4AutoLock lock(&stepProfilerMutex);
+   if( fgTotals.empty() ) return;
+
+   typedef std::map<Names, Total>::const_iterator Row;
+   std::vector<Row> rows;
+   G4long   steps   = 0;
+   G4double seconds = 0.0;
+   for(Row r = fgTotals.begin(); r != fgTotals.end(); ++r) {
+      rows.push_back(r);
+      steps   += r->second.steps;
+      seconds += r->second.seconds;
+   }
+   std::sort(rows.begin(), rows.end(),
+             [](const Row& a, const Row& b) { return a->second.seconds > b->second.seconds; });
+
+   G4cout << std::setw(24) << "volume" << std::setw(16) << "particle" << std::setw(20) << "process"
+      << std::setw(14) << "steps" << std::setw(12) << "time (s)" << std::setw(10) << "time %"
+      << std::setw(12) << "ns/step" << G4endl;
+   for(std::size_t i = 0; i < rows.size() && i < kPrintRows; i++) {
+      const Names& n = rows[i]->first;
+      const Total& t = rows[i]->second;
+      G4cout << std::setw(24) << std::get<0>(n) << std::setw(16) << std::get<1>(n)
+         << std::setw(20) << std::get<2>(n)
+         << std::setw(14) << t.steps << std::setw(12) << t.seconds
+         << std::setw(10) << ((seconds > 0.0) ? 100.0*t.seconds/seconds : 0.0)
+         << std::setw(12) << 1.0e9*t.seconds/t.steps << G4endl;
+   }
+   G4cout << std::setw(60) << "all" << std::setw(14) << steps << std::setw(12) << seconds
+      << std::setw(10) << 100.0
+      << std::setw(12) << ((steps > 0) ? 1.0e9*seconds/steps : 0.0) << G4endl;
+   if( rows.size() > kPrintRows ) {
+      G4cout << " " << rows.size() - kPrintRows << " more entries in the dump" << G4endl;
+   }
+
+   std::ostringstream name;
+   name << "EBL_steps_" << runNumber << ".csv";
+   std::ofstream out(name.str().c_str());
+   out << "volume,particle,process,steps,seconds\n";
+   out << std::setprecision(9);
+   for(const Row& r : rows) {
+      out << std::get<0>(r->first) << "," << std::get<1>(r->first) << "," << std::get<2>(r->first)
+         << "," << r->second.steps << "," << r->second.seconds << "\n";
+   }
+   if( !out ) {
+      G4ExceptionDescription msg;
+      msg << "cannot write " << name.str();
+      G4Exception("B1StepProfiler::Print()", "B1Prof0002", JustWarning, msg);
+   }
+}
+//______________________________________________________________________________
+
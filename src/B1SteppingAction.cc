@@ -1,44 +1,136 @@
 #include "B1SteppingAction.hh"
 #include "B1EventAction.hh"
 #include "B1DetectorConstruction.hh"
+#include "B1PlaneCrossingScorer.hh"
+#include "B1MeshScorer.hh"
+#include "B1EventProfiler.hh"
+#include "B1StepProfiler.hh"
 
 #include "G4Step.hh"
 #include "G4Event.hh"
 #include "G4RunManager.hh"
 #include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4ParticleDefinition.hh"
+#include <map>
+#include <algorithm>
 
+namespace {
+
+  /// Energy deposited in the scoring volume, summed by the event action
+  class ScoringVolumePlugin : public B1SteppingPlugin
+  {
+    public:
+      ScoringVolumePlugin(B1EventAction* eventAction) : fEventAction(eventAction) { }
+
+      virtual G4bool Select(std::vector<const G4LogicalVolume*>& volumes,
+                            std::vector<const G4ParticleDefinition*>&)
+      {
+        const B1DetectorConstruction* detectorConstruction
+          = static_cast<const B1DetectorConstruction*>
+            (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+        G4LogicalVolume* volume = detectorConstruction ? detectorConstruction->GetScoringVolume() : 0;
+        if (!volume) return false;
+        volumes.push_back(volume);
+        return true;
+      }
+
+      virtual void Step(const G4Step* step)
+      {
+        fEventAction->AddEdep(step->GetTotalEnergyDeposit());
+      }
+
+    private:
+      B1EventAction* fEventAction;
+  };
+}
+
+//___________________________________________________________________
 
 B1SteppingAction::B1SteppingAction(B1EventAction* eventAction) : G4UserSteppingAction(),
-  fEventAction(eventAction), fScoringVolume(0)
-{}
+  fEventAction(eventAction)
+{
+  Register(new ScoringVolumePlugin(eventAction), true);
+}
 //___________________________________________________________________
 
 B1SteppingAction::~B1SteppingAction()
-{ }
+{
+  for (auto d : fDispatches) delete d;
+  for (auto p : fOwned) delete p;
+}
 //___________________________________________________________________
 
-void B1SteppingAction::UserSteppingAction(const G4Step* step)
+void B1SteppingAction::Register(B1SteppingPlugin* plugin, G4bool owned)
 {
-  if (!fScoringVolume) { 
-    const B1DetectorConstruction* detectorConstruction
-      = static_cast<const B1DetectorConstruction*>
-        (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
-    fScoringVolume = detectorConstruction->GetScoringVolume();   
-  }
-
-  // get volume of the current step
-  G4LogicalVolume* volume 
-    = step->GetPreStepPoint()->GetTouchableHandle()
-      ->GetVolume()->GetLogicalVolume();
-      
-  // check if we are in scoring volume
-  if (volume != fScoringVolume) return;
-
-  // collect energy deposited in this step
-  G4double edepStep = step->GetTotalEnergyDeposit();
-  fEventAction->AddEdep(edepStep);  
+  fPlugins.push_back(plugin);
+  if (owned) fOwned.push_back(plugin);
 }
 //___________________________________________________________________
 
+void B1SteppingAction::BeginOfRun()
+{
+  for (auto d : fDispatches) delete d;
+  fDispatches.clear();
+  fTable.clear();
+
+  // The scorers of the application come first (the step timing first, then
+  // the steps and tracks of the event) and are only instantiated once they
+  // are switched on
+  std::vector<B1SteppingPlugin*> plugins;
+  if (B1StepProfiler::IsEnabled())        plugins.push_back(B1StepProfiler::Instance());
+  if (B1EventProfiler::IsEnabled())       plugins.push_back(B1EventProfiler::Instance());
+  if (B1PlaneCrossingScorer::IsEnabled()) plugins.push_back(B1PlaneCrossingScorer::Instance());
+  if (B1MeshScorer::IsEnabled())          plugins.push_back(B1MeshScorer::Instance());
+  plugins.insert(plugins.end(), fPlugins.begin(), fPlugins.end());
+  fParticles.assign(plugins.size(), std::vector<char>());
+
+  const G4LogicalVolumeStore* store = G4LogicalVolumeStore::GetInstance();
+  std::size_t nids = 0;
+  for (const G4LogicalVolume* lv : *store) nids = std::max(nids, std::size_t(lv->GetInstanceID()) + 1);
+
+  // the plugins of each volume, by index
+  std::vector< std::vector<std::size_t> > selected(nids);
+  std::vector<G4bool>                     allParticles(plugins.size(), true);
+  for (std::size_t i = 0; i < plugins.size(); i++) {
+    std::vector<const G4LogicalVolume*>      volumes;
+    std::vector<const G4ParticleDefinition*> particles;
+    if (!plugins[i]->Select(volumes, particles)) continue;
 
+    if (volumes.empty()) {
+      for (auto& s : selected) s.push_back(i);
+    } else {
+      for (const G4LogicalVolume* lv : volumes) {
+        std::size_t id = lv->GetInstanceID();
+        if (id < nids && (selected[id].empty() || selected[id].back() != i)) selected[id].push_back(i);
+      }
+    }
 
+    allParticles[i] = particles.empty();
+    for (const G4ParticleDefinition* p : particles) {
+      std::size_t pid = p->GetParticleDefinitionID();
+      if (pid >= fParticles[i].size()) fParticles[i].resize(pid + 1, 0);
+      fParticles[i][pid] = 1;
+    }
+  }
+
+  // one dispatch list per distinct set of plugins
+  std::map< std::vector<std::size_t>, Dispatch* > lists;
+  fTable.assign(nids, 0);
+  for (std::size_t id = 0; id < nids; id++) {
+    if (selected[id].empty()) continue;
+    Dispatch*& d = lists[selected[id]];
+    if (!d) {
+      d = new Dispatch();
+      for (std::size_t i : selected[id]) {
+        Entry e;
+        e.plugin    = plugins[i];
+        e.particles = allParticles[i] ? 0 : &fParticles[i];
+        d->push_back(e);
+      }
+      fDispatches.push_back(d);
+    }
+    fTable[id] = d;
+  }
+}
+//___________________________________________________________________
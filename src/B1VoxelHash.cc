@@ -0,0 +1,56 @@
+#include "B1VoxelHash.hh"
+
+#include <algorithm>
+
+const std::uint64_t B1VoxelHash::kEmpty;
+
+//______________________________________________________________________________
+
+B1VoxelHash::B1VoxelHash(std::size_t capacity) :
+   fSize(0)
+{
+   std::size_t n = 16;
+   while( n < capacity ) n <<= 1;
+   Entry empty = { kEmpty, 0.0, 0.0 };
+   fEntries.assign(n, empty);
+   fMask = n - 1;
+}
+//______________________________________________________________________________
+
+void B1VoxelHash::Grow()
+{
+   std::vector<Entry> old;
+   old.swap(fEntries);
+
+   Entry empty = { kEmpty, 0.0, 0.0 };
+   fEntries.assign(2*old.size(), empty);
+   fMask = fEntries.size() - 1;
+   fSize = 0;
+   for(const Entry& e : old) {
+      if( e.key == kEmpty ) continue;
+      Entry& n = Get(e.key);
+      n.edep   = e.edep;
+      n.length = e.length;
+   }
+}
+//______________________________________________________________________________
+
+void B1VoxelHash::Merge(const B1VoxelHash& other)
+{
+   for(const Entry& e : other.fEntries) {
+      if( e.key == kEmpty ) continue;
+      Entry& n = Get(e.key);
+      n.edep   += e.edep;
+      n.length += e.length;
+   }
+}
+//______________________________________________________________________________
+
+void B1VoxelHash::Clear()
+{
+   Entry empty = { kEmpty, 0.0, 0.0 };
+   std::fill(fEntries.begin(), fEntries.end(), empty);
+   fSize = 0;
+}
+//______________________________________________________________________________
+
@@ -0,0 +1,38 @@
+#include "B1WireParameterisation.hh"
+
+#include "G4VPhysicalVolume.hh"
+#include "G4Box.hh"
+#include "G4SystemOfUnits.hh"
+
+B1WireParameterisation::B1WireParameterisation(G4int nwires, G4double spacing, G4double angle,
+                                               G4double length0, G4double y0, G4double z) :
+   G4VPVParameterisation(),
+   fNWires(nwires), fSpacing(spacing), fAngle(angle), fLength0(length0), fY0(y0), fZ(z),
+   fInvSinAngle(1.0/std::sin(angle)),
+   fRotation(new G4RotationMatrix())
+{
+   fRotation->rotateY(90.0*degree);
+}
+//______________________________________________________________________________
+
+B1WireParameterisation::~B1WireParameterisation()
+{
+   delete fRotation;
+}
+//______________________________________________________________________________
+
+void B1WireParameterisation::ComputeTransformation(const G4int copyNo, G4VPhysicalVolume* physVol) const
+{
+   physVol->SetTranslation( G4ThreeVector(0.0, GetWireY(copyNo), fZ) );
+   physVol->SetRotation( fRotation );
+}
+//______________________________________________________________________________
+
+void B1WireParameterisation::ComputeDimensions(G4Box& wire, const G4int copyNo, const G4VPhysicalVolume*) const
+{
+   wire.SetXHalfLength( GetWireHalfWidth() );
+   wire.SetYHalfLength( GetWireHalfWidth() );
+   wire.SetZHalfLength( GetWireLength(copyNo)/2.0 );
+}
+//______________________________________________________________________________
+